@@ -1,86 +1,128 @@
 #include "alertManager.h"
 #include "hardware.h"
 #include "telegramHandler.h"
+#include "profiler.h"
 
+static void notifyFood(float value, bool critical) { TelegramHandler::sendFoodAlert((int)value, critical); }
+static void notifyWater(float value, bool critical) { TelegramHandler::sendWaterAlert((int)value, critical); }
+static void notifyBattery(float value, bool critical) { TelegramHandler::sendBatteryAlert(value, critical); }
 
-AlertState AlertManager::state;
-unsigned long AlertManager::alertCooldown = ALERT_COOLDOWN_MINUTES * 60000;
+// Alert baru = satu baris di sini (urutan = AlertChannel)
+const AlertRule AlertManager::rules[ALERT_CHANNEL_COUNT] = {
+  // warning, critical, hysteresis, confirm, cooldown, remind, notify
+  {FOOD_WARNING_THRESHOLD, FOOD_CRITICAL_THRESHOLD, FOOD_ALERT_HYSTERESIS,
+   ULTRASONIC_ALERT_CONFIRM, FOOD_ALERT_COOLDOWN, FOOD_ALERT_REMIND, notifyFood},
+  {WATER_WARNING_THRESHOLD, WATER_CRITICAL_THRESHOLD, WATER_ALERT_HYSTERESIS,
+   ULTRASONIC_ALERT_CONFIRM, WATER_ALERT_COOLDOWN, WATER_ALERT_REMIND, notifyWater},
+  {LOW_BATTERY_THRESHOLD, CRITICAL_BATTERY_THRESHOLD, BATTERY_ALERT_HYSTERESIS,
+   BATTERY_ALERT_CONFIRM, BATTERY_ALERT_COOLDOWN, BATTERY_ALERT_REMIND, notifyBattery},
+};
 
+AlertChannelState AlertManager::channels[ALERT_CHANNEL_COUNT];
+unsigned long AlertManager::lastNotify[ALERT_CHANNEL_COUNT];
+bool AlertManager::hasNotified[ALERT_CHANNEL_COUNT];
+
+  // State tidak di-reset di sini: Hardware::init() sudah mengirim bacaan
+  // baterai pertama dan PowerManager::init() sudah memulihkan state dari RTC
 void AlertManager::init() {
   Serial.println("✅ Alert Manager initialized");
 }
 
-void AlertManager::checkAlerts() {
-  unsigned long now = millis();
-  
-  // Check cooldown
-  if (now - state.lastAlertTime < alertCooldown) {
-    return;
+void AlertManager::onSensorReading(AlertChannel channel, float value) {
+  PROFILE_SCOPE(PROFILE_ALERTS);
+  AlertChannelState& state = channels[channel];
+  if (value != state.lastValue || state.streak > 0) {
+    evaluate(channel, value);
+    state.lastValue = value;
   }
-  
-  checkFoodAlerts(Hardware::getFoodLevel());
-  checkWaterAlerts(Hardware::getWaterLevel());
-  checkBatteryAlerts(Hardware::getBatteryPercent());
+  notifyIfDue(channel, value);
+}
+
+uint8_t AlertManager::getSeverity(const AlertRule& rule, float value) {
+  if (value <= rule.critical) return ALERT_CRITICAL;
+  if (value <= rule.warning) return ALERT_WARNING;
+  return ALERT_NORMAL;
 }
 
-void AlertManager::checkFoodAlerts(int level) {
-  int status = checkLevelState(level, FOOD_WARNING_THRESHOLD, FOOD_CRITICAL_THRESHOLD);
+void AlertManager::evaluate(AlertChannel channel, float value) {
+  const AlertRule& rule = rules[channel];
+  AlertChannelState& state = channels[channel];
 
-  if (status == 2 && !state.foodCritical) {
-    TelegramHandler::sendFoodAlert(level, true);
-    state.foodCritical = true;
-    state.lastAlertTime = millis();
+  // hysteresis: level bertahan selama nilai masih di dalam band di atas ambangnya
+  uint8_t target = getSeverity(rule, value);
+  if (state.level >= ALERT_WARNING && value <= rule.warning + rule.hysteresis) {
+    target = max(target, (uint8_t)ALERT_WARNING);
+  }
+  if (state.level == ALERT_CRITICAL && value <= rule.critical + rule.hysteresis) {
+    target = ALERT_CRITICAL;
   }
-  else if (status == 1 && !state.foodWarning && !state.foodCritical) {
-    TelegramHandler::sendFoodAlert(level, false);
-    state.foodWarning = true;
-    state.lastAlertTime = millis();
+
+  // ganti level (naik maupun pulih) perlu confirmReadings bacaan berturut-turut
+  // ke arah yang sama; yang dipakai = level paling dekat dengan level sekarang
+  if (target != state.level) {
+    bool rising = target > state.level;
+    if (state.streak > 0 && (state.pending > state.level) != rising) state.streak = 0;
+    if (state.streak == 0) state.pending = target;
+    else state.pending = rising ? min(state.pending, target) : max(state.pending, target);
+    if (++state.streak < rule.confirmReadings) return;
+    target = state.pending;
   }
-  else if (status == 0 && level > FOOD_WARNING_THRESHOLD + 10) {
-    state.foodWarning = false;
-    state.foodCritical = false;
+  state.streak = 0;
+  state.pending = ALERT_NORMAL;
+
+  if (target != state.level) {
+    Serial.printf("🚨 Alert %d: level %d -> %d (%.1f)\n", channel, state.level, target, value);
   }
+  state.level = target;
+  if (target == ALERT_NORMAL) state.notified = ALERT_NORMAL;  // episode selesai
 }
 
-void AlertManager::checkWaterAlerts(int level) {
-  int status = checkLevelState(level, WATER_WARNING_THRESHOLD, WATER_CRITICAL_THRESHOLD);
+  // Kirim jika level belum pernah dikirim di episode ini. Cooldown hanya
+  // menahan alert yang levelnya tidak lebih tinggi dari alert terakhir,
+  // jadi eskalasi (dan channel lain) tidak pernah tertunda.
+void AlertManager::notifyIfDue(AlertChannel channel, float value) {
+  const AlertRule& rule = rules[channel];
+  AlertChannelState& state = channels[channel];
+  unsigned long since = millis() - lastNotify[channel];
 
-  if (status == 2 && !state.waterCritical) {
-    TelegramHandler::sendWaterAlert(level, true);
-    state.waterCritical = true;
-    state.lastAlertTime = millis();
-  }
-  else if (status == 1 && !state.waterWarning && !state.waterCritical) {
-    TelegramHandler::sendWaterAlert(level, false);
-    state.waterWarning = true;
-    state.lastAlertTime = millis();
-  }
-  else if (status == 0 && level > WATER_WARNING_THRESHOLD + 10) {
-    state.waterWarning = false;
-    state.waterCritical = false;
+  bool due = false;
+  if (state.level > state.notified) {
+    due = !hasNotified[channel] || state.level > state.lastSent ||
+          since >= rule.cooldownMinutes * 60000UL;
+  } else if (state.level == ALERT_CRITICAL && rule.remindMinutes > 0) {
+    due = since >= rule.remindMinutes * 60000UL;
   }
+  if (!due) return;
+
+  rule.notify(value, state.level == ALERT_CRITICAL);
+  state.notified = state.level;
+  state.lastSent = state.level;
+  lastNotify[channel] = millis();
+  hasNotified[channel] = true;
 }
 
-void AlertManager::checkBatteryAlerts(float percent) {
-  if (Hardware::isCriticalBattery() && !state.batteryCritical) {
-    TelegramHandler::sendBatteryAlert(percent, true);
-    state.batteryCritical = true;
-    state.batteryWarning = true; 
-    state.lastAlertTime = millis();
-  }
-  else if (Hardware::isLowBattery() && !state.batteryWarning && !state.batteryCritical) {
-    TelegramHandler::sendBatteryAlert(percent, false);
-    state.batteryWarning = true;
-    state.lastAlertTime = millis();
-  }
-  else if (percent > LOW_BATTERY_THRESHOLD + 5) {
-    state.batteryWarning = false;
-    state.batteryCritical = false;
-  }
+AlertLevel AlertManager::getLevel(AlertChannel channel) {
+  return (AlertLevel)channels[channel].level;
 }
 
-int AlertManager::checkLevelState(int level, int warning, int critical){
-  if (level <= critical) return 2;
-  if (level <= warning) return 1;
-  return 0;
+void AlertManager::getSleepState(AlertState& saved) {
+  for (int i = 0; i < ALERT_CHANNEL_COUNT; i++) {
+    saved.channels[i] = channels[i];
+    unsigned long since = millis() - lastNotify[i];
+    saved.sinceNotify[i] = hasNotified[i] ? min(since, ALERT_SINCE_LIMIT) : ALERT_NEVER;
+  }
 }
+
+  // lastNotify dihitung ulang terhadap millis() yang mulai dari 0 lagi;
+  // jarak dibatasi supaya selisih unsigned tetap benar
+void AlertManager::restoreSleepState(const AlertState& saved, unsigned long sleptMs) {
+  for (int i = 0; i < ALERT_CHANNEL_COUNT; i++) {
+    channels[i] = saved.channels[i];
+    hasNotified[i] = saved.sinceNotify[i] != ALERT_NEVER;
+    if (!hasNotified[i]) continue;
+    unsigned long since = saved.sinceNotify[i];
+    since = (since >= ALERT_SINCE_LIMIT || sleptMs >= ALERT_SINCE_LIMIT - since) ?
+            ALERT_SINCE_LIMIT : since + sleptMs;
+    lastNotify[i] = millis() - since;
+  }
+}
\ No newline at end of file
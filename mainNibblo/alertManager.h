@@ -7,28 +7,74 @@
 class Hardware;
 class TelegramHandler;
 
+enum AlertChannel {
+  ALERT_FOOD,
+  ALERT_WATER,
+  ALERT_BATTERY,
+  ALERT_CHANNEL_COUNT
+};
+
+enum AlertLevel {
+  ALERT_NORMAL,
+  ALERT_WARNING,
+  ALERT_CRITICAL
+};
+
+#define ALERT_NEVER 0xFFFFFFFFUL    // sinceNotify: channel belum pernah mengirim alert
+#define ALERT_SINCE_LIMIT 0x7FFFFFFFUL
+
+// Satu baris tabel AlertManager::rules: level = nilai <= ambang. Level turun hanya
+// setelah nilai naik melewati ambang + hysteresis. Cooldown menahan alert
+// ulang dengan level sama; eskalasi warning -> kritis tidak pernah ditahan.
+struct AlertRule {
+  float warning;
+  float critical;
+  float hysteresis;
+  uint8_t confirmReadings;    // bacaan berturut-turut sebelum level berubah
+  uint16_t cooldownMinutes;
+  uint16_t remindMinutes;     // ulangi alert kritis yang belum ditangani, 0 = tidak
+  void (*notify)(float value, bool critical);
+};
+
+struct AlertChannelState {
+  uint8_t level = ALERT_NORMAL;     // setelah hysteresis
+  uint8_t notified = ALERT_NORMAL;  // level tertinggi yang sudah dikirim di episode ini
+  uint8_t lastSent = ALERT_NORMAL;  // level alert terakhir (untuk cooldown)
+  uint8_t streak = 0;               // bacaan berturut-turut di level lain
+  uint8_t pending = ALERT_NORMAL;   // level yang sedang dikonfirmasi
+  uint8_t reserved[3] = {0, 0, 0};
+  float lastValue = -1;             // aturan dievaluasi hanya jika nilai berubah
+};
+
+// Dibawa lewat RTC memory saat deep sleep
 struct AlertState {
-  bool foodWarning = false;
-  bool foodCritical = false;
-  bool waterWarning = false;
-  bool waterCritical = false;
-  bool batteryWarning = false;
-  bool batteryCritical = false;
-  unsigned long lastAlertTime = 0;
+  AlertChannelState channels[ALERT_CHANNEL_COUNT];
+  uint32_t sinceNotify[ALERT_CHANNEL_COUNT];  // ms sejak alert terakhir
 };
 
+// Alert berbasis event: Hardware memanggil onSensorReading() setiap bacaan
+// yang diterima filter, aturan channel itu dievaluasi hanya jika nilainya
+// berubah. Tidak ada task polling; alert yang tertahan cooldown dikirim
+// pada bacaan pertama setelah cooldown habis.
 class AlertManager {
 private:
-  static AlertState state;
-  static unsigned long alertCooldown;
+  static const AlertRule rules[ALERT_CHANNEL_COUNT];
+  static AlertChannelState channels[ALERT_CHANNEL_COUNT];
+  static unsigned long lastNotify[ALERT_CHANNEL_COUNT];
+  static bool hasNotified[ALERT_CHANNEL_COUNT];
+
+  static uint8_t getSeverity(const AlertRule& rule, float value);
+  static void evaluate(AlertChannel channel, float value);
+  static void notifyIfDue(AlertChannel channel, float value);
 
 public:
   static void init();
-  static void checkAlerts();
-  static void checkFoodAlerts(int level);
-  static void checkWaterAlerts(int level);
-  static void checkBatteryAlerts(float percent);
-  static int checkLevelState(int level, int warning, int critical);
+  static void onSensorReading(AlertChannel channel, float value);
+  static AlertLevel getLevel(AlertChannel channel);
+
+  // deep sleep: level per channel & waktu sejak alert terakhir dibawa lewat RTC memory
+  static void getSleepState(AlertState& saved);
+  static void restoreSleepState(const AlertState& saved, unsigned long sleptMs);
 };
 
-#endif
+#endif
\ No newline at end of file
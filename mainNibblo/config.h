@@ -15,36 +15,189 @@ const int VOLT_READ_PIN = A0;
 
 // Schedule
 #define MAX_SCHEDULES 10
+#define FEED_CATCHUP_WINDOW 1800         //detik; jadwal terlewat masih dieksekusi dalam jendela ini
+#define MIN_VALID_EPOCH 1577836800UL     //2020-01-01, di bawah ini jam belum tersinkron NTP
+
+// Record store (LittleFS, append-only)
+#define STORE_FILE "/store.log"
+#define STORE_TEMP_FILE "/store.tmp"
+#define STORE_MAX_SIZE 8192              //compaction jika log melebihi ini
+#define STORE_MAX_PAYLOAD 128
+#define STORE_RECORD_MAGIC 0xA55A
+#define TOTALS_SAVE_DELAY 10000          //tunda simpan total feed (ms) supaya tulisan digabung
+#define HISTORY_SIZE 864                 //sampel riwayat: 3 hari x 288 (tiap 5 menit), 6 byte/sampel
+#define HISTORY_SUMMARY_WINDOW 86400UL   //jendela statistik /logs (detik)
 
 // NTP
 #define TIME_ZONE 8
 #define NTP_SERVER "pool.ntp.org"
-#define NTP_UPDATE_INTERVAL 60000
+#define NTP_PORT 123
+#define NTP_LOCAL_PORT 2390
+#define NTP_TIMEOUT 1000                 //tunggu balasan NTP (blocking)
+
+// Jam lokal: epoch dasar + millis(), dikoreksi drift kristal
+#define CLOCK_SYNC_MIN_INTERVAL 3600000UL   //1 jam
+#define CLOCK_SYNC_MAX_INTERVAL 86400000UL  //24 jam, interval digandakan selama jam akurat
+#define CLOCK_SYNC_TOLERANCE 250         //ms, error prediksi maksimum untuk memperpanjang interval
+#define CLOCK_DRIFT_MIN_SPAN 600000      //jarak sync minimum untuk mengukur drift (ms)
+#define CLOCK_DRIFT_ALPHA 0.5
+#define CLOCK_DRIFT_MAX_PPM 500         //kristal tidak sejauh ini; lebih = lompatan jam NTP, drift tidak diubah
+#define CLOCK_REBASE_INTERVAL 86400000UL //lipat offset millis() ke epoch dasar tiap hari
 
 // Timing & Interval
 #define TIME_UPDATE_INTERVAL 60000
 #define BOT_CHECK_INTERVAL 5000
 #define SENSOR_READ_INTERVAL 5000
 #define DISPLAY_UPDATE_INTERVAL 2000
-#define ALERT_CHECK_INTERVAL 30000
-#define DATA_LOG_INTERVAL 300000 
+#define DATA_LOG_INTERVAL 300000         //jarak sampel riwayat sensor
+#define FEED_CHECK_INTERVAL 1000         //jeda minimum cek jadwal (retry dalam menit jadwal)
+#define FEED_MAX_SLEEP 60000             //task feed bangun minimal tiap menit walau jadwal masih jauh
+#define POWER_CHECK_INTERVAL 5000
+#define DATA_LOG_CHECK_INTERVAL 10000
+#define HEALTH_CHECK_INTERVAL 60000
+#define DEBUG_INFO_INTERVAL 300000
+
+// Scheduler
+#define MAX_TASKS 12
+#define MAX_IDLE_SLEEP 1000   //batas tidur loop saat tidak ada task jatuh tempo
+
+// Telegram
+#define MESSAGE_BUFFER_SIZE 768   //kapasitas satu pesan keluar (stack)
+#define TELEGRAM_HOST "api.telegram.org"
+#define TELEGRAM_PORT 443
+#define TELEGRAM_STEP_INTERVAL 20       //jeda antar step request saat sedang berjalan
+#define TELEGRAM_STEP_BUDGET 15         //batas waktu kerja satu step (ms)
+#define TELEGRAM_CONNECT_TIMEOUT 5000
+#define TELEGRAM_RESPONSE_TIMEOUT 10000 //batas total satu request
+#define TELEGRAM_KEEPALIVE_TIMEOUT 50000 //koneksi idle lebih lama dianggap sudah ditutup server
+
+// Long polling: getUpdates ditahan server sampai ada pesan atau timeout habis.
+// 0 = short polling tiap BOT_CHECK_INTERVAL
+#define TELEGRAM_LONG_POLL 1
+#define TELEGRAM_LONG_POLL_TIMEOUT 25   //detik, harus < TELEGRAM_KEEPALIVE_TIMEOUT
+#define TELEGRAM_LONG_POLL_STEP 100     //jeda cek socket selama menunggu respons
+
+// Buffer TLS: FULL = 16 KB RX (default BearSSL), REDUCED = pakai MFLN jika server mendukung
+#define TLS_BUFFER_FULL 0
+#define TLS_BUFFER_REDUCED 1
+#define TELEGRAM_TLS_BUFFER_MODE TLS_BUFFER_REDUCED
+#define TELEGRAM_TLS_RX_BUFFER 1024
+#define TELEGRAM_TLS_TX_BUFFER 512
+#define TELEGRAM_REQUEST_BUFFER 256
+#define TELEGRAM_HEADER_LINE 128
+#define TELEGRAM_UPDATE_LIMIT 2         //update per getUpdates, dibatasi kapasitas outbox untuk balasan
+#define TELEGRAM_CHAT_ID_SIZE 24
+#define TELEGRAM_POST_BUFFER 1280       //JSON sendMessage (teks ter-escape + keyboard)
+
+// Streaming parser getUpdates
+#define UPDATE_TEXT_SIZE 256            //teks perintah lebih panjang dipotong
+#define UPDATE_PARSER_DEPTH 8           //level JSON yang dilacak key-nya
+#define UPDATE_KEY_SIZE 16
+#define UPDATE_LITERAL_SIZE 24
+
+#define COMMAND_INDEX_BITS 7            //2^7 slot hash untuk alias perintah
+
+// Upload dokumen (/export)
+#define TELEGRAM_UPLOAD_CHUNK 256       //potongan body yang diminta dari sumber tiap write
+#define TELEGRAM_UPLOAD_TIMEOUT 60000
+#define EXPORT_BOUNDARY "NibbloExportBoundary7d3f"
+#define EXPORT_PROLOGUE_SIZE 384        //header multipart sebelum isi file
+#define EXPORT_LINE_SIZE 64             //satu baris CSV
+#define LZSS_WINDOW_BITS 10             //window 1 KB (buffer kompresi 2x window)
+#define LZSS_LENGTH_BITS 6              //panjang match 3..66
+#define LZSS_MIN_MATCH 3
+
+// Antrian pesan keluar
+#define OUTBOX_CAPACITY 4
+#define OUTBOX_TEXT_SIZE MESSAGE_BUFFER_SIZE
+#define OUTBOX_COALESCE_WINDOW 1500     //pesan ke chat sama dalam window digabung
+#define OUTBOX_MAX_RETRIES 3
+#define OUTBOX_RETRY_DELAY 5000         //dikali jumlah retry
 
 // Hardware Config
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
+#define OLED_I2C_ADDRESS 0x3C
+#define OLED_I2C_CHUNK 32       //byte data per transaksi I2C (buffer Wire)
+#define DISPLAY_ROWS 4          //baris status, tiap baris 16 px (2 page)
+#define DISPLAY_LINE_CHARS 21   //128 px / 6 px per karakter
 #define MIN_DISTANCE 2
 #define MAX_FOOD_DISTANCE 13.6
 #define MAX_WATER_DISTANCE 6.3
 #define SERVO_FEED_ANGLE 0
 #define SERVO_CLOSE_ANGLE 180
+#define ULTRASONIC_TIMEOUT_US 30000   //timeout echo 30 ms (maks 5 meter)
+#define ULTRASONIC_POLL_INTERVAL 35   //jeda cek hasil ping, > timeout echo
+
+// Filter sensor (laju sampel = SENSOR_READ_INTERVAL)
+#define FILTER_MEDIAN_SIZE 5
+#define LEVEL_FILTER_ALPHA 0.3        //EMA makanan & air
+#define BATTERY_FILTER_ALPHA 0.2
+#define FOOD_OUTLIER_CM 3.0
+#define WATER_OUTLIER_CM 2.0
+#define BATTERY_OUTLIER_VOLT 0.5
+#define FILTER_MAX_REJECTS 3          //outlier berturut-turut = perubahan nyata
 
 // Konstan dan treshold power
 #define BATTERY_MIN_VOLT 6.0
 #define BATTERY_MAX_VOLT 8.4
-#define SLEEP_DURATION_SECONDS 300
+#define SLEEP_DURATION_SECONDS 300       //duty cycle: tidur maksimum (poll bot, log sensor, cek alert)
 #define LOW_BATTERY_THRESHOLD 15
 #define CRITICAL_BATTERY_THRESHOLD 10
 
+// Duty cycle deep sleep (GPIO16 harus tersambung ke RST); -DDUTY_CYCLE_ENABLED=0 = selalu bangun
+#ifndef DUTY_CYCLE_ENABLED
+#define DUTY_CYCLE_ENABLED 1
+#endif
+#define DUTY_MIN_AWAKE 15000             //bangun minimal (poll, sensor, alert) per siklus
+#define DUTY_IDLE_TIMEOUT 60000          //tetap bangun selama ini setelah perintah terakhir / cold boot
+#define DUTY_MIN_SLEEP 30                //detik; wake berikutnya lebih dekat = tidak tidur
+#define DUTY_WAKE_LEAD 20                //detik bangun lebih awal sebelum jadwal makan (boot + WiFi)
+#define DUTY_RESYNC_SLEEP 3600           //total detik tidur sebelum wajib NTP lagi (timer RTC kurang akurat)
+#define WIFI_CONNECT_ATTEMPTS 30         //x 1 detik, asosiasi penuh (scan + DHCP)
+#define WIFI_FAST_CONNECT_TIMEOUT 3000   //ms, bangun dari sleep dengan BSSID/channel/IP tersimpan
+#define WIFI_OFFLINE_ATTEMPTS 5          //x 1 detik, asosiasi penuh saat bangun sebelumnya juga tanpa WiFi
+#define RTC_STATE_OFFSET 32              //blok 4 byte; 128 byte pertama RTC user memory dipakai eboot (OTA)
+#define RTC_STATE_MAGIC 0x4E42534CUL
+#define HISTORY_FILE "/history.bin"      //riwayat sensor, sampel baru di-append sebelum deep sleep
+#define HISTORY_FILE_MAGIC 0x4E424841UL
+#define HISTORY_FILE_SAMPLES (2 * HISTORY_SIZE)  //file ditulis ulang hanya berisi ring jika melebihi ini
+
+// Profiler loop (/perf): scoped timer per tahap, histogram log2 ukuran tetap
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0               //build diagnostik: -DPROFILER_ENABLED=1
+#endif
+#define PROFILE_BUCKETS 24               //bucket i = [2^i, 2^(i+1)) us, terakhir >= ~8 detik
+#define PROFILE_WARN_INTERVAL 60000      //jeda peringatan Serial per tahap yang lewat budget
+#define PROFILE_FILE "/profile.bin"      //histogram disimpan sebelum deep sleep
+#define PROFILE_FILE_MAGIC 0x4E425032UL
+#define PROFILE_BUDGET_LOOP 100          //ms, satu pass Scheduler::run()
+#define PROFILE_BUDGET_DISPATCH 1000     //ms terlambat dari jatuh tempo task (jitter)
+#define PROFILE_BUDGET_FEED 2500         //servo 1.5 detik + simpan jadwal
+#define PROFILE_BUDGET_TELEGRAM 100      //satu step; handshake TLS memblokir lebih lama
+#define PROFILE_BUDGET_SENSORS 10
+#define PROFILE_BUDGET_DISPLAY 30
+#define PROFILE_BUDGET_ALERTS 10
+#define PROFILE_BUDGET_HEALTH 20
+#define PROFILE_BUDGET_TIME 1500         //NTP blocking maksimal NTP_TIMEOUT
+#define PROFILE_BUDGET_DATALOG 50
+
+// Telemetri heap (/mem): ring sampel tren + penghitung per call-site
+#define MEM_SAMPLE_INTERVAL 60000        //cek low-water mark heap
+#define MEM_HISTORY_SIZE 48              //sampel tren: 48 x 30 menit = 24 jam
+#define MEM_HISTORY_PERIOD 1800          //detik antar sampel ring
+#define MEM_FILE "/memory.bin"           //ring & counter disimpan sebelum deep sleep
+#define MEM_FILE_MAGIC 0x4E424D4DUL
+#define MEM_LOW_HEAP 5000                //peringatan heap bebas
+#define MEM_CRITICAL_HEAP 2000           //restart paksa
+#define MEM_MIN_BLOCK 4096               //blok terbesar di bawah ini = heap terfragmentasi
+#define MEM_LEAK_RATE 64                 //B/jam low-water turun terus = dilaporkan sebagai leak
+
+// Estimasi konsumsi untuk /sysinfo
+#define CURRENT_AWAKE_MA 75.0            //ESP8266 + WiFi + sensor
+#define CURRENT_SLEEP_MA 0.5             //deep sleep + regulator + divider baterai
+#define BATTERY_CAPACITY_MAH 2200.0
+
 // Konstan read baterai
 #define VOLTAGE_SCALE 3.955  //Voltage Awal / Voltage setelah voltage divider 
 #define ANALOG_READ_MAX_BIT 1023.0
@@ -52,11 +205,33 @@ const int VOLT_READ_PIN = A0;
 #define VOLTAGE_DIVIDER_VOLT 2
 #define OFFSET_ANALOG_VALUE 17  //tes a0 dengan ground
 
+// Kebijakan sampling baterai (WiFi tetap terhubung)
+#define BATTERY_SAMPLE_ASSOCIATED 0   //oversample kapan saja
+#define BATTERY_SAMPLE_RADIO_IDLE 1   //tunggu jendela radio idle dulu
+#define BATTERY_SAMPLE_POLICY BATTERY_SAMPLE_RADIO_IDLE
+#define BATTERY_OVERSAMPLE_COUNT 8
+#define BATTERY_SAMPLE_SPACING_MS 2   //analogRead terlalu rapat bisa memutus WiFi
+#define BATTERY_RADIO_IDLE_WINDOW 200 //ms tanpa trafik radio sebelum ADC dibaca
+#define BATTERY_MAX_SAMPLE_AGE 60000  //paksa sampling walau radio terus sibuk
+#define BATTERY_RETRY_INTERVAL 1000   //ms antar cek jendela idle selama request HTTPS berjalan
+
 // Threshold hardware
 #define FOOD_WARNING_THRESHOLD 30.0
 #define FOOD_CRITICAL_THRESHOLD 15.0
 #define WATER_WARNING_THRESHOLD 25.0
 #define WATER_CRITICAL_THRESHOLD 10.0
-#define ALERT_COOLDOWN_MINUTES 30
+
+// Aturan alert per channel (tabel AlertManager::rules)
+#define FOOD_ALERT_HYSTERESIS 10.0       //pulih setelah naik di atas ambang + band
+#define WATER_ALERT_HYSTERESIS 10.0
+#define BATTERY_ALERT_HYSTERESIS 5.0
+#define FOOD_ALERT_COOLDOWN 30           //menit antar alert level sama, per channel
+#define WATER_ALERT_COOLDOWN 30
+#define BATTERY_ALERT_COOLDOWN 30
+#define FOOD_ALERT_REMIND 720            //menit, ulangi alert kritis yang belum ditangani
+#define WATER_ALERT_REMIND 360
+#define BATTERY_ALERT_REMIND 180
+#define ULTRASONIC_ALERT_CONFIRM 2       //spike ultrasonik saat filter masih kosong (setelah bangun)
+#define BATTERY_ALERT_CONFIRM 1          //ADC sudah oversampling
 
 #endif
\ No newline at end of file
@@ -1,97 +1,310 @@
 #include "dataLogger.h"
 #include "hardware.h"
+#include "recordStore.h"
+#include "timeManager.h"
+#include "profiler.h"
+#include "memoryMonitor.h"
 
-LogData DataLogger::currentData;
-unsigned long DataLogger::lastLogTime = 0;
+HistorySample DataLogger::history[HISTORY_SIZE];
+int DataLogger::historyHead = 0;
+int DataLogger::historyCount = 0;
+unsigned long DataLogger::oldestEpoch = 0;
+unsigned long DataLogger::newestEpoch = 0;
+bool DataLogger::historyFrozen = false;
+HistoryEvent DataLogger::pendingEvent = HISTORY_EVENT_NONE;
+unsigned long DataLogger::pendingEventEpoch = 0;
 int DataLogger::totalFeeds = 0;
 String DataLogger::lastFeedTime = "";
-bool DataLogger::rtcDirty = false;
-unsigned long DataLogger::lastRTCSave = 0;
+bool DataLogger::totalsDirty = false;
+unsigned long DataLogger::lastTotalsChange = 0;
+int DataLogger::historyUnsaved = 0;
+int DataLogger::historyFileCount = 0;
 
 void DataLogger::init() {
-  loadFromRTC();
+  loadTotals();
+  loadHistory();
   Serial.println("✅ Data Logger initialized");
 }
 
 void DataLogger::logPeriodicData() {
-  unsigned long now = millis();
-  if (now - lastLogTime > DATA_LOG_INTERVAL) {
-    currentData.timestamp = now;
-    currentData.foodLevel = Hardware::getFoodLevel();
-    currentData.waterLevel = Hardware::getWaterLevel();
-    currentData.batteryVolt = Hardware::getBatteryVolt();
-    currentData.feedCount = totalFeeds;
-    currentData.lastFeedTime = lastFeedTime;
-    
-    lastLogTime = now;
+  PROFILE_SCOPE(PROFILE_DATALOG);
+  unsigned long epoch = TimeManager::getEpoch();
+  // feed yang terjadi selama ekspor dicatat setelah ekspor selesai
+  if (!historyFrozen && pendingEvent != HISTORY_EVENT_NONE) {
+    addSample(pendingEventEpoch, pendingEvent);
+    pendingEvent = HISTORY_EVENT_NONE;
+  }
+
+  // sampel hanya dicatat setelah jam valid supaya timestamp bermakna.
+  // Jarak dihitung dari epoch (bukan millis) supaya tetap benar setelah deep sleep.
+  if (!historyFrozen && getSecondsUntilNextSample() == 0 && TimeManager::isClockValid(epoch)) {
+    addSample(epoch, HISTORY_EVENT_NONE);
     
     // Print to serial for debugging
-    Serial.printf("LOG: F:%d%% W:%d%% B:%.1fV Feeds:%d\n", 
-                  currentData.foodLevel, currentData.waterLevel, 
-                  currentData.batteryVolt, currentData.feedCount);
+    Serial.printf("LOG: F:%d%% W:%d%% B:%.1fV Feeds:%d (%d samples)\n", 
+                  Hardware::getFoodLevel(), Hardware::getWaterLevel(), 
+                  Hardware::getBatteryVolt(), totalFeeds, historyCount);
   }
 
-  updateRTC();
+  updateTotals();
 }
 
-void DataLogger::logFeeding(String type, String time) {
-  totalFeeds++;
-  lastFeedTime = time;
-  rtcDirty = true;
-  Serial.println("Feed logged: " + type + " at " + time);
+  // Ring buffer: jika penuh, sampel terlama ditimpa dan epoch terlama maju
+  // sebesar selisih sampel berikutnya
+void DataLogger::addSample(unsigned long epoch, HistoryEvent event) {
+  unsigned long delta = 0;
+  if (historyCount > 0 && epoch > newestEpoch) {
+    delta = epoch - newestEpoch;
+    if (delta > 0xFFFF) delta = 0xFFFF;  // celah panjang dipotong (~18 jam)
+  }
+
+  if (historyCount == HISTORY_SIZE) {
+    historyHead = (historyHead + 1) % HISTORY_SIZE;
+    historyCount--;
+    oldestEpoch += history[historyHead].timeDelta;
+  }
+
+  HistorySample& sample = history[(historyHead + historyCount) % HISTORY_SIZE];
+  sample.timeDelta = delta;
+  sample.foodLevel = constrain(Hardware::getFoodLevel(), 0, 100);
+  sample.waterLevel = constrain(Hardware::getWaterLevel(), 0, 100);
+  sample.batteryMilliVolt = constrain(Hardware::getBatteryVolt() * 1000, 0, 0xFFFF);
+  sample.feedEvent = event != HISTORY_EVENT_NONE;
+  sample.autoFeed = event == HISTORY_EVENT_FEED_AUTO;
+
+  if (historyCount == 0) oldestEpoch = epoch;
+  newestEpoch = (historyCount == 0) ? epoch : newestEpoch + delta;
+  historyCount++;
+  historyUnsaved++;
+}
+
+float DataLogger::sampleValue(const HistorySample& sample, HistoryChannel channel) {
+  switch (channel) {
+    case HISTORY_FOOD: return sample.foodLevel;
+    case HISTORY_WATER: return sample.waterLevel;
+    default: return sample.batteryMilliVolt / 1000.0;
+  }
 }
 
-void DataLogger::updateRTC() {
-  if (rtcDirty && millis() - lastRTCSave > 10000) {  // simpan minimal 10 detik setelah update terakhir
-    saveToRTC();
-    rtcDirty = false;
-    lastRTCSave = millis();
+  // min/max/avg sampel dalam windowSeconds terakhir, dari terbaru ke belakang
+HistoryStats DataLogger::getStats(HistoryChannel channel, unsigned long windowSeconds) {
+  HistoryStats stats = {0, 0, 0, 0};
+  unsigned long sampleEpoch = newestEpoch;
+  float sum = 0;
+
+  for (int i = historyCount - 1; i >= 0; i--) {
+    if (newestEpoch - sampleEpoch > windowSeconds) break;
+    const HistorySample& sample = history[(historyHead + i) % HISTORY_SIZE];
+    float value = sampleValue(sample, channel);
+    if (stats.count == 0 || value < stats.min) stats.min = value;
+    if (stats.count == 0 || value > stats.max) stats.max = value;
+    sum += value;
+    stats.count++;
+    sampleEpoch -= sample.timeDelta;
   }
+
+  if (stats.count > 0) stats.avg = sum / stats.count;
+  return stats;
+}
+
+int DataLogger::getHistoryCount() {
+  return historyCount;
 }
 
-void DataLogger::saveToRTC() {
-  RTCData data;
-  data.marker = 0xDEADBEEF;
-  data.totalFeeds = totalFeeds;
-  lastFeedTime.toCharArray(data.lastFeedTime, sizeof(data.lastFeedTime));
+const HistorySample& DataLogger::getSample(int index) {
+  return history[(historyHead + index) % HISTORY_SIZE];
+}
+
+unsigned long DataLogger::getOldestEpoch() {
+  return oldestEpoch;
+}
+
+  // Selama ekspor isi ring tidak boleh berubah: dua pass harus menghasilkan
+  // byte yang sama persis (Content-Length dihitung di pass pertama)
+void DataLogger::setHistoryFrozen(bool frozen) {
+  historyFrozen = frozen;
+}
+
+  // Jam yang mundur (koreksi NTP) ke sebelum sampel terbaru dihitung belum
+  // ada waktu berlalu: sampel berikutnya menunggu sampai jam melewati lagi
+  // newestEpoch, bukan mencatat sampel berselisih 0 di setiap pass
+unsigned long DataLogger::getSecondsUntilNextSample() {
+  if (historyCount == 0) return 0;
+  unsigned long now = TimeManager::getEpoch();
+  unsigned long elapsed = now > newestEpoch ? now - newestEpoch : 0;
+  unsigned long interval = DATA_LOG_INTERVAL / 1000;
+  return elapsed >= interval ? 0 : interval - elapsed;
+}
+
+  // Sebelum deep sleep: RAM hilang, jadi total & riwayat ditulis ke flash
+void DataLogger::prepareSleep() {
+  if (totalsDirty) {
+    saveTotals();
+    totalsDirty = false;
+  }
+  saveHistory();
+}
 
-  if (!ESP.rtcUserMemoryWrite(0, (uint32_t*)&data, sizeof(data))) {
-    Serial.println("❌ Failed to save to RTC memory");
+  // Hanya sampel baru yang di-append (beberapa byte per tidur, bukan seluruh
+  // ring ~5 KB). File ditulis ulang berisi ring saja jika belum ada/rusak,
+  // ada sampel yang tertimpa sebelum sempat disimpan, atau melebihi
+  // HISTORY_FILE_SAMPLES.
+void DataLogger::saveHistory() {
+  if (historyUnsaved == 0) return;
+  MEM_TRACK(MEM_SITE_LOG_HISTORY);
+  bool append = historyFileCount > 0 && historyUnsaved <= historyCount &&
+                historyFileCount + historyUnsaved <= HISTORY_FILE_SAMPLES;
+  File file = LittleFS.open(HISTORY_FILE, append ? "a" : "w");
+  if (!file) {
+    Serial.println("❌ Failed to save history");
+    return;
+  }
+  int first = 0;
+  if (append) {
+    first = historyCount - historyUnsaved;
   } else {
-    Serial.println("💾 Saved to RTC memory");
+    HistoryFileHeader header;
+    header.magic = HISTORY_FILE_MAGIC;
+    header.oldestEpoch = oldestEpoch;
+    header.sampleSize = sizeof(HistorySample);
+    header.reserved = 0;
+    file.write((const uint8_t*)&header, sizeof(header));
+    historyFileCount = 0;
+  }
+  // ring ditulis per potongan yang bersebelahan di array
+  for (int i = first; i < historyCount; ) {
+    int slot = (historyHead + i) % HISTORY_SIZE;
+    int run = min(historyCount - i, HISTORY_SIZE - slot);
+    file.write((const uint8_t*)&history[slot], run * sizeof(HistorySample));
+    i += run;
   }
+  file.close();
+  historyFileCount += historyCount - first;
+  historyUnsaved = 0;
 }
 
-void DataLogger::loadFromRTC() {
-  RTCData data;
-  if (!ESP.rtcUserMemoryRead(0, (uint32_t*)&data, sizeof(data))) {
-    Serial.println("❌ Failed to read from RTC memory");
+  // File bisa berisi lebih dari HISTORY_SIZE sampel: dibaca berurutan ke ring
+  // seperti addSample, jadi yang tersisa adalah HISTORY_SIZE sampel terbaru
+void DataLogger::loadHistory() {
+  MEM_TRACK(MEM_SITE_LOG_HISTORY);
+  File file = LittleFS.open(HISTORY_FILE, "r");
+  if (!file) return;
+
+  HistoryFileHeader header;
+  if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      header.magic != HISTORY_FILE_MAGIC || header.sampleSize != sizeof(HistorySample)) {
+    file.close();
     return;
   }
+  int fileCount = 0;
+  HistorySample sample;
+  while (file.read((uint8_t*)&sample, sizeof(sample)) == sizeof(sample)) {
+    if (historyCount == HISTORY_SIZE) {
+      historyHead = (historyHead + 1) % HISTORY_SIZE;
+      historyCount--;
+      oldestEpoch += history[historyHead].timeDelta;
+    }
+    history[(historyHead + historyCount) % HISTORY_SIZE] = sample;
+    if (historyCount == 0) oldestEpoch = newestEpoch = header.oldestEpoch;
+    else newestEpoch += sample.timeDelta;
+    historyCount++;
+    fileCount++;
+  }
+  // sisa sampel setengah tertulis (daya putus saat append): append berikutnya
+  // tidak lagi sejajar, jadi file ditulis ulang saat simpan berikutnya
+  bool aligned = file.size() == sizeof(header) + fileCount * sizeof(HistorySample);
+  historyFileCount = aligned ? fileCount : 0;
+  file.close();
+  if (historyCount > 0) Serial.printf("📥 Loaded %d history samples\n", historyCount);
+}
+
+void DataLogger::logFeeding(const char* type, const char* time) {
+  MEM_TRACK(MEM_SITE_LOG_FEED);
+  totalFeeds++;
+  lastFeedTime = time;
+
+  unsigned long epoch = TimeManager::getEpoch();
+  if (TimeManager::isClockValid(epoch)) {
+    HistoryEvent event = strcmp(type, "AUTO") == 0 ? HISTORY_EVENT_FEED_AUTO : HISTORY_EVENT_FEED_MANUAL;
+    if (historyFrozen) {
+      pendingEvent = event;
+      pendingEventEpoch = epoch;
+    } else {
+      addSample(epoch, event);
+    }
+  }
+  totalsDirty = true;
+  lastTotalsChange = millis();
+  Serial.printf("Feed logged: %s at %s\n", type, time);
+}
+
+void DataLogger::updateTotals() {
+  if (totalsDirty && millis() - lastTotalsChange > TOTALS_SAVE_DELAY) {  // simpan minimal 10 detik setelah update terakhir
+    saveTotals();
+    totalsDirty = false;
+  }
+}
+
+void DataLogger::saveTotals() {
+  MEM_TRACK(MEM_SITE_LOG_TOTALS);
+  TotalsRecord record;
+  memset(&record, 0, sizeof(record));
+  record.totalFeeds = totalFeeds;
+  lastFeedTime.toCharArray(record.lastFeedTime, sizeof(record.lastFeedTime));
 
-  if (data.marker != 0xDEADBEEF) {
-    Serial.println("⚠️ RTC data invalid - resetting");
+  if (!RecordStore::write(RECORD_TOTALS, &record, sizeof(record))) {
+    Serial.println("❌ Failed to save totals");
+  } else {
+    Serial.println("💾 Totals saved");
+  }
+}
+
+void DataLogger::loadTotals() {
+  MEM_TRACK(MEM_SITE_LOG_TOTALS);
+  TotalsRecord record;
+  if (!RecordStore::read(RECORD_TOTALS, &record, sizeof(record))) {
+    Serial.println("⚠️ No saved totals - starting from zero");
     totalFeeds = 0;
     lastFeedTime = "-";
     return;
   }
 
-  totalFeeds = data.totalFeeds;
-  lastFeedTime = String(data.lastFeedTime);
+  totalFeeds = record.totalFeeds;
+  record.lastFeedTime[sizeof(record.lastFeedTime) - 1] = '\0';
+  lastFeedTime = String(record.lastFeedTime);
 
-  Serial.println("📥 Loaded from RTC memory:");
+  Serial.println("📥 Loaded totals from flash:");
   Serial.println(" - Total Feeds: " + String(totalFeeds));
   Serial.println(" - Last Feed: " + lastFeedTime);
 }
 
-String DataLogger::getDataSummary() {
-  String summary = "📊 DATA SUMMARY\n\n";
-  summary += "🍽️ Total feeds: " + String(totalFeeds) + "\n";
-  summary += "⏰ Last feed: " + lastFeedTime + "\n";
-  summary += "🔋 Battery: " + String(Hardware::getBatteryVolt(), 1) + "V\n";
-  summary += "📈 Food: " + String(Hardware::getFoodLevel()) + "%\n";
-  summary += "💧 Water: " + String(Hardware::getWaterLevel()) + "%\n";
-  return summary;
+  // Dijawab dari riwayat, bukan pembacaan sensor langsung
+void DataLogger::getDataSummary(MessageBuffer& summary) {
+  summary.append("📊 DATA SUMMARY\n\n");
+  summary.appendf("🍽️ Total feeds: %d\n", totalFeeds);
+  summary.appendf("⏰ Last feed: %s\n", lastFeedTime.c_str());
+
+  if (historyCount == 0) {
+    summary.append("\n- No sensor history yet -\n");
+    return;
+  }
+
+  const HistorySample& latest = history[(historyHead + historyCount - 1) % HISTORY_SIZE];
+  unsigned long now = TimeManager::getEpoch();
+  unsigned long age = now > newestEpoch ? (now - newestEpoch) / 60 : 0;
+  summary.appendf("\nLatest (%lu min ago):\n", age);
+  summary.appendf("🔋 Battery: %.1fV\n", latest.batteryMilliVolt / 1000.0);
+  summary.appendf("📈 Food: %d%%\n", latest.foodLevel);
+  summary.appendf("💧 Water: %d%%\n", latest.waterLevel);
+
+  HistoryStats food = getStats(HISTORY_FOOD, HISTORY_SUMMARY_WINDOW);
+  HistoryStats water = getStats(HISTORY_WATER, HISTORY_SUMMARY_WINDOW);
+  HistoryStats battery = getStats(HISTORY_BATTERY, HISTORY_SUMMARY_WINDOW);
+  summary.appendf("\nLast %luh (%d samples), min/avg/max:\n",
+                  HISTORY_SUMMARY_WINDOW / 3600, food.count);
+  summary.appendf("📈 Food: %.0f / %.0f / %.0f%%\n", food.min, food.avg, food.max);
+  summary.appendf("💧 Water: %.0f / %.0f / %.0f%%\n", water.min, water.avg, water.max);
+  summary.appendf("🔋 Battery: %.2f / %.2f / %.2fV\n", battery.min, battery.avg, battery.max);
 }
 
 int DataLogger::getTotalFeeds() {
@@ -2,41 +2,94 @@
 #define DATA_LOGGER_H
 
 #include "config.h"
+#include "messageBuffer.h"
+#include <LittleFS.h>
 
 class Hardware;
 
-struct LogData {
-  unsigned long timestamp;
-  int foodLevel;
-  int waterLevel;
-  float batteryVolt;
-  int feedCount;
-  String lastFeedTime;
+// Satu sampel riwayat, 6 byte. Timestamp disimpan sebagai selisih detik
+// dari sampel sebelumnya; epoch absolut hanya untuk sampel terlama & terbaru.
+// Pemberian makan dicatat sebagai sampel dengan feedEvent = 1.
+struct HistorySample {
+  uint16_t timeDelta;
+  uint8_t foodLevel : 7;      // %
+  uint8_t feedEvent : 1;
+  uint8_t waterLevel : 7;     // %
+  uint8_t autoFeed : 1;       // feedEvent dari jadwal, bukan manual
+  uint16_t batteryMilliVolt;
 };
 
-struct RTCData {
-  uint32_t marker;
-  int totalFeeds;
+enum HistoryEvent {
+  HISTORY_EVENT_NONE,
+  HISTORY_EVENT_FEED_MANUAL,
+  HISTORY_EVENT_FEED_AUTO
+};
+
+enum HistoryChannel {
+  HISTORY_FOOD,
+  HISTORY_WATER,
+  HISTORY_BATTERY
+};
+
+// Header file HISTORY_FILE; sampel menyusul terlama dulu dan hanya
+// ditambah di akhir. Epoch sampel = epoch sampel sebelumnya + timeDelta.
+struct HistoryFileHeader {
+  uint32_t magic;
+  uint32_t oldestEpoch;       // sampel pertama di file
+  uint16_t sampleSize;
+  uint16_t reserved;
+};
+
+struct HistoryStats {
+  int count;
+  float min;
+  float max;
+  float avg;
+};
+
+// Record RECORD_TOTALS di RecordStore
+struct TotalsRecord {
+  int32_t totalFeeds;
   char lastFeedTime[32];
 };
 
 class DataLogger {
 private:
-  static LogData currentData;
-  static unsigned long lastLogTime;
+  static HistorySample history[HISTORY_SIZE];
+  static int historyHead;           // slot sampel terlama
+  static int historyCount;
+  static unsigned long oldestEpoch;
+  static unsigned long newestEpoch;
+  static bool historyFrozen;        // sedang diekspor, sampel baru ditunda
+  static HistoryEvent pendingEvent;
+  static unsigned long pendingEventEpoch;
   static int totalFeeds;
   static String lastFeedTime;
-  static bool rtcDirty;
-  static unsigned long lastRTCSave;
+  static bool totalsDirty;
+  static unsigned long lastTotalsChange;
+  static int historyUnsaved;        // sampel baru sejak terakhir ditulis ke file
+  static int historyFileCount;      // sampel di file; 0 = tulis ulang saat simpan
+
+  static void addSample(unsigned long epoch, HistoryEvent event);
+  static float sampleValue(const HistorySample& sample, HistoryChannel channel);
+  static void saveHistory();
+  static void loadHistory();
 
 public:
   static void init();
   static void logPeriodicData();
-  static void logFeeding(String type, String time);
-  static void saveToRTC();    //RTC digunakan agar data tidak hilang walau device mati
-  static void updateRTC();
-  static void loadFromRTC();
-  static String getDataSummary();
+  static void logFeeding(const char* type, const char* time);
+  static void saveTotals();   //disimpan di flash agar tidak hilang walau daya putus
+  static void updateTotals();
+  static void loadTotals();
+  static void getDataSummary(MessageBuffer& summary);
+  static HistoryStats getStats(HistoryChannel channel, unsigned long windowSeconds);
+  static int getHistoryCount();
+  static const HistorySample& getSample(int index);   // 0 = terlama
+  static unsigned long getOldestEpoch();
+  static void setHistoryFrozen(bool frozen);
+  static unsigned long getSecondsUntilNextSample();
+  static void prepareSleep();
   static int getTotalFeeds();
 };
 
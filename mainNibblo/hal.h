@@ -0,0 +1,52 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define RTC_USER_MEMORY_SIZE 512  // byte, ESP8266 RTC user memory
+
+// Lapisan tipis antara firmware dan perangkat keras board: pin, ADC, servo,
+// OLED, RTC memory dan reset. Backend dipilih saat kompilasi:
+// halEsp8266.cpp (default) atau halSim.cpp (NIBBLO_SIM, tools/simulator).
+// Waktu (millis/delay), WiFi dan LittleFS tetap API Arduino; di simulator
+// API itu disediakan shim host yang berjalan di atas jam virtual.
+class Hal {
+public:
+  // GPIO & ADC
+  static void pinOutput(uint8_t pin);
+  static void pinInput(uint8_t pin);
+  static void writePin(uint8_t pin, bool high);
+  static bool readPin(uint8_t pin);
+  static void attachEdgeInterrupt(uint8_t pin, void (*isr)());  // tepi naik & turun
+  static int readAnalog(uint8_t pin);
+
+  // Servo pakan
+  static void servoAttach(uint8_t pin, int minPulseUs, int maxPulseUs);
+  static void servoWrite(int angle);
+
+  // OLED SSD1306, teks ukuran 1 (6x8 px per karakter)
+  static bool displayBegin();
+  static void displayClear();
+  static void displayClearRect(int16_t x, int16_t y, int16_t width, int16_t height);
+  static void displayText(int16_t x, int16_t y, const char* text);
+  static void displayShow();                                     // seluruh buffer
+  static void displayPushPages(uint8_t firstPage, uint8_t lastPage);
+  static void displayOff();
+
+  // RTC user memory, bertahan saat deep sleep. offset dalam blok 4 byte,
+  // length kelipatan 4
+  static bool rtcRead(uint32_t offset, void* data, size_t length);
+  static bool rtcWrite(uint32_t offset, const void* data, size_t length);
+
+  // Reset & daya
+  static bool wokeFromDeepSleep();
+  static uint64_t deepSleepMax();                 // us
+  static void deepSleep(uint64_t micros);         // tidak kembali
+  static void restart();                          // tidak kembali
+  static uint32_t getFreeHeap();
+  static uint32_t getMaxFreeBlock();              // alokasi terbesar yang masih bisa dipenuhi
+  static uint8_t getHeapFragmentation();          // 0-100%
+};
+
+#endif
\ No newline at end of file
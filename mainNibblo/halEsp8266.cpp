@@ -0,0 +1,96 @@
+#ifndef NIBBLO_SIM
+#include "hal.h"
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+#include <Servo.h>
+
+// objek library hanya dikenal backend ini
+static Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
+static Servo feedServo;
+
+void Hal::pinOutput(uint8_t pin) { pinMode(pin, OUTPUT); }
+void Hal::pinInput(uint8_t pin) { pinMode(pin, INPUT); }
+void Hal::writePin(uint8_t pin, bool high) { digitalWrite(pin, high ? HIGH : LOW); }
+bool IRAM_ATTR Hal::readPin(uint8_t pin) { return digitalRead(pin) == HIGH; }
+int Hal::readAnalog(uint8_t pin) { return analogRead(pin); }
+
+void Hal::attachEdgeInterrupt(uint8_t pin, void (*isr)()) {
+  attachInterrupt(digitalPinToInterrupt(pin), isr, CHANGE);
+}
+
+void Hal::servoAttach(uint8_t pin, int minPulseUs, int maxPulseUs) {
+  feedServo.attach(pin, minPulseUs, maxPulseUs);
+}
+
+void Hal::servoWrite(int angle) { feedServo.write(angle); }
+
+bool Hal::displayBegin() {
+  Wire.begin(SDA_PIN, SCL_PIN);
+  if (!display.begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS)) return false;
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextColor(WHITE);
+  return true;
+}
+
+void Hal::displayClear() { display.clearDisplay(); }
+
+void Hal::displayClearRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+  display.fillRect(x, y, width, height, BLACK);
+}
+
+void Hal::displayText(int16_t x, int16_t y, const char* text) {
+  display.setCursor(x, y);
+  display.print(text);
+}
+
+void Hal::displayShow() { display.display(); }
+
+  // tulis page firstPage..lastPage langsung lewat I2C, tanpa display()
+void Hal::displayPushPages(uint8_t firstPage, uint8_t lastPage) {
+  display.ssd1306_command(SSD1306_PAGEADDR);
+  display.ssd1306_command(firstPage);
+  display.ssd1306_command(lastPage);
+  display.ssd1306_command(SSD1306_COLUMNADDR);
+  display.ssd1306_command(0);
+  display.ssd1306_command(SCREEN_WIDTH - 1);
+
+  uint8_t* buffer = display.getBuffer() + firstPage * SCREEN_WIDTH;
+  unsigned long count = (lastPage - firstPage + 1) * SCREEN_WIDTH;
+  unsigned long sent = 0;
+  while (sent < count) {
+    Wire.beginTransmission(OLED_I2C_ADDRESS);
+    Wire.write((uint8_t)0x40);  // co = 0, D/C = 1: data
+    uint8_t chunk = 0;
+    while (chunk < OLED_I2C_CHUNK - 1 && sent < count) {
+      Wire.write(buffer[sent++]);
+      chunk++;
+    }
+    Wire.endTransmission();
+  }
+}
+
+  // panel OLED tetap menyala saat ESP deep sleep, matikan manual
+void Hal::displayOff() { display.ssd1306_command(SSD1306_DISPLAYOFF); }
+
+bool Hal::rtcRead(uint32_t offset, void* data, size_t length) {
+  return ESP.rtcUserMemoryRead(offset, (uint32_t*)data, length);
+}
+
+bool Hal::rtcWrite(uint32_t offset, const void* data, size_t length) {
+  return ESP.rtcUserMemoryWrite(offset, (uint32_t*)data, length);
+}
+
+bool Hal::wokeFromDeepSleep() {
+  return ESP.getResetInfoPtr()->reason == REASON_DEEP_SLEEP_AWAKE;
+}
+
+uint64_t Hal::deepSleepMax() { return ESP.deepSleepMax(); }
+void Hal::deepSleep(uint64_t micros) { ESP.deepSleep(micros, WAKE_RF_DEFAULT); }
+void Hal::restart() { ESP.restart(); }
+uint32_t Hal::getFreeHeap() { return ESP.getFreeHeap(); }
+uint32_t Hal::getMaxFreeBlock() { return ESP.getMaxFreeBlockSize(); }
+uint8_t Hal::getHeapFragmentation() { return ESP.getHeapFragmentation(); }
+
+#endif
@@ -0,0 +1,163 @@
+#ifdef NIBBLO_SIM
+#include "hal.h"
+#include <simulator.h>
+
+#define SIM_PIN_COUNT 18
+#define SIM_ECHO_DELAY_US 450            // burst 8 x 40 kHz sebelum echo naik
+#define SIM_ECHO_MAX_CM 400              // lebih jauh = tidak ada echo (timeout)
+#define SIM_ADC_READ_US 100
+#define SIM_DEEP_SLEEP_MAX_US 12600000000ULL  // ~3.5 jam, batas timer RTC ESP8266
+#define SIM_TEXT_COLUMNS (SCREEN_WIDTH / 6)
+#define SIM_TEXT_PAGES (SCREEN_HEIGHT / 8)
+
+// Backend simulasi: sensor dari trace (Sim::getSensors), echo HC-SR04 sebagai
+// timer virtual yang memanggil ISR, servo dicatat sebagai event, OLED sebagai
+// framebuffer teks 21x8 (satu sel = 6x8 px, satu baris = satu page SSD1306).
+static bool pinLevel[SIM_PIN_COUNT];
+static void (*pinIsr[SIM_PIN_COUNT])();
+static char frameBuffer[SIM_TEXT_PAGES][SIM_TEXT_COLUMNS];  // RAM display (Adafruit buffer)
+static char panel[SIM_TEXT_PAGES][SIM_TEXT_COLUMNS];        // yang terlihat di layar
+static bool panelOn = false;
+
+static void echoEdge(int arg) {
+  uint8_t pin = arg >> 1;
+  pinLevel[pin] = arg & 1;
+  if (pinIsr[pin]) pinIsr[pin]();
+}
+
+  // tepi turun trigger: echo naik setelah burst, lebar pulsa = jarak pulang-pergi
+static void ping(uint8_t echoPin, float distanceCm) {
+  if (distanceCm <= 0 || distanceCm > SIM_ECHO_MAX_CM) return;
+  uint64_t rise = Sim::now() + SIM_ECHO_DELAY_US;
+  uint64_t width = (uint64_t)(distanceCm * 2 / 0.0343);
+  Sim::schedule(rise, echoEdge, echoPin << 1 | 1);
+  Sim::schedule(rise + width, echoEdge, echoPin << 1);
+}
+
+void Hal::pinOutput(uint8_t pin) { (void)pin; }
+void Hal::pinInput(uint8_t pin) { (void)pin; }
+
+void Hal::writePin(uint8_t pin, bool high) {
+  bool falling = pinLevel[pin] && !high;
+  pinLevel[pin] = high;
+  if (!falling) return;
+  if (pin == TRIG_FOOD_PIN) ping(ECHO_FOOD_PIN, Sim::getSensors().foodCm);
+  if (pin == TRIG_WATER_PIN) ping(ECHO_WATER_PIN, Sim::getSensors().waterCm);
+}
+
+bool Hal::readPin(uint8_t pin) { return pinLevel[pin]; }
+void Hal::attachEdgeInterrupt(uint8_t pin, void (*isr)()) { pinIsr[pin] = isr; }
+
+  // kebalikan rumus Hardware::readAnalogVoltage()
+int Hal::readAnalog(uint8_t pin) {
+  (void)pin;
+  Sim::advance(SIM_ADC_READ_US);
+  float volt = Sim::getSensors().batteryVolt;
+  int value = lround(volt / VOLTAGE_SCALE * ANALOG_READ_MAX_BIT / ANALOG_READ_MAX_VOLT) + OFFSET_ANALOG_VALUE;
+  return constrain(value, 0, (int)ANALOG_READ_MAX_BIT);
+}
+
+void Hal::servoAttach(uint8_t pin, int minPulseUs, int maxPulseUs) {
+  (void)pin;
+  (void)minPulseUs;
+  (void)maxPulseUs;
+}
+
+void Hal::servoWrite(int angle) {
+  if (angle == Sim::shared->servoAngle) return;
+  Sim::shared->servoAngle = angle;
+  Sim::event("servo", "%d", angle);
+  if (angle == SERVO_FEED_ANGLE) Sim::recordFeed();
+}
+
+bool Hal::displayBegin() {
+  displayClear();
+  memset(panel, ' ', sizeof(panel));
+  panelOn = true;
+  return true;
+}
+
+void Hal::displayClear() { memset(frameBuffer, ' ', sizeof(frameBuffer)); }
+
+void Hal::displayClearRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+  for (int page = y / 8; page <= (y + height - 1) / 8 && page < SIM_TEXT_PAGES; page++) {
+    for (int column = x / 6; column <= (x + width - 1) / 6 && column < SIM_TEXT_COLUMNS; column++) {
+      frameBuffer[page][column] = ' ';
+    }
+  }
+}
+
+  // teks terlalu panjang pindah ke baris berikutnya seperti wrap Adafruit_GFX
+void Hal::displayText(int16_t x, int16_t y, const char* text) {
+  int column = x / 6;
+  int page = y / 8;
+  for (const char* p = text; *p && page < SIM_TEXT_PAGES; p++) {
+    if (*p == '\n' || column >= SIM_TEXT_COLUMNS) {
+      column = 0;
+      page++;
+      if (*p == '\n' || page >= SIM_TEXT_PAGES) continue;
+    }
+    frameBuffer[page][column++] = (*p >= ' ' && *p < 0x7F) ? *p : '?';
+  }
+}
+
+static void dumpPanel() {
+  char frame[(SIM_TEXT_COLUMNS + 3) * (SIM_TEXT_PAGES + 2) + 1];
+  char* out = frame;
+  *out++ = '+';
+  memset(out, '-', SIM_TEXT_COLUMNS);
+  out += SIM_TEXT_COLUMNS;
+  *out++ = '+';
+  *out++ = '\n';
+  for (int page = 0; page < SIM_TEXT_PAGES; page++) {
+    *out++ = '|';
+    if (panelOn) memcpy(out, panel[page], SIM_TEXT_COLUMNS);
+    else memset(out, ' ', SIM_TEXT_COLUMNS);  // panel mati
+    out += SIM_TEXT_COLUMNS;
+    *out++ = '|';
+    *out++ = '\n';
+  }
+  *out++ = '+';
+  memset(out, '-', SIM_TEXT_COLUMNS);
+  out += SIM_TEXT_COLUMNS;
+  *out++ = '+';
+  *out++ = '\n';
+  *out = '\0';
+  Sim::dumpFrame(frame);
+}
+
+void Hal::displayShow() { displayPushPages(0, SIM_TEXT_PAGES - 1); }
+
+void Hal::displayPushPages(uint8_t firstPage, uint8_t lastPage) {
+  memcpy(panel[firstPage], frameBuffer[firstPage], (lastPage - firstPage + 1) * SIM_TEXT_COLUMNS);
+  panelOn = true;
+  dumpPanel();
+}
+
+void Hal::displayOff() {
+  panelOn = false;
+  dumpPanel();
+}
+
+bool Hal::rtcRead(uint32_t offset, void* data, size_t length) {
+  if (offset * 4 + length > RTC_USER_MEMORY_SIZE || length % 4) return false;
+  memcpy(data, Sim::shared->rtcMemory + offset, length);
+  return true;
+}
+
+bool Hal::rtcWrite(uint32_t offset, const void* data, size_t length) {
+  if (offset * 4 + length > RTC_USER_MEMORY_SIZE || length % 4) return false;
+  memcpy(Sim::shared->rtcMemory + offset, data, length);
+  return true;
+}
+
+bool Hal::wokeFromDeepSleep() { return Sim::shared->resetReason == SIM_RESET_DEEP_SLEEP; }
+uint64_t Hal::deepSleepMax() { return SIM_DEEP_SLEEP_MAX_US; }
+void Hal::deepSleep(uint64_t micros) { Sim::reset(SIM_RESET_DEEP_SLEEP, micros); }
+void Hal::restart() { Sim::reset(SIM_RESET_RESTART, 0); }
+uint32_t Hal::getFreeHeap() { return Sim::getFreeHeap(); }
+// malloc host tidak sebanding dengan umm_malloc: heap dianggap tidak terfragmentasi
+uint32_t Hal::getMaxFreeBlock() { return Sim::getFreeHeap(); }
+uint8_t Hal::getHeapFragmentation() { return 0; }
+
+#endif
@@ -1,81 +1,156 @@
 #include "hardware.h"
+#include "profiler.h"
+#include "alertManager.h"
 
 
 // inisiasi objek
-Adafruit_SSD1306 Hardware::display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
-Servo Hardware::feedServo;
+UltrasonicSensor Hardware::foodSensor;
+UltrasonicSensor Hardware::waterSensor;
+SensorFilter<FILTER_MEDIAN_SIZE> Hardware::foodFilter(LEVEL_FILTER_ALPHA, FOOD_OUTLIER_CM, FILTER_MAX_REJECTS);
+SensorFilter<FILTER_MEDIAN_SIZE> Hardware::waterFilter(LEVEL_FILTER_ALPHA, WATER_OUTLIER_CM, FILTER_MAX_REJECTS);
+SensorFilter<FILTER_MEDIAN_SIZE> Hardware::batteryFilter(BATTERY_FILTER_ALPHA, BATTERY_OUTLIER_VOLT, FILTER_MAX_REJECTS);
+
+// cache baris display, diisi ulang setelah displayMessage()
+char Hardware::displayCache[DISPLAY_ROWS][DISPLAY_LINE_CHARS + 1];
+bool Hardware::displayCacheValid = false;
+uint8_t Hardware::dirtyPages = 0;
+unsigned long Hardware::displayBytesTotal = 0;
+unsigned long Hardware::displayBytesThisMinute = 0;
+unsigned long Hardware::displayBytesLastMinute = 0;
+unsigned long Hardware::displayMinuteStart = 0;
+unsigned long Hardware::displaySkippedFrames = 0;
 
 //inisiasi variabel
 int Hardware::currentFoodLevel = 0;
 int Hardware::currentWaterLevel = 0;
 float Hardware::currentBatteryVolt = 0.0;
 float Hardware::currentBatteryPercent = 0.0;
+bool Hardware::batteryPending = false;
+unsigned long Hardware::lastLevelUpdate = 0;
+unsigned long Hardware::lastBatterySample = 0;
+unsigned long Hardware::lastRadioActivity = 0;
+unsigned long Hardware::reconnectsAvoided = 0;
 
 //implementasi fungsi
-void Hardware::init() {
-  // inisiasi I2C
-  Wire.begin(SDA_PIN, SCL_PIN);
-  
-  // inisiasi oled
-  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+void Hardware::init(bool showSplash) {
+  // inisiasi I2C & oled
+  if (!Hal::displayBegin()) {
     Serial.println("SSD1306 allocation failed");
     for (;;);
   }
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(WHITE);
-  displayMessage("Initializing...");
+  if (showSplash) displayMessage("Initializing...");
   
-  // Initialize sensors
-  pinMode(TRIG_FOOD_PIN, OUTPUT);
-  pinMode(ECHO_FOOD_PIN, INPUT);
-  pinMode(TRIG_WATER_PIN, OUTPUT);
-  pinMode(ECHO_WATER_PIN, INPUT);
+  // Initialize sensors (echo ditangkap lewat interrupt)
+  foodSensor.begin(TRIG_FOOD_PIN, ECHO_FOOD_PIN, foodEchoISR);
+  waterSensor.begin(TRIG_WATER_PIN, ECHO_WATER_PIN, waterEchoISR);
 
   // Initialize servo
-  feedServo.attach(SERVO_PIN, 500, 2400);
-  feedServo.write(SERVO_CLOSE_ANGLE);
+  Hal::servoAttach(SERVO_PIN, 500, 2400);
+  Hal::servoWrite(SERVO_CLOSE_ANGLE);
   
   //baca baterai awal
-  pinMode(VOLT_READ_PIN, INPUT);
+  Hal::pinInput(VOLT_READ_PIN);
   readAnalogVoltage();
   
   Serial.println("✅ Hardware initialized");
 }
 
-int Hardware::getDistanceCM(int trigPin, int echoPin) {
-  digitalWrite(trigPin, LOW);
-  delayMicroseconds(2);
-  digitalWrite(trigPin, HIGH);
-  delayMicroseconds(10);
-  digitalWrite(trigPin, LOW);
-  
-  long duration = pulseIn(echoPin, HIGH, 30000); // timeout 30 ms (maks 5 meter)
-  int distance = duration * 0.0343 / 2;
-  return distance;
+void IRAM_ATTR Hardware::foodEchoISR() {
+  foodSensor.onEchoEdge(Hal::readPin(ECHO_FOOD_PIN), micros());
 }
 
+void IRAM_ATTR Hardware::waterEchoISR() {
+  waterSensor.onEchoEdge(Hal::readPin(ECHO_WATER_PIN), micros());
+}
+
+  // Mulai satu siklus baca: baterai langsung, ultrasonik hanya di-trigger.
+  // Hasil ultrasonik diambil updateSensors() pada pass loop berikutnya.
 void Hardware::readAllSensors() {
-  delay(50);
   readAnalogVoltage();
-  readFoodSensor();
-  readWaterSensor();
+  if (!isRanging()) {
+    foodSensor.trigger();
+  }
+}
+
+  // Ping bergantian (makanan lalu air) supaya echo tidak saling ganggu
+void Hardware::updateSensors() {
+  if (batteryPending) {
+    readAnalogVoltage();
+  }
+  if (foodSensor.poll()) {
+    readFoodSensor();
+    waterSensor.trigger();
+  }
+  if (waterSensor.poll()) {
+    readWaterSensor();
+  }
+}
+
+bool Hardware::isRanging() {
+  return foodSensor.isBusy() || waterSensor.isBusy();
+}
+
+bool Hardware::isMeasuring() {
+  return isRanging() || batteryPending;
+}
+
+  // ms sampai sampel baterai yang tertunda layak dicoba lagi: jendela idle
+  // paling cepat terbuka BATTERY_RADIO_IDLE_WINDOW setelah trafik terakhir,
+  // dan selama request berjalan trafik terus ada, jadi tidak dicek lebih
+  // rapat dari BATTERY_RETRY_INTERVAL
+unsigned long Hardware::getBatteryRetryDelay() {
+  unsigned long idle = millis() - lastRadioActivity;
+  unsigned long wait = idle < BATTERY_RADIO_IDLE_WINDOW ? BATTERY_RADIO_IDLE_WINDOW - idle : 0;
+  return max(wait, (unsigned long)BATTERY_RETRY_INTERVAL);
+}
+
+  // dipanggil setiap ada trafik WiFi, dipakai kebijakan BATTERY_SAMPLE_RADIO_IDLE
+void Hardware::notifyRadioActivity() {
+  lastRadioActivity = millis();
+}
+
+  // Oversampling: buang nilai min & max (spike saat TX WiFi), rata-rata sisanya
+int Hardware::sampleBatteryADC() {
+  long sum = 0;
+  int minVal = ANALOG_READ_MAX_BIT;
+  int maxVal = 0;
+  for (int i = 0; i < BATTERY_OVERSAMPLE_COUNT; i++) {
+    if (i > 0) delay(BATTERY_SAMPLE_SPACING_MS);
+    int val = Hal::readAnalog(VOLT_READ_PIN);
+    sum += val;
+    if (val < minVal) minVal = val;
+    if (val > maxVal) maxVal = val;
+  }
+  if (BATTERY_OVERSAMPLE_COUNT > 2) {
+    return (sum - minVal - maxVal) / (BATTERY_OVERSAMPLE_COUNT - 2);
+  }
+  return sum / BATTERY_OVERSAMPLE_COUNT;
 }
 
 void Hardware::readAnalogVoltage(){
-  // Read battery voltage
-  // int analogVal = analogRead(VOLT_READ_PIN);
+  // Read battery voltage tanpa mematikan WiFi
+  unsigned long now = millis();
+#if BATTERY_SAMPLE_POLICY == BATTERY_SAMPLE_RADIO_IDLE
+  if (now - lastRadioActivity < BATTERY_RADIO_IDLE_WINDOW &&
+      now - lastBatterySample < BATTERY_MAX_SAMPLE_AGE) {
+    batteryPending = true;  // dicoba lagi oleh updateSensors()
+    return;
+  }
+#endif
+  batteryPending = false;
+  lastBatterySample = now;
 
-  WiFi.mode(WIFI_OFF);
-  delay(100); // biar ADC stabil
-  int analogVal = analogRead(VOLT_READ_PIN);
-  WiFi.mode(WIFI_STA); // atau WIFI_ON
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  int analogVal = sampleBatteryADC();
+  if (WiFi.status() == WL_CONNECTED) {
+    reconnectsAvoided++;  // dulu setiap baca = WiFi OFF + reassociate
+  }
 
   if(analogVal < OFFSET_ANALOG_VALUE) analogVal = OFFSET_ANALOG_VALUE;
-  currentBatteryVolt = (((analogVal - OFFSET_ANALOG_VALUE) * //hilangkan offset analog read value 
-                        (ANALOG_READ_MAX_VOLT / ANALOG_READ_MAX_BIT))) *
-                        VOLTAGE_SCALE;
+  float volt = (((analogVal - OFFSET_ANALOG_VALUE) * //hilangkan offset analog read value 
+                (ANALOG_READ_MAX_VOLT / ANALOG_READ_MAX_BIT))) *
+                VOLTAGE_SCALE;
+  bool accepted = batteryFilter.add(volt);
+  currentBatteryVolt = batteryFilter.value();
   if (currentBatteryVolt < 0) currentBatteryVolt = 0;
   
   // Calculate battery percentage
@@ -83,23 +158,36 @@ void Hardware::readAnalogVoltage(){
                           (BATTERY_MAX_VOLT - BATTERY_MIN_VOLT)) * 100;
   currentBatteryPercent = constrain(currentBatteryPercent, 0, 100);
   //constraint ngebatasin di range 0-100
+  if (accepted) AlertManager::onSensorReading(ALERT_BATTERY, currentBatteryPercent);
+}
+
+  // jarak ke persen dalam float (map() integer memotong MAX_*_DISTANCE pecahan)
+int Hardware::distanceToPercent(float distance, float maxDistance) {
+  float percent = (maxDistance - distance) / (maxDistance - MIN_DISTANCE) * 100;
+  return constrain((int)(percent + 0.5), 0, 100);
 }
 
 void Hardware::readFoodSensor(){
-  // Read food level
-  int foodDistance = getDistanceCM(TRIG_FOOD_PIN, ECHO_FOOD_PIN);
-  if (foodDistance <= 0 || foodDistance > MAX_FOOD_DISTANCE) foodDistance = MAX_FOOD_DISTANCE;
-  currentFoodLevel = map(foodDistance, MAX_FOOD_DISTANCE, MIN_DISTANCE, 0, 100); 
-  currentFoodLevel = constrain(currentFoodLevel, 0, 100);
-  //map merubah jarak jadi persen, map(val, fromLow, fromHigh, toLow, toHigh)
+  // Read food level, timeout (jarak 0) dilewati, bukan dianggap wadah kosong
+  float foodDistance = foodSensor.getDistanceCM();
+  if (foodDistance <= 0) return;
+  if (foodDistance > MAX_FOOD_DISTANCE) foodDistance = MAX_FOOD_DISTANCE;
+  bool accepted = foodFilter.add(foodDistance);
+  lastLevelUpdate = millis();
+  currentFoodLevel = distanceToPercent(foodFilter.value(), MAX_FOOD_DISTANCE);
+  // outlier yang ditolak tidak mengubah level, tidak perlu evaluasi alert
+  if (accepted) AlertManager::onSensorReading(ALERT_FOOD, currentFoodLevel);
 }
 
 void Hardware::readWaterSensor(){
   // Read water level
-  int waterDistance = getDistanceCM(TRIG_WATER_PIN, ECHO_WATER_PIN);
-  if (waterDistance <= 0 || waterDistance > MAX_WATER_DISTANCE) waterDistance = MAX_WATER_DISTANCE;
-  currentWaterLevel = map(waterDistance, MAX_WATER_DISTANCE, MIN_DISTANCE, 0, 100);
-  currentWaterLevel = constrain(currentWaterLevel, 0, 100);
+  float waterDistance = waterSensor.getDistanceCM();
+  if (waterDistance <= 0) return;
+  if (waterDistance > MAX_WATER_DISTANCE) waterDistance = MAX_WATER_DISTANCE;
+  bool accepted = waterFilter.add(waterDistance);
+  lastLevelUpdate = millis();
+  currentWaterLevel = distanceToPercent(waterFilter.value(), MAX_WATER_DISTANCE);
+  if (accepted) AlertManager::onSensorReading(ALERT_WATER, currentWaterLevel);
 }
 
   // Feed
@@ -112,9 +200,9 @@ bool Hardware::feedHamster() {
 
   Serial.println("Feeding hamster...");
   displayMessage("Feeding hamster...");
-  feedServo.write(SERVO_FEED_ANGLE);
+  Hal::servoWrite(SERVO_FEED_ANGLE);
   delay(1000);
-  feedServo.write(SERVO_CLOSE_ANGLE);
+  Hal::servoWrite(SERVO_CLOSE_ANGLE);
   delay(500);
   return true;
 }
@@ -122,43 +210,108 @@ bool Hardware::feedHamster() {
   //print message ke display oled
 void Hardware::displayMessage(String message) { 
   int line = 10;  //debugging 10 line
-  display.clearDisplay();
-  display.setCursor(0, line);
-  display.print(message);
-  display.display();
+  Hal::displayClear();
+  Hal::displayText(0, line, message.c_str());
+  Hal::displayShow();
+  countDisplayBytes(SCREEN_WIDTH * SCREEN_HEIGHT / 8);
+  displayCacheValid = false;  // layar status harus digambar ulang penuh
+}
+
+  // panel OLED tetap menyala saat ESP deep sleep, matikan manual
+void Hardware::sleepDisplay() {
+  Hal::displayOff();
 }
 
-  //update semua status hardware 
+  //update semua status hardware, hanya baris yang berubah yang dikirim
 void Hardware::updateDisplay() {
-  display.clearDisplay();
-  display.setCursor(0, 0);
-  display.print("Bat: ");
-  display.print(currentBatteryVolt, 2);
-  display.print("V (");
-  display.print(currentBatteryPercent, 0);
-  display.println("%)");
-  
-  display.setCursor(0, 16);
-  display.print("Food: ");
-  display.print(currentFoodLevel);
-  display.println("%");
-  
-  display.setCursor(0, 32);
-  display.print("Water: ");
-  display.print(currentWaterLevel);
-  display.println("%");
-  
-  display.setCursor(0, 48);
-  display.print("WiFi: ");
-  display.print(WiFi.status() == WL_CONNECTED ? "OK" : "ERROR");
-  
-  display.display();
+  PROFILE_SCOPE(PROFILE_DISPLAY);
+  char line[DISPLAY_LINE_CHARS + 1];
+
+  if (!displayCacheValid) {
+    Hal::displayClear();
+    for (int row = 0; row < DISPLAY_ROWS; row++) displayCache[row][0] = '\0';
+    dirtyPages = 0xFF;
+    displayCacheValid = true;
+  }
+
+  snprintf(line, sizeof(line), "Bat: %.2fV (%.0f%%)", currentBatteryVolt, currentBatteryPercent);
+  drawRow(0, line);
+  snprintf(line, sizeof(line), "Food: %d%%", currentFoodLevel);
+  drawRow(1, line);
+  snprintf(line, sizeof(line), "Water: %d%%", currentWaterLevel);
+  drawRow(2, line);
+  snprintf(line, sizeof(line), "WiFi: %s", WiFi.status() == WL_CONNECTED ? "OK" : "ERROR");
+  drawRow(3, line);
+
+  flushDisplay();
+}
+
+  // gambar satu baris (y = row * 16) jika teksnya berbeda dari cache
+void Hardware::drawRow(int row, const char* text) {
+  if (strcmp(displayCache[row], text) == 0) return;
+
+  int y = row * 16;
+  Hal::displayClearRect(0, y, SCREEN_WIDTH, 8);
+  Hal::displayText(0, y, text);
+
+  strncpy(displayCache[row], text, DISPLAY_LINE_CHARS);
+  displayCache[row][DISPLAY_LINE_CHARS] = '\0';
+  dirtyPages |= 1 << (y / 8);
+}
+
+  // kirim hanya page SSD1306 yang kotor, lewati I2C jika tidak ada perubahan
+void Hardware::flushDisplay() {
+  if (dirtyPages == 0) {
+    displaySkippedFrames++;
+    return;
+  }
+
+  uint8_t pages = SCREEN_HEIGHT / 8;
+  uint8_t page = 0;
+  while (page < pages) {
+    if (!(dirtyPages & (1 << page))) {
+      page++;
+      continue;
+    }
+    uint8_t first = page;
+    while (page + 1 < pages && (dirtyPages & (1 << (page + 1)))) page++;
+    pushPages(first, page);
+    page++;
+  }
+  dirtyPages = 0;
+}
+
+void Hardware::pushPages(uint8_t firstPage, uint8_t lastPage) {
+  Hal::displayPushPages(firstPage, lastPage);
+  countDisplayBytes((lastPage - firstPage + 1) * SCREEN_WIDTH);
+}
+
+void Hardware::countDisplayBytes(unsigned long bytes) {
+  unsigned long now = millis();
+  if (now - displayMinuteStart >= 60000) {
+    displayBytesLastMinute = displayBytesThisMinute;
+    displayBytesThisMinute = 0;
+    displayMinuteStart = now;
+  }
+  displayBytesThisMinute += bytes;
+  displayBytesTotal += bytes;
 }
 
   // getter
   int Hardware::getFoodLevel() { return currentFoodLevel; }
   int Hardware::getWaterLevel() { return currentWaterLevel; }
+  unsigned long Hardware::getLevelAge() { return (millis() - lastLevelUpdate) / 1000; }
   float Hardware::getBatteryVolt() { return currentBatteryVolt; }
   float Hardware::getBatteryPercent() { return currentBatteryPercent; }
   bool Hardware::isLowBattery() { return currentBatteryPercent < LOW_BATTERY_THRESHOLD; }
-  bool Hardware::isCriticalBattery() { return currentBatteryPercent < CRITICAL_BATTERY_THRESHOLD; }
\ No newline at end of file
+  bool Hardware::isCriticalBattery() { return currentBatteryPercent < CRITICAL_BATTERY_THRESHOLD; }
+  unsigned long Hardware::getReconnectsAvoided() { return reconnectsAvoided; }
+  unsigned long Hardware::getDisplaySkippedFrames() { return displaySkippedFrames; }
+  unsigned long Hardware::getDisplayBytesPerMinute() {
+    unsigned long elapsed = millis() - displayMinuteStart;
+    if (elapsed >= 120000) return 0;                        // menit terakhir tanpa push
+    if (elapsed >= 60000) return displayBytesThisMinute;    // menit berjalan sudah lewat
+    return displayBytesLastMinute;
+  }
+  const UltrasonicSensor& Hardware::getFoodSensor() { return foodSensor; }
+  const UltrasonicSensor& Hardware::getWaterSensor() { return waterSensor; }
\ No newline at end of file
@@ -2,29 +2,56 @@
 #define HARDWARE_H
 
 #include <ESP8266WiFi.h> 
-#include <Wire.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include <Servo.h>  
 #include "config.h" 
+#include "hal.h"
+#include "ultrasonicSensor.h"
+#include "sensorFilter.h"
 #include "credential.h" 
 
 class Hardware {
 private:
-  //objek tiap hardware
-  static Adafruit_SSD1306 display;
-  static Servo feedServo;
-  static int getDistanceCM(int trigPin, int echoPin);
+  //objek tiap hardware (OLED & servo lewat Hal)
+  static char displayCache[DISPLAY_ROWS][DISPLAY_LINE_CHARS + 1];
+  static bool displayCacheValid;
+  static uint8_t dirtyPages;
+  static unsigned long displayBytesTotal;
+  static unsigned long displayBytesThisMinute;
+  static unsigned long displayBytesLastMinute;
+  static unsigned long displayMinuteStart;
+  static unsigned long displaySkippedFrames;
+  static void drawRow(int row, const char* text);
+  static void flushDisplay();
+  static void pushPages(uint8_t firstPage, uint8_t lastPage);
+  static void countDisplayBytes(unsigned long bytes);
+  static UltrasonicSensor foodSensor;
+  static UltrasonicSensor waterSensor;
+  static SensorFilter<FILTER_MEDIAN_SIZE> foodFilter;
+  static SensorFilter<FILTER_MEDIAN_SIZE> waterFilter;
+  static SensorFilter<FILTER_MEDIAN_SIZE> batteryFilter;
+  static void foodEchoISR();
+  static void waterEchoISR();
+  static int sampleBatteryADC();
+  static int distanceToPercent(float distance, float maxDistance);
   
   //variabel hardware dan baterai
   static int currentFoodLevel;
   static int currentWaterLevel;
   static float currentBatteryVolt;
   static float currentBatteryPercent;
+  static bool batteryPending;
+  static unsigned long lastLevelUpdate;
+  static unsigned long lastBatterySample;
+  static unsigned long lastRadioActivity;
+  static unsigned long reconnectsAvoided;
 
 public:
-  static void init();
+  static void init(bool showSplash = true);
   static void readAllSensors();
+  static void updateSensors();
+  static bool isRanging();
+  static bool isMeasuring();
+  static unsigned long getBatteryRetryDelay();
+  static void notifyRadioActivity();
   static void readAnalogVoltage();
   static void readFoodSensor();
   static void readWaterSensor();
@@ -34,13 +61,20 @@ public:
   // Getters
   static int getFoodLevel();
   static int getWaterLevel();
+  static unsigned long getLevelAge();   // detik sejak bacaan ultrasonik terakhir
   static float getBatteryVolt();
   static float getBatteryPercent();
   static bool isLowBattery();
   static bool isCriticalBattery();
+  static unsigned long getReconnectsAvoided();
+  static unsigned long getDisplayBytesPerMinute();
+  static unsigned long getDisplaySkippedFrames();
+  static const UltrasonicSensor& getFoodSensor();
+  static const UltrasonicSensor& getWaterSensor();
   
   // Display functions
   static void displayMessage(String message);
+  static void sleepDisplay();
   static void displayStatus();
 };
 
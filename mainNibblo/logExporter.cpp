@@ -0,0 +1,185 @@
+#include "logExporter.h"
+#include "dataLogger.h"
+#include "lzssEncoder.h"
+#include "timeManager.h"
+
+#define EXPORT_EPILOGUE "\r\n--" EXPORT_BOUNDARY "--\r\n"
+
+ExportState LogExporter::state = EXPORT_IDLE;
+char LogExporter::chatId[TELEGRAM_CHAT_ID_SIZE] = "";
+int LogExporter::sampleCount = 0;
+int LogExporter::totalFeeds = 0;
+unsigned long LogExporter::exportEpoch = 0;
+
+int LogExporter::row = 0;
+unsigned long LogExporter::rowEpoch = 0;
+char LogExporter::line[EXPORT_LINE_SIZE];
+size_t LogExporter::lineLength = 0;
+size_t LogExporter::linePosition = 0;
+uint32_t LogExporter::rawLength = 0;
+
+char LogExporter::prologue[EXPORT_PROLOGUE_SIZE];
+size_t LogExporter::prologueLength = 0;
+uint8_t LogExporter::fileHeader[12];
+uint32_t LogExporter::compressedLength = 0;
+ExportPart LogExporter::part = PART_DONE;
+size_t LogExporter::partSent = 0;
+
+  // Riwayat dibekukan sampai finish() supaya kedua pass identik
+bool LogExporter::begin(const char* chat_id) {
+  if (state != EXPORT_IDLE) return false;
+
+  strncpy(chatId, chat_id, sizeof(chatId) - 1);
+  chatId[sizeof(chatId) - 1] = '\0';
+  DataLogger::setHistoryFrozen(true);
+  sampleCount = DataLogger::getHistoryCount();
+  totalFeeds = DataLogger::getTotalFeeds();
+  exportEpoch = TimeManager::getEpoch();
+
+  int written = snprintf(prologue, sizeof(prologue),
+                         "--" EXPORT_BOUNDARY "\r\n"
+                         "Content-Disposition: form-data; name=\"chat_id\"\r\n\r\n"
+                         "%s\r\n"
+                         "--" EXPORT_BOUNDARY "\r\n"
+                         "Content-Disposition: form-data; name=\"caption\"\r\n\r\n"
+                         "📦 Nibblo log: %d samples, %d feeds\r\n"
+                         "--" EXPORT_BOUNDARY "\r\n"
+                         "Content-Disposition: form-data; name=\"document\"; filename=\"nibblo_%lu.nbz\"\r\n"
+                         "Content-Type: application/octet-stream\r\n\r\n",
+                         chatId, sampleCount, totalFeeds, exportEpoch);
+  if (written < 0 || (size_t)written >= sizeof(prologue)) {
+    Serial.println("❌ Export header too long");
+    DataLogger::setHistoryFrozen(false);
+    return false;
+  }
+  prologueLength = written;
+
+  rewind();
+  compressedLength = 0;
+  state = EXPORT_MEASURING;
+  return true;
+}
+
+void LogExporter::rewind() {
+  row = -2;
+  rowEpoch = DataLogger::getOldestEpoch();
+  lineLength = 0;
+  linePosition = 0;
+  rawLength = 0;
+  LzssEncoder::begin(nextCsvByte);
+}
+
+  // Pass 1, bertahap: kompres tanpa menyimpan hasilnya, hanya dihitung
+void LogExporter::measureStep() {
+  if (state != EXPORT_MEASURING) return;
+
+  unsigned long start = millis();
+  uint8_t buffer[64];
+  while (millis() - start < TELEGRAM_STEP_BUDGET) {
+    size_t count = LzssEncoder::read(buffer, sizeof(buffer));
+    compressedLength += count;
+    if (count > 0) continue;
+
+    // parameter LZSS ikut di header: dekoder tidak perlu menyalin config.h
+    memcpy(fileHeader, "NBZ2", 4);
+    for (int i = 0; i < 4; i++) fileHeader[4 + i] = rawLength >> (8 * i);
+    fileHeader[8] = LZSS_WINDOW_BITS;
+    fileHeader[9] = LZSS_LENGTH_BITS;
+    fileHeader[10] = LZSS_MIN_MATCH;
+    fileHeader[11] = 0;
+    Serial.printf("📦 Export ready: %lu -> %lu bytes\n",
+                  (unsigned long)rawLength, (unsigned long)compressedLength);
+    state = EXPORT_READY;
+    return;
+  }
+}
+
+  // Pass 2: dipanggil tepat sebelum TelegramClient::beginUpload()
+void LogExporter::startUpload() {
+  rewind();
+  part = PART_PROLOGUE;
+  partSent = 0;
+  state = EXPORT_UPLOADING;
+}
+
+  // BodySource untuk TelegramClient: prologue, header file, data LZSS, epilogue
+size_t LogExporter::readBody(uint8_t* buffer, size_t size) {
+  size_t count = 0;
+  while (count < size && part != PART_DONE) {
+    size_t copied = 0;
+    switch (part) {
+      case PART_PROLOGUE:
+        copied = copyPart((const uint8_t*)prologue, prologueLength, buffer + count, size - count);
+        break;
+      case PART_HEADER:
+        copied = copyPart(fileHeader, sizeof(fileHeader), buffer + count, size - count);
+        break;
+      case PART_DATA:
+        copied = LzssEncoder::read(buffer + count, size - count);
+        if (copied == 0) part = PART_EPILOGUE;
+        break;
+      case PART_EPILOGUE:
+        copied = copyPart((const uint8_t*)EXPORT_EPILOGUE, strlen(EXPORT_EPILOGUE), buffer + count, size - count);
+        break;
+      default:
+        break;
+    }
+    count += copied;
+  }
+  return count;
+}
+
+  // salin sisa bagian tetap; pindah ke bagian berikutnya jika sudah habis
+size_t LogExporter::copyPart(const uint8_t* data, size_t length, uint8_t* buffer, size_t size) {
+  size_t copied = min(size, length - partSent);
+  memcpy(buffer, data + partSent, copied);
+  partSent += copied;
+  if (partSent == length) {
+    part = (ExportPart)(part + 1);
+    partSent = 0;
+  }
+  return copied;
+}
+
+int LogExporter::nextCsvByte() {
+  if (linePosition == lineLength && !formatLine()) return -1;
+  rawLength++;
+  return (uint8_t)line[linePosition++];
+}
+
+bool LogExporter::formatLine() {
+  if (row >= sampleCount) return false;
+
+  int written;
+  if (row == -2) {
+    written = snprintf(line, sizeof(line), "# nibblo %lu feeds=%d tz=%+d\n",
+                       exportEpoch, totalFeeds, TIME_ZONE);
+  } else if (row == -1) {
+    written = snprintf(line, sizeof(line), "epoch,food,water,battery_mv,event\n");
+  } else {
+    const HistorySample& sample = DataLogger::getSample(row);
+    if (row > 0) rowEpoch += sample.timeDelta;
+    const char* event = !sample.feedEvent ? "" : (sample.autoFeed ? "feed_auto" : "feed_manual");
+    written = snprintf(line, sizeof(line), "%lu,%u,%u,%u,%s\n", rowEpoch,
+                       sample.foodLevel, sample.waterLevel, sample.batteryMilliVolt, event);
+  }
+  row++;
+  lineLength = constrain(written, 0, (int)sizeof(line) - 1);
+  linePosition = 0;
+  return true;
+}
+
+void LogExporter::finish() {
+  DataLogger::setHistoryFrozen(false);
+  state = EXPORT_IDLE;
+}
+
+bool LogExporter::isIdle() { return state == EXPORT_IDLE; }
+bool LogExporter::isMeasuring() { return state == EXPORT_MEASURING; }
+bool LogExporter::isReady() { return state == EXPORT_READY; }
+const char* LogExporter::getChatId() { return chatId; }
+const char* LogExporter::getContentType() { return "multipart/form-data; boundary=" EXPORT_BOUNDARY; }
+
+size_t LogExporter::getContentLength() {
+  return prologueLength + sizeof(fileHeader) + compressedLength + strlen(EXPORT_EPILOGUE);
+}
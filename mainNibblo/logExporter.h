@@ -0,0 +1,72 @@
+#ifndef LOG_EXPORTER_H
+#define LOG_EXPORTER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+enum ExportState {
+  EXPORT_IDLE,
+  EXPORT_MEASURING,       // pass 1: hitung ukuran hasil kompresi
+  EXPORT_READY,           // menunggu TelegramClient bebas
+  EXPORT_UPLOADING        // pass 2: body multipart dibaca TelegramClient
+};
+
+enum ExportPart {
+  PART_PROLOGUE,
+  PART_HEADER,
+  PART_DATA,
+  PART_EPILOGUE,
+  PART_DONE
+};
+
+// Ekspor riwayat sensor & feed (/export) sebagai dokumen Telegram.
+// Riwayat di DataLogger diubah jadi CSV baris per baris, dikompres LZSS
+// secara streaming, lalu dibungkus multipart/form-data sendDocument.
+// Tidak ada yang disimpan utuh di RAM: pass pertama hanya menghitung
+// panjang (Content-Length), pass kedua membangkitkan ulang byte yang sama
+// saat upload. File .nbz dibuka dengan tools/exportDecoder.
+class LogExporter {
+private:
+  static ExportState state;
+  static char chatId[TELEGRAM_CHAT_ID_SIZE];
+  static int sampleCount;         // snapshot saat begin()
+  static int totalFeeds;
+  static unsigned long exportEpoch;
+
+  // generator CSV
+  static int row;                 // -2 komentar, -1 nama kolom, >= 0 sampel
+  static unsigned long rowEpoch;
+  static char line[EXPORT_LINE_SIZE];
+  static size_t lineLength;
+  static size_t linePosition;
+  static uint32_t rawLength;
+
+  // body multipart
+  static char prologue[EXPORT_PROLOGUE_SIZE];
+  static size_t prologueLength;
+  static uint8_t fileHeader[12];  // "NBZ2", panjang CSV (uint32 LE), parameter LZSS
+  static uint32_t compressedLength;
+  static ExportPart part;
+  static size_t partSent;
+
+  static void rewind();
+  static int nextCsvByte();
+  static bool formatLine();
+  static size_t copyPart(const uint8_t* data, size_t length, uint8_t* buffer, size_t size);
+
+public:
+  static bool begin(const char* chat_id);
+  static void measureStep();
+  static void startUpload();
+  static size_t readBody(uint8_t* buffer, size_t size);
+  static void finish();
+
+  static bool isIdle();
+  static bool isMeasuring();
+  static bool isReady();
+  static const char* getChatId();
+  static const char* getContentType();
+  static size_t getContentLength();
+};
+
+#endif
\ No newline at end of file
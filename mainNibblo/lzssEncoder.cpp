@@ -0,0 +1,99 @@
+#include "lzssEncoder.h"
+
+static_assert(LZSS_WINDOW_BITS + LZSS_LENGTH_BITS == 16, "match token must be 2 bytes");
+
+ByteSource LzssEncoder::source = NULL;
+uint8_t LzssEncoder::window[2 * LZSS_WINDOW];
+size_t LzssEncoder::position = 0;
+size_t LzssEncoder::filled = 0;
+bool LzssEncoder::inputDone = true;
+uint8_t LzssEncoder::group[LZSS_GROUP_SIZE];
+size_t LzssEncoder::groupLength = 0;
+size_t LzssEncoder::groupSent = 0;
+
+void LzssEncoder::begin(ByteSource input) {
+  source = input;
+  position = 0;
+  filled = 0;
+  inputDone = false;
+  groupLength = 0;
+  groupSent = 0;
+}
+
+  // Output terkompresi berikutnya, maksimal size byte; 0 = stream selesai
+size_t LzssEncoder::read(uint8_t* buffer, size_t size) {
+  size_t count = 0;
+  while (count < size) {
+    if (groupSent == groupLength && !encodeGroup()) break;
+    size_t chunk = min(size - count, groupLength - groupSent);
+    memcpy(buffer + count, group + groupSent, chunk);
+    groupSent += chunk;
+    count += chunk;
+  }
+  return count;
+}
+
+  // Pastikan LZSS_MAX_MATCH byte di depan position tersedia (kecuali input habis).
+  // Jika buffer penuh, window digeser setengah; history LZSS_WINDOW byte tetap ada.
+void LzssEncoder::fillLookahead() {
+  while (!inputDone && filled < position + LZSS_MAX_MATCH) {
+    if (filled == sizeof(window)) {
+      memmove(window, window + LZSS_WINDOW, LZSS_WINDOW);
+      position -= LZSS_WINDOW;
+      filled -= LZSS_WINDOW;
+    }
+    int c = source();
+    if (c < 0) inputDone = true;
+    else window[filled++] = c;
+  }
+}
+
+  // Pencarian linear di window; cukup cepat untuk log beberapa puluh KB
+  // karena dijalankan bertahap per step
+size_t LzssEncoder::findMatch(size_t& offset) {
+  size_t maxLength = min((size_t)LZSS_MAX_MATCH, filled - position);
+  size_t best = 0;
+  size_t start = position > LZSS_WINDOW ? position - LZSS_WINDOW : 0;
+
+  for (size_t candidate = start; candidate < position; candidate++) {
+    if (window[candidate] != window[position]) continue;
+    size_t length = 1;
+    while (length < maxLength && window[candidate + length] == window[position + length]) length++;
+    if (length >= best) {     // >= : offset terdekat menang
+      best = length;
+      offset = position - candidate;
+      if (best == maxLength) break;
+    }
+  }
+  return best;
+}
+
+  // Kodekan sampai 8 token ke group[]; false jika input sudah habis
+bool LzssEncoder::encodeGroup() {
+  group[0] = 0;
+  groupLength = 1;
+  groupSent = 0;
+
+  for (int token = 0; token < 8; token++) {
+    fillLookahead();
+    if (position == filled) break;
+
+    size_t offset = 0;
+    size_t length = findMatch(offset);
+    if (length >= LZSS_MIN_MATCH) {
+      uint16_t code = (offset - 1) | ((length - LZSS_MIN_MATCH) << LZSS_WINDOW_BITS);
+      group[groupLength++] = code & 0xFF;
+      group[groupLength++] = code >> 8;
+      position += length;
+    } else {
+      group[0] |= 1 << token;
+      group[groupLength++] = window[position++];
+    }
+  }
+
+  if (groupLength == 1) {
+    groupLength = 0;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,40 @@
+#ifndef LZSS_ENCODER_H
+#define LZSS_ENCODER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define LZSS_WINDOW (1 << LZSS_WINDOW_BITS)
+#define LZSS_MAX_MATCH (LZSS_MIN_MATCH + (1 << LZSS_LENGTH_BITS) - 1)
+#define LZSS_GROUP_SIZE 17          // 1 byte flag + 8 token x maks 2 byte
+
+// Sumber byte yang akan dikompres; return -1 jika habis
+typedef int (*ByteSource)();
+
+// Kompresor LZSS streaming dengan window tetap (tanpa heap). Input ditarik
+// dari ByteSource sedikit demi sedikit, output dibaca lewat read() sampai
+// return 0. Format (dibaca tools/exportDecoder):
+//   flag byte, bit 0 dulu, untuk 8 token berikutnya: 1 = literal (1 byte),
+//   0 = match (2 byte little endian: offset-1 di LZSS_WINDOW_BITS bit bawah,
+//   panjang-LZSS_MIN_MATCH di LZSS_LENGTH_BITS bit atas).
+class LzssEncoder {
+private:
+  static ByteSource source;
+  static uint8_t window[2 * LZSS_WINDOW];   // [history | lookahead], digeser per LZSS_WINDOW
+  static size_t position;                   // byte berikutnya yang dikodekan
+  static size_t filled;
+  static bool inputDone;
+  static uint8_t group[LZSS_GROUP_SIZE];
+  static size_t groupLength;
+  static size_t groupSent;
+
+  static void fillLookahead();
+  static size_t findMatch(size_t& offset);
+  static bool encodeGroup();
+
+public:
+  static void begin(ByteSource input);
+  static size_t read(uint8_t* buffer, size_t size);
+};
+
+#endif
\ No newline at end of file
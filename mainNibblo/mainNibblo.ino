@@ -5,93 +5,106 @@
 #include "alertManager.h"
 #include "dataLogger.h"
 #include "telegramHandler.h"
-
-// Global variables
-unsigned long lastTimeUpdate = 0;
-unsigned long lastBotCheck = 0;
-unsigned long lastSensorRead = 0;
-unsigned long lastDisplayUpdate = 0;
-unsigned long lastAlertCheck = 0;
+#include "scheduler.h"
+#include "recordStore.h"
+#include "hal.h"
+#include "profiler.h"
+#include "memoryMonitor.h"
 
 // System status variables
 bool systemInitialized = false;
 unsigned long bootTime = 0;
+unsigned long bootPhaseStart = 0;
 
 void setup() {
   Serial.begin(115200);
-  delay(1000);
   
-  Serial.println("\n" + String('=', 50));
-  Serial.println("🐹 HAMSTER FEEDER SYSTEM v2.0");
-  Serial.println("🚀 Booting up...");
-  Serial.println(String('=', 50));
+  // State dari RTC memory dibaca paling awal: menentukan jalur boot
+  PowerManager::init();
+  bool fastResume = PowerManager::isWakeFromSleep();
+  
+  if (!fastResume) {
+    delay(1000);
+    Serial.println("\n" + String('=', 50));
+    Serial.println("🐹 HAMSTER FEEDER SYSTEM v2.0");
+    Serial.println("🚀 Booting up...");
+    Serial.println(String('=', 50));
+  }
   
   bootTime = millis();
+  bootPhaseStart = bootTime;
   
   // Initialize modules in order
   if (!initializeSystem()) {
     Serial.println("❌ SYSTEM INITIALIZATION FAILED!");
     Serial.println("🔄 Restarting in 10 seconds...");
     delay(10000);
-    ESP.restart();
+    Hal::restart();
   }
   
   systemInitialized = true;
   unsigned long initTime = millis() - bootTime;
   
+  // bangun terjadwal: tidak perlu banner & notifikasi startup tiap siklus
+  if (fastResume) {
+    Serial.printf("⚡ Fast resume: %lu ms (%lu ms since reset)\n", initTime, millis());
+    return;
+  }
+  
   Serial.println(String('=', 50));
   Serial.println("✅ ALL SYSTEMS READY!");
   Serial.printf("⚡ Boot time: %lu ms\n", initTime);
-  Serial.printf("💾 Free memory: %u bytes\n", ESP.getFreeHeap());
+  Serial.printf("💾 Free memory: %u bytes\n", Hal::getFreeHeap());
   Serial.println("🌐 IP: " + WiFi.localIP().toString());
   Serial.println(String('=', 50));
   
   // Send startup notification
   TelegramHandler::sendStartupNotification();
-  TelegramHandler::sendDebugInfo("System booted in " + String(initTime) + "ms");
+  TelegramHandler::sendDebugInfo("System booted in %lums", initTime);
 }
 
 bool initializeSystem() {
   // Hardware initialization
   Serial.print("🔧 Initializing hardware... ");
-  Hardware::init();
+  Hardware::init(!PowerManager::isWakeFromSleep());
   Serial.println("✅");
+  logBootPhase("hardware");
   
-  // Power management
-  Serial.print("⚡ Initializing power manager... ");
-  PowerManager::init();
-  Serial.println("✅");
+  // Persistent storage (jadwal & total feed), sebelum modul yang memakainya
+  Serial.print("💾 Mounting record store... ");
+  Serial.println(RecordStore::init() ? "✅" : "❌");
+  MemoryMonitor::init();
+#if PROFILER_ENABLED
+  Profiler::init();
+#endif
+  logBootPhase("store");
   
   // WiFi connection with timeout
   Serial.print("📶 Connecting to WiFi... ");
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-  
-  int wifiAttempts = 0;
-  while (WiFi.status() != WL_CONNECTED && wifiAttempts < 30) {
-    delay(1000);
-    Serial.print(".");
-    wifiAttempts++;
-    
-    if (wifiAttempts % 10 == 0) {
-      Hardware::displayMessage("WiFi: " + String(wifiAttempts) + "/30");
-    }
-  }
-  
-  if (WiFi.status() != WL_CONNECTED) {
+  if (connectWiFi()) {
+    Serial.println(" ✅");
+    Serial.println("   📶 SSID: " + WiFi.SSID());
+    Serial.println("   🌐 IP: " + WiFi.localIP().toString());
+    Serial.println("   📶 RSSI: " + String(WiFi.RSSI()) + " dBm");
+  } else if (PowerManager::canRunOffline()) {
+    // bangun terjadwal: lanjut offline dengan jam dari RTC, tidur lagi seperti biasa
+    Serial.println(" ❌ offline");
+    Hardware::displayMessage("WiFi offline");
+  } else {
     Serial.println(" ❌ FAILED");
     Hardware::displayMessage("WiFi Failed!");
     return false;
   }
-  Serial.println(" ✅");
-  Serial.println("   📶 SSID: " + WiFi.SSID());
-  Serial.println("   🌐 IP: " + WiFi.localIP().toString());
-  Serial.println("   📶 RSSI: " + String(WiFi.RSSI()) + " dBm");
+  logBootPhase("wifi");
   
-  // Time manager
+  // Time manager (NTP dilewati jika jam dipulihkan dari RTC memory)
   Serial.print("🕐 Initializing time manager... ");
   TimeManager::init();
   Serial.println("✅");
-  Serial.println("   🕐 Current time: " + TimeManager::getCurrentTimeString());
+  char timeStr[20];
+  TimeManager::getCurrentTimeString(timeStr, sizeof(timeStr));
+  Serial.printf("   🕐 Current time: %s\n", timeStr);
+  logBootPhase("time");
   
   // Alert manager
   Serial.print("🚨 Initializing alert manager... ");
@@ -103,108 +116,139 @@ bool initializeSystem() {
   DataLogger::init();
   Serial.println("✅");
   Serial.println("   📈 Total feeds: " + String(DataLogger::getTotalFeeds()));
+  logBootPhase("logger");
   
   // Telegram handler
   Serial.print("📱 Initializing Telegram handler... ");
   TelegramHandler::init();
   Serial.println("✅");
+  logBootPhase("telegram");
   
   // Initial sensor reading
   Serial.print("📡 Reading initial sensors... ");
   Hardware::readAllSensors();
+  while (Hardware::isMeasuring()) {  // saat boot boleh ditunggu sampai selesai
+    delay(ULTRASONIC_POLL_INTERVAL);
+    Hardware::updateSensors();
+  }
   Serial.println("✅");
   Serial.printf("   🔋 Battery: %.1fV (%.0f%%)\n", 
                 Hardware::getBatteryVolt(), Hardware::getBatteryPercent());
   Serial.printf("   🍽 Food: %d%%\n", Hardware::getFoodLevel());
   Serial.printf("   💧 Water: %d%%\n", Hardware::getWaterLevel());
+  logBootPhase("sensors");
+  
+  registerTasks();
   
   return true;
 }
 
-void loop() {
-  if (!systemInitialized) {
-    delay(1000);
-    return;
-  }
-  
-  unsigned long currentTime = millis();
+bool connectWiFi() {
+  WiFi.persistent(false);  // kredensial tidak ditulis ulang ke flash tiap boot
+  WiFi.mode(WIFI_STA);
   
-  // Handle potential millis() overflow (every ~49 days)
-  if (currentTime < lastTimeUpdate) {
-    resetTimers();
-  }
-  
-  // 1. Time management (every minute)
-  if (currentTime - lastTimeUpdate >= TIME_UPDATE_INTERVAL) {
-    TimeManager::update();
-    lastTimeUpdate = currentTime;
+  // Bangun dari deep sleep: langsung ke AP terakhir, tanpa scan dan DHCP
+  if (PowerManager::beginFastConnect()) {
+    unsigned long start = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start < WIFI_FAST_CONNECT_TIMEOUT) {
+      delay(10);
+    }
+    if (WiFi.status() == WL_CONNECTED) return true;
+    Serial.print("fast connect failed, scanning ");
+    PowerManager::forgetNetwork();
   }
   
-  // 2. Telegram bot communication (every 5 seconds)
-  if (currentTime - lastBotCheck >= BOT_CHECK_INTERVAL) {
-    TelegramHandler::checkMessages();
-    lastBotCheck = currentTime;
-  }
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
   
-  // 3. Sensor readings (every 5 seconds)
-  if (currentTime - lastSensorRead >= SENSOR_READ_INTERVAL) {
-    Hardware::readAllSensors();
-    lastSensorRead = currentTime;
+  int maxAttempts = PowerManager::getConnectAttempts();
+  int wifiAttempts = 0;
+  while (WiFi.status() != WL_CONNECTED && wifiAttempts < maxAttempts) {
+    delay(1000);
+    Serial.print(".");
+    wifiAttempts++;
     
-    // Send debug info periodically (every 5 minutes)
-    static unsigned long lastDebugSend = 0;
-    if (currentTime - lastDebugSend >= 300000) {
-      TelegramHandler::sendDebugInfo(
-        "Sensors - F:" + String(Hardware::getFoodLevel()) + 
-        "% W:" + String(Hardware::getWaterLevel()) + 
-        "% B:" + String(Hardware::getBatteryPercent(), 0) + "%"
-      );
-      lastDebugSend = currentTime;
+    if (wifiAttempts % 10 == 0) {
+      Hardware::displayMessage("WiFi: " + String(wifiAttempts) + "/" + String(maxAttempts));
     }
   }
-  
-  // 4. Display updates (every 2 seconds)
-  if (currentTime - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL) {
-    Hardware::updateDisplay();
-    lastDisplayUpdate = currentTime;
+  return WiFi.status() == WL_CONNECTED;
+}
+
+  // Lama tiap fase boot, supaya jalur fast resume bisa diukur
+void logBootPhase(const char* phase) {
+  unsigned long now = millis();
+  Serial.printf("   ⏱ %s: %lu ms\n", phase, now - bootPhaseStart);
+  bootPhaseStart = now;
+}
+
+void registerTasks() {
+  // name, callback, period, deadline, priority (0 = tertinggi)
+  Scheduler::addTask("feed", feedTask, FEED_CHECK_INTERVAL, 5000, 0);
+  Scheduler::addTask("telegram", telegramTask, BOT_CHECK_INTERVAL, BOT_CHECK_INTERVAL, 1);
+  Scheduler::addTask("sensors", sensorTask, SENSOR_READ_INTERVAL, 1000, 2);
+  Scheduler::addTask("power", PowerManager::checkPowerStatus, POWER_CHECK_INTERVAL, 5000, 2);
+  Scheduler::addTask("display", Hardware::updateDisplay, DISPLAY_UPDATE_INTERVAL, 500, 3);
+  Scheduler::addTask("time", TimeManager::update, TIME_UPDATE_INTERVAL, 10000, 4);
+  Scheduler::addTask("datalog", DataLogger::logPeriodicData, DATA_LOG_CHECK_INTERVAL, 10000, 4);
+  Scheduler::addTask("health", checkSystemHealth, HEALTH_CHECK_INTERVAL, 10000, 5);
+  Scheduler::addTask("memory", MemoryMonitor::update, MEM_SAMPLE_INTERVAL, 10000, 5);
+  Scheduler::addTask("debug", sendSensorDebugInfo, DEBUG_INFO_INTERVAL, 10000, 6);
+}
+
+void loop() {
+  if (!systemInitialized) {
+    delay(1000);
+    return;
   }
   
-  // 5. Alert checking (every 30 seconds)
-  if (currentTime - lastAlertCheck >= ALERT_CHECK_INTERVAL) {
-    AlertManager::checkAlerts();
-    lastAlertCheck = currentTime;
+  // Semua pekerjaan periodik diatur Scheduler (lihat registerTasks()).
+  // Loop tidur sampai task berikutnya jatuh tempo, bukan polling tiap 50 ms.
+  {
+    PROFILE_SCOPE(PROFILE_LOOP);
+    Scheduler::run();
   }
-  
-  // 6. Core system functions (run every loop with internal timing)
+  Scheduler::sleepUntilNextTask();
+}
+
+void feedTask() {
+  // Task tidur sampai deadline jadwal berikutnya (maks FEED_MAX_SLEEP)
   TimeManager::checkAutoFeedSchedule();
-  PowerManager::checkPowerStatus();
-  DataLogger::logPeriodicData();
-  
-  // 7. Watchdog and system health
-  checkSystemHealth();
-  
-  // Small delay to prevent excessive CPU usage
-  delay(50);
+  Scheduler::rescheduleCurrent(TimeManager::getTimeUntilNextFeed());
 }
 
-void resetTimers() {
-  unsigned long now = millis();
-  lastTimeUpdate = now;
-  lastBotCheck = now;
-  lastSensorRead = now;
-  lastDisplayUpdate = now;
-  lastAlertCheck = now;
-  
-  Serial.println("⚠ System timers reset (millis overflow detected)");
-  TelegramHandler::sendDebugInfo("System timers reset - millis overflow");
+void sensorTask() {
+  // Siklus baru tiap SENSOR_READ_INTERVAL; selama ultrasonik masih menunggu
+  // echo task kembali lagi tiap ULTRASONIC_POLL_INTERVAL tanpa memblokir
+  // loop. Baterai yang menunggu radio idle dicek lebih jarang.
+  PROFILE_SCOPE(PROFILE_SENSORS);
+  if (!Hardware::isMeasuring()) {
+    Hardware::readAllSensors();
+  }
+  Hardware::updateSensors();
+  if (Hardware::isRanging()) {
+    Scheduler::rescheduleCurrent(ULTRASONIC_POLL_INTERVAL);
+  } else if (Hardware::isMeasuring()) {
+    Scheduler::rescheduleCurrent(Hardware::getBatteryRetryDelay());
+  }
+}
+
+void telegramTask() {
+  // Request dipecah jadi step kecil; selama request berjalan task kembali
+  // tiap TELEGRAM_STEP_INTERVAL dan task prioritas lebih tinggi tetap jalan.
+  TelegramHandler::checkMessages();
+  Scheduler::rescheduleCurrent(TelegramHandler::getServiceDelay());
+}
+
+void sendSensorDebugInfo() {
+  TelegramHandler::sendDebugInfo("Sensors - F:%d%% W:%d%% B:%.0f%%",
+                                 Hardware::getFoodLevel(),
+                                 Hardware::getWaterLevel(),
+                                 Hardware::getBatteryPercent());
 }
 
 void checkSystemHealth() {
-  static unsigned long lastHealthCheck = 0;
   static int consecutiveWifiFailures = 0;
-  
-  if (millis() - lastHealthCheck < 60000) return; // Check every minute
-  lastHealthCheck = millis();
+  PROFILE_SCOPE(PROFILE_HEALTH);
   
   // Check WiFi health
   if (WiFi.status() != WL_CONNECTED) {
@@ -218,32 +262,47 @@ void checkSystemHealth() {
       delay(1000);
       WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
       
-      if (consecutiveWifiFailures >= 10) {
+      // restart hanya untuk jam yang belum valid: dengan jam valid feed &
+      // log tetap jalan offline, sedangkan cold boot tanpa WiFi tidak punya jam
+      if (consecutiveWifiFailures >= 10 && !TimeManager::isClockValid(TimeManager::getEpoch())) {
         Serial.println("❌ WiFi failed permanently - restarting system");
         TelegramHandler::sendSystemAlert("WiFi failed - system restarting");
-        delay(2000);
-        ESP.restart();
+        TelegramHandler::flushMessages(TELEGRAM_RESPONSE_TIMEOUT);
+        Hal::restart();
       }
     }
   } else {
     if (consecutiveWifiFailures > 0) {
       Serial.println("✅ WiFi reconnected after " + String(consecutiveWifiFailures) + " failures");
-      TelegramHandler::sendDebugInfo("WiFi reconnected after " + String(consecutiveWifiFailures) + " attempts");
+      TelegramHandler::sendDebugInfo("WiFi reconnected after %d attempts", consecutiveWifiFailures);
     }
     consecutiveWifiFailures = 0;
   }
   
   // Check memory health
-  uint32_t freeHeap = ESP.getFreeHeap();
-  if (freeHeap < 5000) { // Less than 5KB free
+  static bool fragmentationReported = false;
+  uint32_t freeHeap = Hal::getFreeHeap();
+  MemoryMonitor::noteHeap(freeHeap);
+  if (freeHeap < MEM_LOW_HEAP) {
     Serial.println("⚠ Low memory: " + String(freeHeap) + " bytes");
-    TelegramHandler::sendSystemAlert("Low memory warning: " + String(freeHeap) + " bytes");
+    TelegramHandler::sendSystemAlert("Low memory warning: %u bytes", freeHeap);
     
-    if (freeHeap < 2000) { // Critical memory
+    if (freeHeap < MEM_CRITICAL_HEAP) {
       Serial.println("❌ Critical memory - forcing restart");
+      // jejak heap disimpan dulu supaya penyebabnya terlihat di /mem setelah restart
+      MemoryMonitor::printStats();
+      MemoryMonitor::prepareSleep();
       TelegramHandler::sendSystemAlert("Critical memory - system restarting");
-      delay(2000);
-      ESP.restart();
+      TelegramHandler::flushMessages(TELEGRAM_RESPONSE_TIMEOUT);
+      Hal::restart();
     }
   }
+  
+  // heap cukup tapi terpecah: alokasi besar (TLS) bisa gagal lebih dulu
+  bool fragmented = MemoryMonitor::isFragmented();
+  if (fragmented && !fragmentationReported) {
+    TelegramHandler::sendSystemAlert("Heap fragmented: largest block %u of %u bytes free",
+                                     Hal::getMaxFreeBlock(), freeHeap);
+  }
+  fragmentationReported = fragmented;
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "memoryMonitor.h"
+#include <LittleFS.h>
+#include "timeManager.h"
+
+static const char* const siteNames[MEM_SITE_COUNT] = {
+  "tg step", "tg command", "tg send", "log feed", "log totals", "log history"
+};
+
+MemoryState MemoryMonitor::state;
+MemorySiteStats MemoryMonitor::sites[MEM_SITE_COUNT];
+
+void MemoryMonitor::init() {
+  memset(&state, 0, sizeof(state));
+  File file = LittleFS.open(MEM_FILE, "r");
+  if (file) {
+    MemoryFileHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != MEM_FILE_MAGIC || header.stateSize != sizeof(state) ||
+        file.read((uint8_t*)&state, sizeof(state)) != sizeof(state) ||
+        state.historyCount > MEM_HISTORY_SIZE || state.historyHead >= MEM_HISTORY_SIZE) {
+      memset(&state, 0, sizeof(state));
+    }
+    file.close();
+  }
+  noteHeap(Hal::getFreeHeap());
+  Serial.printf("✅ Memory monitor initialized (%d samples)\n", state.historyCount);
+}
+
+  // Dipanggil scheduler tiap MEM_SAMPLE_INTERVAL; ring hanya bertambah tiap
+  // MEM_HISTORY_PERIOD detik jam dinding, sehingga bangun singkat dari deep
+  // sleep tidak memenuhi ring dengan sampel yang berdekatan
+void MemoryMonitor::update() {
+  noteHeap(Hal::getFreeHeap());
+  unsigned long epoch = TimeManager::getEpoch();
+  if (!TimeManager::isClockValid(epoch)) return;
+  if (state.historyCount > 0) {
+    int newest = (state.historyHead + state.historyCount - 1) % MEM_HISTORY_SIZE;
+    if (epoch < state.history[newest].epoch + MEM_HISTORY_PERIOD) return;
+  }
+  addSample(epoch);
+}
+
+void MemoryMonitor::addSample(unsigned long epoch) {
+  int index = (state.historyHead + state.historyCount) % MEM_HISTORY_SIZE;
+  if (state.historyCount < MEM_HISTORY_SIZE) {
+    state.historyCount++;
+  } else {
+    state.historyHead = (state.historyHead + 1) % MEM_HISTORY_SIZE;
+  }
+  MemorySample& sample = state.history[index];
+  sample.epoch = epoch;
+  sample.freeHeap = min(Hal::getFreeHeap(), (uint32_t)UINT16_MAX);
+  sample.lowWater = min(state.lowWater, (uint32_t)UINT16_MAX);
+  sample.maxBlock = min(Hal::getMaxFreeBlock(), (uint32_t)UINT16_MAX);
+  sample.fragmentation = Hal::getHeapFragmentation();
+  sample.reserved = 0;
+  state.lowWater = Hal::getFreeHeap();
+}
+
+void MemoryMonitor::prepareSleep() {
+  noteHeap(Hal::getFreeHeap());
+  File file = LittleFS.open(MEM_FILE, "w");
+  if (!file) {
+    Serial.println("❌ Failed to save memory stats");
+    return;
+  }
+  MemoryFileHeader header;
+  header.magic = MEM_FILE_MAGIC;
+  header.stateSize = sizeof(state);
+  file.write((const uint8_t*)&header, sizeof(header));
+  file.write((const uint8_t*)&state, sizeof(state));
+  file.close();
+}
+
+void MemoryMonitor::noteHeap(uint32_t freeHeap) {
+  if (state.lowWater == 0 || freeHeap < state.lowWater) state.lowWater = freeHeap;
+  if (state.lowestEver == 0 || freeHeap < state.lowestEver) state.lowestEver = freeHeap;
+}
+
+void MemoryMonitor::recordSite(MemorySite site, uint32_t freeBefore, uint32_t blockBefore) {
+  uint32_t freeAfter = Hal::getFreeHeap();
+  uint32_t blockAfter = Hal::getMaxFreeBlock();
+  noteHeap(freeAfter);
+
+  MemorySiteStats& stats = sites[site];
+  stats.calls++;
+  int32_t retained = (int32_t)freeBefore - (int32_t)freeAfter;
+  stats.netBytes += retained;
+  if (retained > 0) {
+    stats.retains++;
+    if (retained > stats.worstRetain) stats.worstRetain = min(retained, (int32_t)UINT16_MAX);
+  }
+  if (blockBefore > blockAfter && blockBefore - blockAfter > stats.worstBlockLoss) {
+    stats.worstBlockLoss = min(blockBefore - blockAfter, (uint32_t)UINT16_MAX);
+  }
+}
+
+  // Kemiringan least-squares (B/jam) dari satu field di ring; noise satu
+  // sampel tidak dianggap tren
+float MemoryMonitor::getSlope(uint16_t MemorySample::*field) {
+  if (state.historyCount < 3) return 0;
+  const MemorySample& oldest = state.history[state.historyHead];
+  float sumX = 0, sumY = 0, sumXY = 0, sumXX = 0;
+  for (int i = 0; i < state.historyCount; i++) {
+    const MemorySample& sample = state.history[(state.historyHead + i) % MEM_HISTORY_SIZE];
+    float hours = (sample.epoch - oldest.epoch) / 3600.0;
+    float value = sample.*field;
+    sumX += hours;
+    sumY += value;
+    sumXY += hours * value;
+    sumXX += hours * hours;
+  }
+  float n = state.historyCount;
+  float denominator = n * sumXX - sumX * sumX;
+  if (denominator <= 0) return 0;
+  return (n * sumXY - sumX * sumY) / denominator;
+}
+
+float MemoryMonitor::getLowWaterTrend() {
+  return getSlope(&MemorySample::lowWater);
+}
+
+  // Leak = low-water mark turun konsisten sepanjang ring yang sudah cukup
+  // panjang; reboot harian tidak menutupi tren karena ring disimpan di flash
+bool MemoryMonitor::isLeakSuspected() {
+  return state.historyCount >= MEM_HISTORY_SIZE / 4 && getLowWaterTrend() < -MEM_LEAK_RATE;
+}
+
+bool MemoryMonitor::isFragmented() {
+  return Hal::getMaxFreeBlock() < MEM_MIN_BLOCK && Hal::getFreeHeap() >= MEM_MIN_BLOCK;
+}
+
+void MemoryMonitor::formatReport(MessageBuffer& report) {
+  report.append("💾 Memory\n");
+  report.appendf("Free %u B, block %u B, frag %u%%\n", Hal::getFreeHeap(),
+                 Hal::getMaxFreeBlock(), Hal::getHeapFragmentation());
+  report.appendf("Low-water %lu B, lowest %lu B\n",
+                 (unsigned long)state.lowWater, (unsigned long)state.lowestEver);
+
+  if (state.historyCount >= 2) {
+    const MemorySample& oldest = state.history[state.historyHead];
+    const MemorySample& newest = state.history[(state.historyHead + state.historyCount - 1) % MEM_HISTORY_SIZE];
+    report.appendf("\n📈 Trend %.1f h (%d samples)\n",
+                   (newest.epoch - oldest.epoch) / 3600.0, state.historyCount);
+    report.appendf("Low-water %u → %u B (%+.0f B/h)\n",
+                   oldest.lowWater, newest.lowWater, getLowWaterTrend());
+    report.appendf("Block %u → %u B (%+.0f B/h)\n",
+                   oldest.maxBlock, newest.maxBlock, getSlope(&MemorySample::maxBlock));
+    report.appendf("Frag %u%% → %u%%\n", oldest.fragmentation, newest.fragmentation);
+  }
+  if (isLeakSuspected()) report.append("⚠️ Low-water keeps falling: possible leak\n");
+  if (isFragmented()) report.append("⚠️ Heap fragmented: largest block below MEM_MIN_BLOCK\n");
+
+  report.append("\n📍 Sites since boot (calls/retained/net B/worst B/block loss B):\n");
+  for (int i = 0; i < MEM_SITE_COUNT; i++) {
+    const MemorySiteStats& site = sites[i];
+    if (site.calls == 0) continue;
+    report.appendf("%s: %lu/%lu/%+ld/%u/%u\n", siteNames[i], (unsigned long)site.calls,
+                   (unsigned long)site.retains, (long)site.netBytes, site.worstRetain,
+                   site.worstBlockLoss);
+  }
+}
+
+  // Ring lengkap ke Serial, juga dipanggil sebelum restart karena heap habis
+void MemoryMonitor::printStats() {
+  Serial.printf("=== Memory: free %u, block %u, frag %u%%, lowest %lu ===\n",
+                Hal::getFreeHeap(), Hal::getMaxFreeBlock(), Hal::getHeapFragmentation(),
+                (unsigned long)state.lowestEver);
+  for (int i = 0; i < state.historyCount; i++) {
+    const MemorySample& sample = state.history[(state.historyHead + i) % MEM_HISTORY_SIZE];
+    Serial.printf("  %lu free:%u low:%u block:%u frag:%u%%\n", (unsigned long)sample.epoch,
+                  sample.freeHeap, sample.lowWater, sample.maxBlock, sample.fragmentation);
+  }
+  for (int i = 0; i < MEM_SITE_COUNT; i++) {
+    const MemorySiteStats& site = sites[i];
+    Serial.printf("  %-11s calls:%lu retained:%lu net:%+ld worst:%u blockloss:%u\n", siteNames[i],
+                  (unsigned long)site.calls, (unsigned long)site.retains, (long)site.netBytes,
+                  site.worstRetain, site.worstBlockLoss);
+  }
+}
\ No newline at end of file
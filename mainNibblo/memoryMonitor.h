@@ -0,0 +1,94 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "hal.h"
+#include "messageBuffer.h"
+
+// Call-site yang dilacak (jalur String/File/TLS di TelegramHandler & DataLogger)
+enum MemorySite {
+  MEM_SITE_TELEGRAM_STEP,     // TelegramClient::step, buffer TLS & HTTP
+  MEM_SITE_TELEGRAM_COMMAND,  // handler perintah masuk
+  MEM_SITE_TELEGRAM_SEND,     // pesan keluar ke MessageQueue
+  MEM_SITE_LOG_FEED,
+  MEM_SITE_LOG_TOTALS,
+  MEM_SITE_LOG_HISTORY,
+  MEM_SITE_COUNT
+};
+
+struct MemorySample {
+  uint32_t epoch;
+  uint16_t freeHeap;
+  uint16_t lowWater;          // heap bebas terendah sejak sampel sebelumnya
+  uint16_t maxBlock;
+  uint8_t fragmentation;
+  uint8_t reserved;
+};
+
+struct MemorySiteStats {
+  uint32_t calls;
+  uint32_t retains;           // panggilan yang meninggalkan heap lebih kecil
+  int32_t netBytes;           // jumlah heap yang tertahan (+) / dilepas (-)
+  uint16_t worstRetain;       // byte terbesar yang tertahan satu panggilan
+  uint16_t worstBlockLoss;    // penyusutan blok terbesar satu panggilan
+};
+
+struct MemoryFileHeader {
+  uint32_t magic;
+  uint32_t stateSize;         // layout berubah = mulai dari nol
+};
+
+// Isi file MEM_FILE setelah header
+struct MemoryState {
+  MemorySample history[MEM_HISTORY_SIZE];
+  uint8_t historyHead;
+  uint8_t historyCount;
+  uint16_t reserved;
+  uint32_t lowWater;          // sejak sampel ring terakhir
+  uint32_t lowestEver;
+};
+
+// Telemetri heap: heap bebas, blok terbesar dan fragmentasi disampel ke ring
+// kecil (MEM_HISTORY_SIZE x MEM_HISTORY_PERIOD), low-water mark diikuti di
+// antaranya. MEM_TRACK(site) mengukur heap sebelum/sesudah blok supaya terlihat
+// call-site mana yang menahan memori atau memecah blok besar. Ring disimpan
+// ke MEM_FILE sebelum deep sleep, jadi tren mencakup banyak siklus bangun;
+// counter call-site hanya sejak boot karena reset mengosongkan heap.
+class MemoryMonitor {
+private:
+  static MemoryState state;
+  static MemorySiteStats sites[MEM_SITE_COUNT];
+
+  static void addSample(unsigned long epoch);
+  static float getSlope(uint16_t MemorySample::*field);
+
+public:
+  static void init();
+  static void update();
+  static void prepareSleep();
+  static void noteHeap(uint32_t freeHeap);
+  static void recordSite(MemorySite site, uint32_t freeBefore, uint32_t blockBefore);
+
+  static float getLowWaterTrend();           // B/jam, negatif = turun
+  static bool isLeakSuspected();
+  static bool isFragmented();
+  static void formatReport(MessageBuffer& report);
+  static void printStats();
+};
+
+class MemoryScope {
+private:
+  MemorySite site;
+  uint32_t freeBefore;
+  uint32_t blockBefore;
+
+public:
+  explicit MemoryScope(MemorySite site)
+    : site(site), freeBefore(Hal::getFreeHeap()), blockBefore(Hal::getMaxFreeBlock()) {}
+  ~MemoryScope() { MemoryMonitor::recordSite(site, freeBefore, blockBefore); }
+};
+
+#define MEM_TRACK(site) MemoryScope memoryScope(site)
+
+#endif
\ No newline at end of file
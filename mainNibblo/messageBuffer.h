@@ -0,0 +1,85 @@
+#ifndef MESSAGE_BUFFER_H
+#define MESSAGE_BUFFER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Panjang prefix text[0..length) yang tidak berakhir di tengah karakter UTF-8:
+// emoji yang terpotong membuat Telegram menolak seluruh pesan (400)
+inline size_t utf8Prefix(const char* text, size_t length) {
+  size_t start = length;
+  while (start > 0 && ((uint8_t)text[start - 1] & 0xC0) == 0x80) start--;  // mundur ke byte awal
+  if (start == 0) return length;
+  uint8_t lead = text[start - 1];
+  size_t needed = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+  return length - (start - 1) >= needed ? length : start - 1;
+}
+
+// Buffer teks kapasitas tetap (stack/static) pengganti rantai String +=.
+// Tidak pernah alokasi heap; jika penuh, teks dipotong di batas karakter
+// UTF-8 dan isTruncated() = true.
+template <size_t N>
+class TextBuffer {
+private:
+  char data[N];
+  size_t len;
+  bool truncated;
+
+public:
+  TextBuffer() : len(0), truncated(false) { data[0] = '\0'; }
+
+  TextBuffer& append(const char* text) {
+    while (*text) {
+      if (len + 1 >= N) {
+        truncated = true;
+        len = utf8Prefix(data, len);
+        break;
+      }
+      data[len++] = *text++;
+    }
+    data[len] = '\0';
+    return *this;
+  }
+
+  TextBuffer& append(char c) {
+    if (len + 1 >= N) {
+      truncated = true;
+      return *this;
+    }
+    data[len++] = c;
+    data[len] = '\0';
+    return *this;
+  }
+
+  TextBuffer& appendf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(data + len, N - len, format, args);
+    va_end(args);
+    if (written < 0) {
+      data[len] = '\0';
+    } else if ((size_t)written >= N - len) {
+      len = utf8Prefix(data, N - 1);
+      data[len] = '\0';
+      truncated = true;
+    } else {
+      len += written;
+    }
+    return *this;
+  }
+
+  void clear() {
+    len = 0;
+    truncated = false;
+    data[0] = '\0';
+  }
+
+  const char* c_str() const { return data; }
+  size_t length() const { return len; }
+  size_t capacity() const { return N - 1; }
+  bool isTruncated() const { return truncated; }
+};
+
+typedef TextBuffer<MESSAGE_BUFFER_SIZE> MessageBuffer;
+
+#endif
@@ -0,0 +1,203 @@
+#include "messageQueue.h"
+#include "messageBuffer.h"
+
+OutboundMessage MessageQueue::slots[OUTBOX_CAPACITY];
+int MessageQueue::head = 0;
+int MessageQueue::count = 0;
+bool MessageQueue::headInFlight = false;
+char MessageQueue::payload[TELEGRAM_POST_BUFFER];
+
+unsigned long MessageQueue::dropCount = 0;
+unsigned long MessageQueue::failCount = 0;
+unsigned long MessageQueue::sentCount = 0;
+unsigned long MessageQueue::coalescedCount = 0;
+unsigned long MessageQueue::totalLatency = 0;
+unsigned long MessageQueue::worstLatency = 0;
+
+bool MessageQueue::enqueue(const char* chatId, const char* text,
+                           const char* parseMode, const char* keyboard) {
+  size_t length = strlen(text);
+  if (length > OUTBOX_TEXT_SIZE - 1) length = utf8Prefix(text, OUTBOX_TEXT_SIZE - 1);
+
+  // gabung ke pesan terakhir jika chat & format sama dan masih dalam window
+  if (count > 0 && keyboard == NULL) {
+    int tail = (head + count - 1) % OUTBOX_CAPACITY;
+    bool tailInFlight = (tail == head && headInFlight);
+    if (!tailInFlight && canCoalesce(slots[tail], chatId, parseMode, length)) {
+      OutboundMessage& slot = slots[tail];
+      memcpy(slot.text + slot.length, "\n\n", 2);
+      memcpy(slot.text + slot.length + 2, text, length);
+      slot.length += 2 + length;
+      slot.text[slot.length] = '\0';
+      coalescedCount++;
+      return true;
+    }
+  }
+
+  if (count == OUTBOX_CAPACITY) {
+    if (headInFlight) {
+      dropCount++;  // slot terdepan sedang dikirim, pesan baru yang dibuang
+      Serial.println("⚠ Outbox full - message dropped");
+      return false;
+    }
+    pop();  // buang pesan terlama
+    dropCount++;
+    Serial.println("⚠ Outbox full - oldest message dropped");
+  }
+
+  OutboundMessage& slot = slots[(head + count) % OUTBOX_CAPACITY];
+  strncpy(slot.chatId, chatId, sizeof(slot.chatId) - 1);
+  slot.chatId[sizeof(slot.chatId) - 1] = '\0';
+  strncpy(slot.parseMode, parseMode, sizeof(slot.parseMode) - 1);
+  slot.parseMode[sizeof(slot.parseMode) - 1] = '\0';
+  slot.keyboard = keyboard;
+  memcpy(slot.text, text, length);
+  slot.text[length] = '\0';
+  slot.length = length;
+  slot.enqueuedAt = millis();
+  slot.retries = 0;
+  slot.retryAt = 0;
+  count++;
+  return true;
+}
+
+bool MessageQueue::canCoalesce(const OutboundMessage& slot, const char* chatId,
+                               const char* parseMode, size_t extraLength) {
+  return slot.keyboard == NULL &&
+         slot.retries == 0 &&
+         millis() - slot.enqueuedAt < OUTBOX_COALESCE_WINDOW &&
+         slot.length + 2 + extraLength < OUTBOX_TEXT_SIZE &&
+         strcmp(slot.chatId, chatId) == 0 &&
+         strcmp(slot.parseMode, parseMode) == 0;
+}
+
+bool MessageQueue::isEmpty() {
+  return count == 0;
+}
+
+bool MessageQueue::isReady() {
+  return count > 0 && !headInFlight && timeUntilReady() == 0;
+}
+
+  // ms sampai slot terdepan boleh dikirim (window coalescing / jeda retry)
+unsigned long MessageQueue::timeUntilReady() {
+  if (count == 0) return OUTBOX_COALESCE_WINDOW;
+  const OutboundMessage& slot = slots[head];
+  unsigned long now = millis();
+
+  if (slot.retries > 0) {
+    return (long)(slot.retryAt - now) > 0 ? slot.retryAt - now : 0;
+  }
+  if (slot.keyboard != NULL) return 0;  // menu balasan user, jangan ditahan
+
+  unsigned long age = now - slot.enqueuedAt;
+  return age < OUTBOX_COALESCE_WINDOW ? OUTBOX_COALESCE_WINDOW - age : 0;
+}
+
+  // JSON sendMessage untuk slot terdepan; slot ditandai sedang dikirim
+const char* MessageQueue::buildPayload(size_t& length) {
+  const OutboundMessage& slot = slots[head];
+  size_t pos = 0;
+
+  appendRaw(pos, "{\"chat_id\":\"");
+  appendRaw(pos, slot.chatId);
+  appendRaw(pos, "\",\"text\":\"");
+  appendEscaped(pos, slot.text);
+  appendRaw(pos, "\"");
+  if (slot.parseMode[0] != '\0') {
+    appendRaw(pos, ",\"parse_mode\":\"");
+    appendRaw(pos, slot.parseMode);
+    appendRaw(pos, "\"");
+  }
+  if (slot.keyboard != NULL) {
+    appendRaw(pos, ",\"reply_markup\":{\"keyboard\":");
+    appendRaw(pos, slot.keyboard);
+    appendRaw(pos, ",\"resize_keyboard\":true}");
+  }
+  appendRaw(pos, "}");
+
+  headInFlight = true;
+  length = pos;
+  return payload;
+}
+
+void MessageQueue::appendRaw(size_t& pos, const char* text) {
+  while (*text && pos < sizeof(payload) - 1) {
+    payload[pos++] = *text++;
+  }
+  payload[pos] = '\0';
+}
+
+  // escape JSON; sisakan ruang untuk field penutup (keyboard dsb)
+void MessageQueue::appendEscaped(size_t& pos, const char* text) {
+  const OutboundMessage& slot = slots[head];
+  size_t reserve = 96 + (slot.keyboard ? strlen(slot.keyboard) : 0);
+  size_t limit = sizeof(payload) > reserve ? sizeof(payload) - reserve : 0;
+
+  for (; *text; text++) {
+    unsigned char c = *text;
+    char escaped[7];
+    size_t escapedLength = 1;
+    escaped[0] = c;
+
+    if (c == '"' || c == '\\') {
+      escaped[0] = '\\';
+      escaped[1] = c;
+      escapedLength = 2;
+    } else if (c == '\n') {
+      escaped[0] = '\\';
+      escaped[1] = 'n';
+      escapedLength = 2;
+    } else if (c < 0x20) {
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      escapedLength = 6;
+    }
+
+    // jangan potong di tengah karakter UTF-8 (byte lanjutan 10xxxxxx)
+    if (pos + escapedLength > limit && (c & 0xC0) != 0x80) break;
+    if (pos + escapedLength >= sizeof(payload)) break;
+    memcpy(payload + pos, escaped, escapedLength);
+    pos += escapedLength;
+  }
+  payload[pos] = '\0';
+}
+
+void MessageQueue::markSent() {
+  unsigned long latency = millis() - slots[head].enqueuedAt;
+  totalLatency += latency;
+  if (latency > worstLatency) worstLatency = latency;
+  sentCount++;
+  pop();
+}
+
+  // retry = error sementara (429/5xx/jaringan); selain itu pesan dibuang
+void MessageQueue::markFailed(bool retry) {
+  headInFlight = false;
+  OutboundMessage& slot = slots[head];
+  if (retry && slot.retries < OUTBOX_MAX_RETRIES) {
+    slot.retries++;
+    slot.retryAt = millis() + OUTBOX_RETRY_DELAY * slot.retries;
+    return;
+  }
+  failCount++;
+  pop();
+}
+
+void MessageQueue::pop() {
+  if (count == 0) return;
+  head = (head + 1) % OUTBOX_CAPACITY;
+  count--;
+  headInFlight = false;
+}
+
+int MessageQueue::getDepth() { return count; }
+unsigned long MessageQueue::getDropCount() { return dropCount; }
+unsigned long MessageQueue::getFailCount() { return failCount; }
+unsigned long MessageQueue::getSentCount() { return sentCount; }
+unsigned long MessageQueue::getCoalescedCount() { return coalescedCount; }
+unsigned long MessageQueue::getWorstLatency() { return worstLatency; }
+
+unsigned long MessageQueue::getAverageLatency() {
+  if (sentCount == 0) return 0;
+  return totalLatency / sentCount;
+}
@@ -0,0 +1,64 @@
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+struct OutboundMessage {
+  char chatId[TELEGRAM_CHAT_ID_SIZE];
+  char parseMode[12];
+  const char* keyboard;       // JSON reply keyboard (string literal) atau NULL
+  char text[OUTBOX_TEXT_SIZE];
+  size_t length;
+  unsigned long enqueuedAt;   // pesan pertama di slot ini
+  uint8_t retries;
+  unsigned long retryAt;
+};
+
+// Antrian ring pesan keluar ukuran tetap. Pesan ke chat yang sama dalam
+// OUTBOX_COALESCE_WINDOW digabung jadi satu request; jika penuh, pesan
+// terlama dibuang. Dikuras TelegramHandler lewat TelegramClient.
+class MessageQueue {
+private:
+  static OutboundMessage slots[OUTBOX_CAPACITY];
+  static int head;
+  static int count;
+  static bool headInFlight;
+  static char payload[TELEGRAM_POST_BUFFER];
+
+  static unsigned long dropCount;
+  static unsigned long failCount;
+  static unsigned long sentCount;
+  static unsigned long coalescedCount;
+  static unsigned long totalLatency;
+  static unsigned long worstLatency;
+
+  static bool canCoalesce(const OutboundMessage& slot, const char* chatId,
+                          const char* parseMode, size_t extraLength);
+  static void appendEscaped(size_t& pos, const char* text);
+  static void appendRaw(size_t& pos, const char* text);
+  static void pop();
+
+public:
+  static bool enqueue(const char* chatId, const char* text,
+                      const char* parseMode = "", const char* keyboard = NULL);
+  static bool isEmpty();
+  static bool isReady();
+  static unsigned long timeUntilReady();
+
+  // dipakai TelegramHandler untuk mengirim slot terdepan
+  static const char* buildPayload(size_t& length);
+  static void markSent();
+  static void markFailed(bool retry);
+
+  // Statistik
+  static int getDepth();
+  static unsigned long getDropCount();
+  static unsigned long getFailCount();
+  static unsigned long getSentCount();
+  static unsigned long getCoalescedCount();
+  static unsigned long getAverageLatency();
+  static unsigned long getWorstLatency();
+};
+
+#endif
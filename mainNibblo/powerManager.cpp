@@ -1,75 +1,253 @@
 #include "powerManager.h"
 #include "hardware.h"
 #include "telegramHandler.h"
+#include "dataLogger.h"
+#include "recordStore.h"
+#include "hal.h"
+#include "profiler.h"
+#include "memoryMonitor.h"
 
   // static var
 bool PowerManager::lowPowerMode = false;
-bool PowerManager::idleMode = false;
+bool PowerManager::wokeFromSleep = false;
 unsigned long PowerManager::lastActivity = 0;
-unsigned long PowerManager::sleepTimeout = 300000; // 5 menit
+unsigned long PowerManager::sleepTimeout = DUTY_IDLE_TIMEOUT;
+RtcState PowerManager::rtcState;
 
+  // Dipanggil sebelum RecordStore, TimeManager, AlertManager dan
+  // TelegramHandler di-init: state dari RTC memory dipulihkan lebih dulu
 void PowerManager::init() {
-  lastActivity = millis();
+  wokeFromSleep = Hal::wokeFromDeepSleep() && loadRtcState();
+  
+  if (wokeFromSleep) {
+    unsigned long sleptMs = rtcState.sleepSeconds * 1000UL;
+    TimeManager::restoreSleepState(rtcState.clock, sleptMs);
+    AlertManager::restoreSleepState(rtcState.alerts, sleptMs);
+    TelegramHandler::restoreLastUpdateId(rtcState.lastUpdateId);
+    TelegramClient::restoreMflnState((MflnState)rtcState.network.tlsMfln);
+    sleepTimeout = DUTY_MIN_AWAKE;   // bangun terjadwal: cukup poll & cek sensor
+    Serial.printf("⏰ Woke from deep sleep #%lu (%lus)\n",
+                  (unsigned long)rtcState.sleepCount, (unsigned long)rtcState.sleepSeconds);
+  } else {
+    memset((void*)&rtcState, 0, sizeof(rtcState));
+    sleepTimeout = DUTY_IDLE_TIMEOUT;
+  }
+  lastActivity = 0;  // dihitung dari reset
   Serial.println("✅ Power Manager initialized");
 }
 
 void PowerManager::checkPowerStatus() {
   float batteryPercent = Hardware::getBatteryPercent();
   
-  // Critical battery - emergency sleep
+  // Critical battery - emergency sleep (alert dikirim aturan baterai AlertManager)
   if (batteryPercent < CRITICAL_BATTERY_THRESHOLD) {
     Serial.println("⚠️ Critical battery - entering emergency sleep");
-    TelegramHandler::sendBatteryAlert(batteryPercent, true);
-    delay(2000);
     enterIdleMode();
   }
   
   // Low battery - enter power saving mode
   else if (batteryPercent < LOW_BATTERY_THRESHOLD && !lowPowerMode) {
     Serial.println("⚠️ Low battery - entering power saving mode");
-    // enterLowPowerMode();
+    enterLowPowerMode();
   }
   
   // Normal operation
   else if (batteryPercent > LOW_BATTERY_THRESHOLD + 5 && lowPowerMode) {
     Serial.println("✅ Battery recovered - exiting power saving mode");
-    // exitLowPowerMode();
+    exitLowPowerMode();
   }
   
-  // Idle sleep check
-  if (millis() - lastActivity > sleepTimeout) {
-    Serial.println("💤 Idle timeout - entering sleep mode");
-    // enterIdleMode();
+#if DUTY_CYCLE_ENABLED
+  // Idle: tidur sampai ada yang harus dikerjakan (jadwal, log, poll bot)
+  if (canSleep()) {
+    unsigned long seconds = getNextWakeSeconds();
+    if (seconds >= DUTY_MIN_SLEEP) {
+      Serial.println("💤 Idle timeout - entering sleep mode");
+      enterDeepSleep(seconds);
+    }
   }
+#endif
 }
 
+  // pesan Telegram masuk: tetap bangun DUTY_IDLE_TIMEOUT untuk percakapan
 void PowerManager::updateActivity() {
   lastActivity = millis();
-
-//     //matiin lalu nyalain wifi
-//     if (idleMode) {
-//     WiFi.mode(WIFI_STA);
-//     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-//     idleMode = false;
-//     Serial.println("⚡ Waking up from idle mode...");
-//   }
+  sleepTimeout = DUTY_IDLE_TIMEOUT;
 }
 
 void PowerManager::enterLowPowerMode() {
   lowPowerMode = true;
-  // Reduce WiFi power
-  // WiFi.setSleepMode(WIFI_LIGHT_SLEEP);
+  // radio tidur di antara beacon DTIM
+  WiFi.setSleepMode(WIFI_LIGHT_SLEEP);
 }
 
 void PowerManager::exitLowPowerMode() {
   lowPowerMode = false;
-  // WiFi.setSleepMode(WIFI_NONE_SLEEP);
+  WiFi.setSleepMode(WIFI_MODEM_SLEEP);  // default ESP8266
 }
 
+  // Baterai kritis: tidur selama mungkin, tapi tidak melewati jadwal makan
+  // berikutnya (baterai mungkin sudah diisi saat itu). Jadwal yang sudah di
+  // depan mata ditolak sekarang dan dilaporkan, bukan terlewat diam-diam.
+  // Tanpa duty cycle hanya WiFi yang dimatikan.
 void PowerManager::enterIdleMode() {
-  idleMode = true;
-  // WiFi.disconnect();
-  // WiFi.mode(WIFI_OFF);
-  // Hardware::displayMessage("Idle mode");
-  // Serial.println("🛑 WiFi OFF to save power");
-}
\ No newline at end of file
+#if DUTY_CYCLE_ENABLED
+  unsigned long seconds = Hal::deepSleepMax() / 1000000ULL;
+  if (TimeManager::isClockValid(TimeManager::getEpoch())) {
+    unsigned long feed = TimeManager::getSecondsUntilNextFeed();
+    if (feed != NO_FEED_DUE && feed < DUTY_WAKE_LEAD + DUTY_MIN_SLEEP) {
+      TimeManager::skipNextFeed("battery critical");
+      feed = TimeManager::getSecondsUntilNextFeed();
+    }
+    if (feed != NO_FEED_DUE && feed - DUTY_WAKE_LEAD < seconds) seconds = feed - DUTY_WAKE_LEAD;
+  }
+  enterDeepSleep(seconds);
+#else
+  TelegramHandler::flushMessages(TELEGRAM_RESPONSE_TIMEOUT);
+  WiFi.disconnect();
+  WiFi.mode(WIFI_OFF);
+  Hardware::displayMessage("Idle mode");
+  Serial.println("🛑 WiFi OFF to save power");
+#endif
+}
+
+  // Pekerjaan yang tidak boleh terputus atau hilang saat RAM di-reset
+bool PowerManager::canSleep() {
+  if (millis() - lastActivity < sleepTimeout) return false;
+  if (!TimeManager::isClockValid(TimeManager::getEpoch())) return false;  // wake tidak bisa dihitung
+  if (Hardware::isMeasuring()) return false;
+  // tanpa WiFi tidak ada yang bisa dikirim; tidur dan coba lagi nanti
+  if (WiFi.status() == WL_CONNECTED && !TelegramHandler::isQuiet()) return false;
+  return true;
+}
+
+  // Detik sampai bangun berikutnya: jadwal makan (dikurangi waktu boot),
+  // sampel riwayat, dan SLEEP_DURATION_SECONDS untuk poll bot & cek alert
+unsigned long PowerManager::getNextWakeSeconds() {
+  unsigned long wake = SLEEP_DURATION_SECONDS;
+  
+  unsigned long feed = TimeManager::getSecondsUntilNextFeed();
+  if (feed != NO_FEED_DUE) {
+    wake = min(wake, feed > DUTY_WAKE_LEAD ? feed - DUTY_WAKE_LEAD : 0);
+  }
+  wake = min(wake, DataLogger::getSecondsUntilNextSample());
+  return wake;
+}
+
+void PowerManager::enterDeepSleep(unsigned long seconds) {
+  unsigned long maxSeconds = Hal::deepSleepMax() / 1000000ULL;
+  if (seconds > maxSeconds) seconds = maxSeconds;
+  
+  Serial.printf("💤 Deep sleep %lus after %lums awake\n", seconds, millis());
+  TelegramHandler::prepareSleep();
+  DataLogger::prepareSleep();
+  MemoryMonitor::prepareSleep();
+#if PROFILER_ENABLED
+  Profiler::prepareSleep();
+#endif
+  saveRtcState(seconds);
+  Hardware::sleepDisplay();
+  Hal::deepSleep(seconds * 1000000ULL);
+}
+
+void PowerManager::saveRtcState(unsigned long sleepSeconds) {
+  static_assert(sizeof(RtcState) % 4 == 0, "RTC memory is written in 4-byte blocks");
+  static_assert(RTC_STATE_OFFSET * 4 + sizeof(RtcState) <= RTC_USER_MEMORY_SIZE, "RtcState does not fit RTC user memory");
+  
+  RtcState state;
+  memset((void*)&state, 0, sizeof(state));  // padding ikut CRC
+  state.magic = RTC_STATE_MAGIC;
+  state.sleepSeconds = sleepSeconds;
+  state.sleepCount = rtcState.sleepCount + 1;
+  state.awakeMs = rtcState.awakeMs + millis();
+  state.sleptSeconds = rtcState.sleptSeconds + sleepSeconds;
+  state.lastUpdateId = TelegramHandler::getLastUpdateId();
+  AlertManager::getSleepState(state.alerts);
+  TimeManager::getSleepState(state.clock);
+  rememberNetwork(state.network);
+  state.crc = rtcChecksum(state);
+  
+  Hal::rtcWrite(RTC_STATE_OFFSET, &state, sizeof(state));
+}
+
+void PowerManager::rememberNetwork(RtcNetwork& network) {
+  network = rtcState.network;  // WiFi sedang putus: pakai asosiasi sebelumnya
+  network.tlsMfln = TelegramClient::getMflnState();
+  if (WiFi.status() != WL_CONNECTED) {
+    if (network.offlineWakes < UINT8_MAX) network.offlineWakes++;
+    return;
+  }
+  
+  network.valid = 1;
+  network.offlineWakes = 0;
+  network.channel = WiFi.channel();
+  memcpy(network.bssid, WiFi.BSSID(), sizeof(network.bssid));
+  network.ip = WiFi.localIP();
+  network.gateway = WiFi.gatewayIP();
+  network.subnet = WiFi.subnetMask();
+  network.dns = WiFi.dnsIP();
+}
+
+  // IP dari DHCP sebelumnya dipasang statis dan AP dituju langsung lewat
+  // BSSID + channel. false jika tidak ada data (cold boot).
+bool PowerManager::beginFastConnect() {
+  if (!wokeFromSleep || !rtcState.network.valid) return false;
+  
+  const RtcNetwork& network = rtcState.network;
+  WiFi.config(IPAddress(network.ip), IPAddress(network.gateway),
+              IPAddress(network.subnet), IPAddress(network.dns));
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD, network.channel, network.bssid, true);
+  return true;
+}
+
+  // AP pindah channel / IP sudah dipakai perangkat lain: kembali ke scan + DHCP
+void PowerManager::forgetNetwork() {
+  rtcState.network.valid = 0;
+  WiFi.disconnect();
+  WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+}
+
+  // Detik percobaan asosiasi penuh: di tengah gangguan WiFi yang panjang
+  // setiap bangun hanya mencoba sebentar supaya waktu bangun tetap pendek
+int PowerManager::getConnectAttempts() {
+  if (wokeFromSleep && rtcState.network.offlineWakes > 0) return WIFI_OFFLINE_ATTEMPTS;
+  return WIFI_CONNECT_ATTEMPTS;
+}
+
+  // Bangun dari deep sleep dengan jam valid dari RTC memory: feed, sensor
+  // dan log tetap jalan tanpa WiFi. Restart justru menghapus RtcState (jam,
+  // alert, offset bot) sehingga jadwal berhenti sampai WiFi kembali.
+bool PowerManager::canRunOffline() {
+  return wokeFromSleep && TimeManager::isClockValid(TimeManager::getEpoch());
+}
+
+bool PowerManager::loadRtcState() {
+  if (!Hal::rtcRead(RTC_STATE_OFFSET, &rtcState, sizeof(rtcState))) return false;
+  return rtcState.magic == RTC_STATE_MAGIC && rtcState.crc == rtcChecksum(rtcState);
+}
+
+uint32_t PowerManager::rtcChecksum(const RtcState& state) {
+  const uint8_t* data = (const uint8_t*)&state + offsetof(RtcState, sleepSeconds);
+  return RecordStore::crc32(0xFFFFFFFF, data, sizeof(state) - offsetof(RtcState, sleepSeconds)) ^ 0xFFFFFFFF;
+}
+
+bool PowerManager::isWakeFromSleep() { return wokeFromSleep; }
+unsigned long PowerManager::getSleepCount() { return rtcState.sleepCount; }
+
+  // fraksi waktu bangun sejak cold boot (1.0 = tanpa deep sleep)
+float PowerManager::getAwakeRatio() {
+  float awake = rtcState.awakeMs + millis();
+  float slept = rtcState.sleptSeconds * 1000.0;
+  return awake / (awake + slept);
+}
+
+float PowerManager::getAverageCurrent() {
+  float ratio = getAwakeRatio();
+  return ratio * CURRENT_AWAKE_MA + (1 - ratio) * CURRENT_SLEEP_MA;
+}
+
+  // sisa kapasitas (dari persentase baterai) dibagi arus rata-rata
+float PowerManager::getBatteryLifeHours() {
+  float remaining = BATTERY_CAPACITY_MAH * Hardware::getBatteryPercent() / 100.0;
+  return remaining / getAverageCurrent();
+}
@@ -4,16 +4,54 @@
 #include <ESP8266WiFi.h>
 #include "config.h"
 #include "credential.h"
+#include "alertManager.h"
+#include "timeManager.h"
 
 class Hardware;
 class TelegramHandler;
 
+// Asosiasi WiFi terakhir: bangun dari sleep tanpa scan dan tanpa DHCP
+struct RtcNetwork {
+  uint8_t valid;
+  uint8_t channel;
+  uint8_t bssid[6];
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint8_t tlsMfln;            // MflnState TelegramClient
+  uint8_t offlineWakes;       // bangun berturut-turut tanpa WiFi
+  uint8_t reserved[2];
+};
+
+// State yang dibawa melewati deep sleep di RTC user memory (hilang saat
+// daya putus). Jadwal & total feed tetap di RecordStore, riwayat di HISTORY_FILE.
+struct RtcState {
+  uint32_t magic;
+  uint32_t crc;               // CRC32 semua field setelah crc
+  uint32_t sleepSeconds;      // durasi tidur yang diminta
+  uint32_t sleepCount;        // statistik sejak cold boot
+  uint32_t awakeMs;
+  uint32_t sleptSeconds;
+  int32_t lastUpdateId;
+  AlertState alerts;
+  ClockState clock;
+  RtcNetwork network;
+};
+
 class PowerManager {
 private:
   static unsigned long sleepTimeout;
   static unsigned long lastActivity;
   static bool lowPowerMode;
-  static bool idleMode;
+  static bool wokeFromSleep;
+  static RtcState rtcState;
+
+  static bool loadRtcState();
+  static void saveRtcState(unsigned long sleepSeconds);
+  static uint32_t rtcChecksum(const RtcState& state);
+  static bool canSleep();
+  static void rememberNetwork(RtcNetwork& network);
 
 public:
   static void init();
@@ -22,6 +60,19 @@ public:
   static void enterLowPowerMode();
   static void exitLowPowerMode();
   static void enterIdleMode();
+  static unsigned long getNextWakeSeconds();
+  static void enterDeepSleep(unsigned long seconds);
+  static bool beginFastConnect();
+  static void forgetNetwork();
+  static int getConnectAttempts();
+  static bool canRunOffline();
+
+  // Statistik & estimasi
+  static bool isWakeFromSleep();
+  static unsigned long getSleepCount();
+  static float getAwakeRatio();
+  static float getAverageCurrent();
+  static float getBatteryLifeHours();
 };
 
-#endif
+#endif
\ No newline at end of file
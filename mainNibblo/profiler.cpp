@@ -0,0 +1,168 @@
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+#include <LittleFS.h>
+
+struct StageInfo {
+  const char* name;
+  uint16_t budgetMs;
+};
+
+static const StageInfo stageInfo[PROFILE_STAGE_COUNT] = {
+  {"loop",     PROFILE_BUDGET_LOOP},
+  {"dispatch", PROFILE_BUDGET_DISPATCH},
+  {"feed",     PROFILE_BUDGET_FEED},
+  {"telegram", PROFILE_BUDGET_TELEGRAM},
+  {"sensors",  PROFILE_BUDGET_SENSORS},
+  {"display",  PROFILE_BUDGET_DISPLAY},
+  {"alerts",   PROFILE_BUDGET_ALERTS},
+  {"health",   PROFILE_BUDGET_HEALTH},
+  {"time",     PROFILE_BUDGET_TIME},
+  {"datalog",  PROFILE_BUDGET_DATALOG},
+};
+
+ProfileStats Profiler::stats[PROFILE_STAGE_COUNT];
+unsigned long Profiler::lastWarning[PROFILE_STAGE_COUNT];
+uint32_t Profiler::sessions = 0;
+
+void Profiler::init() {
+  reset();
+  File file = LittleFS.open(PROFILE_FILE, "r");
+  if (file) {
+    ProfileFileHeader header;
+    // layout berubah (tahap/bucket baru) = mulai dari nol
+    if (file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+        header.magic == PROFILE_FILE_MAGIC && header.stageCount == PROFILE_STAGE_COUNT &&
+        header.bucketCount == PROFILE_BUCKETS &&
+        file.read((uint8_t*)stats, sizeof(stats)) == sizeof(stats)) {
+      sessions = header.sessions;
+    } else {
+      memset(stats, 0, sizeof(stats));
+    }
+    file.close();
+  }
+  sessions++;
+  Serial.printf("✅ Profiler initialized (session %lu)\n", (unsigned long)sessions);
+}
+
+  // Bucket i menampung [2^i, 2^(i+1)) us; 0 us masuk bucket 0
+uint8_t Profiler::bucketOf(unsigned long us) {
+  uint8_t bucket = 0;
+  while (us > 1 && bucket < PROFILE_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void Profiler::record(ProfileStage stage, unsigned long us) {
+  ProfileStats& entry = stats[stage];
+  if (entry.count < UINT32_MAX) entry.count++;
+  entry.totalUs += us;
+  if (us > entry.maxUs) entry.maxUs = us;
+  // Statistik terkumpul lintas deep sleep: bucket yang penuh tidak dibiarkan
+  // jenuh (bucket cepat berhenti naik, persentil bergeser ke bucket lambat),
+  // semua bucket dibagi dua supaya proporsinya tetap
+  uint32_t& bucket = entry.buckets[bucketOf(us)];
+  if (bucket == UINT32_MAX) {
+    for (int i = 0; i < PROFILE_BUCKETS; i++) entry.buckets[i] >>= 1;
+  }
+  bucket++;
+
+  if (us > (unsigned long)stageInfo[stage].budgetMs * 1000) {
+    entry.overBudget++;
+    unsigned long now = millis();
+    if (lastWarning[stage] == 0 || now - lastWarning[stage] >= PROFILE_WARN_INTERVAL) {
+      lastWarning[stage] = now;
+      Serial.printf("⚠️ PERF: %s took %lu.%03lu ms (budget %u ms)\n", stageInfo[stage].name,
+                    us / 1000, us % 1000, stageInfo[stage].budgetMs);
+    }
+  }
+}
+
+void Profiler::reset() {
+  memset(stats, 0, sizeof(stats));
+  memset(lastWarning, 0, sizeof(lastWarning));
+  sessions = 0;
+}
+
+void Profiler::prepareSleep() {
+  File file = LittleFS.open(PROFILE_FILE, "w");
+  if (!file) {
+    Serial.println("❌ Failed to save profile");
+    return;
+  }
+  ProfileFileHeader header;
+  header.magic = PROFILE_FILE_MAGIC;
+  header.stageCount = PROFILE_STAGE_COUNT;
+  header.bucketCount = PROFILE_BUCKETS;
+  header.sessions = sessions;
+  file.write((const uint8_t*)&header, sizeof(header));
+  file.write((const uint8_t*)stats, sizeof(stats));
+  file.close();
+}
+
+  // Batas atas bucket yang memuat persentil, dibatasi maxUs; resolusi 2x
+  // cukup untuk membedakan "mikrodetik" dari "ratusan milidetik". Dihitung
+  // dari jumlah isi bucket, bukan count (bucket bisa sudah dibagi dua).
+float Profiler::getPercentile(const ProfileStats& stage, float fraction) {
+  uint64_t total = 0;
+  for (int i = 0; i < PROFILE_BUCKETS; i++) total += stage.buckets[i];
+  if (total == 0) return 0;
+
+  uint64_t target = (uint64_t)(total * (double)fraction);
+  uint64_t seen = 0;
+  for (int i = 0; i < PROFILE_BUCKETS; i++) {
+    seen += stage.buckets[i];
+    if (seen > target) {
+      uint32_t upper = (2UL << i) - 1;
+      return min(upper, stage.maxUs) / 1000.0;
+    }
+  }
+  return stage.maxUs / 1000.0;
+}
+
+const char* Profiler::getStageName(ProfileStage stage) {
+  return stageInfo[stage].name;
+}
+
+void Profiler::formatReport(MessageBuffer& report) {
+  report.appendf("⏱ Loop Profile (%lu sessions)\n", (unsigned long)sessions);
+  report.append("stage: runs avg/p99/max ms\n");
+  for (int i = 0; i < PROFILE_STAGE_COUNT; i++) {
+    const ProfileStats& entry = stats[i];
+    if (entry.count == 0) continue;
+    report.appendf("%s: %lu %.2f/%.2f/%.1f", stageInfo[i].name, (unsigned long)entry.count,
+                   entry.totalUs / 1000.0 / entry.count, getPercentile(entry, 0.99),
+                   entry.maxUs / 1000.0);
+    if (entry.overBudget > 0) {
+      report.appendf(" ⚠️%lu>%ums", (unsigned long)entry.overBudget, stageInfo[i].budgetMs);
+    }
+    report.append('\n');
+  }
+}
+
+  // Histogram lengkap ke Serial, satu baris per bucket yang terisi
+void Profiler::printStats() {
+  Serial.println("=== Loop Profile ===");
+  for (int i = 0; i < PROFILE_STAGE_COUNT; i++) {
+    const ProfileStats& entry = stats[i];
+    if (entry.count == 0) continue;
+    Serial.printf("%s: %lu runs, max %lu us, over budget %lu\n", stageInfo[i].name,
+                  (unsigned long)entry.count, (unsigned long)entry.maxUs,
+                  (unsigned long)entry.overBudget);
+
+    uint32_t peak = 1;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) peak = max(peak, entry.buckets[b]);
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+      if (entry.buckets[b] == 0) continue;
+      char bar[21];
+      int width = max(1, (int)((uint64_t)entry.buckets[b] * 20 / peak));
+      memset(bar, '#', width);
+      bar[width] = '\0';
+      Serial.printf("  <%8lu us %8lu %s\n", 2UL << b, (unsigned long)entry.buckets[b], bar);
+    }
+  }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "messageBuffer.h"
+
+enum ProfileStage {
+  PROFILE_LOOP,               // satu pass Scheduler::run()
+  PROFILE_DISPATCH,           // task mulai terlambat dari jatuh tempo (jitter)
+  PROFILE_FEED,
+  PROFILE_TELEGRAM,
+  PROFILE_SENSORS,
+  PROFILE_DISPLAY,
+  PROFILE_ALERTS,
+  PROFILE_HEALTH,
+  PROFILE_TIME,
+  PROFILE_DATALOG,
+  PROFILE_STAGE_COUNT
+};
+
+struct ProfileStats {
+  uint32_t count;
+  uint32_t overBudget;
+  uint32_t maxUs;
+  uint64_t totalUs;           // untuk rata-rata
+  uint32_t buckets[PROFILE_BUCKETS];  // bucket penuh = semua dibagi dua
+};
+
+// Header file PROFILE_FILE; ProfileStats semua tahap menyusul
+struct ProfileFileHeader {
+  uint32_t magic;
+  uint16_t stageCount;
+  uint16_t bucketCount;
+  uint32_t sessions;          // boot/bangun yang terkumpul
+};
+
+#if PROFILER_ENABLED
+
+// Profiler latensi per tahap loop. Tiap PROFILE_SCOPE mengukur durasi blok
+// dengan micros() dan menambah satu hitungan di bucket log2, jadi RAM tetap
+// (PROFILE_STAGE_COUNT x ProfileStats) berapa pun jumlah sampelnya. Tahap
+// yang melewati budget dihitung dan diperingatkan lewat Serial. Statistik
+// disimpan ke PROFILE_FILE sebelum deep sleep supaya terkumpul lintas siklus.
+class Profiler {
+private:
+  static ProfileStats stats[PROFILE_STAGE_COUNT];
+  static unsigned long lastWarning[PROFILE_STAGE_COUNT];
+  static uint32_t sessions;
+
+  static uint8_t bucketOf(unsigned long us);
+  static float getPercentile(const ProfileStats& stage, float fraction);
+
+public:
+  static void init();
+  static void record(ProfileStage stage, unsigned long us);
+  static void reset();
+  static void prepareSleep();
+  static void formatReport(MessageBuffer& report);
+  static void printStats();
+  static const char* getStageName(ProfileStage stage);
+};
+
+class ProfileScope {
+private:
+  ProfileStage stage;
+  unsigned long start;
+
+public:
+  explicit ProfileScope(ProfileStage stage) : stage(stage), start(micros()) {}
+  ~ProfileScope() { Profiler::record(stage, micros() - start); }
+};
+
+#define PROFILE_SCOPE(stage) ProfileScope profileScope(stage)
+#else
+#define PROFILE_SCOPE(stage)
+#endif
+
+#endif
\ No newline at end of file
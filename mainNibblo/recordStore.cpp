@@ -0,0 +1,173 @@
+#include "recordStore.h"
+
+bool RecordStore::mounted = false;
+uint8_t RecordStore::cache[RECORD_TYPE_COUNT][STORE_MAX_PAYLOAD];
+uint8_t RecordStore::cacheLength[RECORD_TYPE_COUNT];
+size_t RecordStore::logSize = 0;
+
+unsigned long RecordStore::bytesRequested = 0;
+unsigned long RecordStore::bytesWritten = 0;
+unsigned long RecordStore::recordsWritten = 0;
+unsigned long RecordStore::recordsSkipped = 0;
+unsigned long RecordStore::compactionCount = 0;
+
+bool RecordStore::init() {
+  if (!LittleFS.begin()) {
+    Serial.println("❌ LittleFS mount failed - settings will not persist");
+    return false;
+  }
+  mounted = true;
+  recoverFiles();
+  replay();
+  Serial.printf("💾 Record store: %u bytes log\n", (unsigned)logSize);
+  return true;
+}
+
+  // Compaction yang terputus: file baru selesai tapi belum di-rename,
+  // atau file baru belum lengkap (log lama masih utuh)
+void RecordStore::recoverFiles() {
+  if (!LittleFS.exists(STORE_TEMP_FILE)) return;
+  if (LittleFS.exists(STORE_FILE)) {
+    LittleFS.remove(STORE_TEMP_FILE);
+  } else {
+    LittleFS.rename(STORE_TEMP_FILE, STORE_FILE);
+  }
+}
+
+  // Baca log dari awal; berhenti di record pertama yang rusak (tulisan
+  // terakhir yang terpotong saat daya putus) lalu tulis ulang log yang bersih
+void RecordStore::replay() {
+  memset(cacheLength, 0, sizeof(cacheLength));
+  logSize = 0;
+
+  File file = LittleFS.open(STORE_FILE, "r");
+  if (!file) return;
+
+  size_t fileSize = file.size();
+  RecordHeader header;
+  uint8_t payload[STORE_MAX_PAYLOAD];
+
+  while (file.read((uint8_t*)&header, sizeof(header)) == sizeof(header)) {
+    if (header.magic != STORE_RECORD_MAGIC ||
+        header.type == RECORD_NONE || header.type >= RECORD_TYPE_COUNT ||
+        header.length > STORE_MAX_PAYLOAD) break;
+    if (file.read(payload, header.length) != header.length) break;
+
+    uint32_t crc = crc32(0xFFFFFFFF, &header.type, 2);
+    crc = crc32(crc, payload, header.length) ^ 0xFFFFFFFF;
+    if (crc != header.crc) break;
+
+    memcpy(cache[header.type], payload, header.length);
+    cacheLength[header.type] = header.length;
+    logSize += sizeof(header) + header.length;
+  }
+  file.close();
+
+  if (logSize < fileSize) {
+    Serial.printf("⚠️ Record store: %u corrupt bytes dropped\n", (unsigned)(fileSize - logSize));
+    compact();
+  }
+}
+
+  // O(1): satu append di akhir log. Data yang sama dengan record terakhir
+  // tidak ditulis ulang.
+bool RecordStore::write(RecordType type, const void* data, size_t length) {
+  if (!mounted || type == RECORD_NONE || type >= RECORD_TYPE_COUNT || length > STORE_MAX_PAYLOAD) {
+    return false;
+  }
+  if (cacheLength[type] == length && memcmp(cache[type], data, length) == 0) {
+    recordsSkipped++;
+    return true;
+  }
+
+  File file = LittleFS.open(STORE_FILE, "a");
+  if (!file) {
+    Serial.println("❌ Record store: open failed");
+    return false;
+  }
+  bool ok = appendRecord(file, type, (const uint8_t*)data, length);
+  file.close();
+  if (!ok) return false;
+
+  memcpy(cache[type], data, length);
+  cacheLength[type] = length;
+  bytesRequested += length;
+  logSize += sizeof(RecordHeader) + length;
+
+  if (logSize > STORE_MAX_SIZE) compact();
+  return true;
+}
+
+bool RecordStore::appendRecord(File& file, uint8_t type, const uint8_t* data, uint8_t length) {
+  RecordHeader header;
+  header.magic = STORE_RECORD_MAGIC;
+  header.type = type;
+  header.length = length;
+  uint32_t crc = crc32(0xFFFFFFFF, &header.type, 2);
+  header.crc = crc32(crc, data, length) ^ 0xFFFFFFFF;
+
+  size_t written = file.write((const uint8_t*)&header, sizeof(header));
+  written += file.write(data, length);
+  bytesWritten += written;
+  recordsWritten++;
+  if (written != sizeof(header) + length) {
+    Serial.println("❌ Record store: write failed");
+    return false;
+  }
+  return true;
+}
+
+  // Tulis record terbaru tiap tipe ke file sementara lalu ganti log lama
+bool RecordStore::compact() {
+  File file = LittleFS.open(STORE_TEMP_FILE, "w");
+  if (!file) return false;
+
+  size_t size = 0;
+  bool ok = true;
+  for (int type = RECORD_NONE + 1; type < RECORD_TYPE_COUNT && ok; type++) {
+    if (cacheLength[type] == 0) continue;
+    ok = appendRecord(file, type, cache[type], cacheLength[type]);
+    size += sizeof(RecordHeader) + cacheLength[type];
+  }
+  file.close();
+
+  if (!ok) {
+    LittleFS.remove(STORE_TEMP_FILE);
+    return false;
+  }
+  LittleFS.remove(STORE_FILE);
+  LittleFS.rename(STORE_TEMP_FILE, STORE_FILE);
+  logSize = size;
+  compactionCount++;
+  return true;
+}
+
+  // true jika ada record tipe ini dengan panjang yang sama persis
+bool RecordStore::read(RecordType type, void* data, size_t length) {
+  if (type == RECORD_NONE || type >= RECORD_TYPE_COUNT || cacheLength[type] != length) {
+    return false;
+  }
+  memcpy(data, cache[type], length);
+  return true;
+}
+
+uint32_t RecordStore::crc32(uint32_t crc, const uint8_t* data, size_t length) {
+  while (length--) {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return crc;
+}
+
+size_t RecordStore::getLogSize() { return logSize; }
+unsigned long RecordStore::getRecordsWritten() { return recordsWritten; }
+unsigned long RecordStore::getRecordsSkipped() { return recordsSkipped; }
+unsigned long RecordStore::getCompactionCount() { return compactionCount; }
+
+  // byte yang benar-benar ditulis ke flash / byte payload yang diminta
+float RecordStore::getWriteAmplification() {
+  if (bytesRequested == 0) return 0;
+  return (float)bytesWritten / bytesRequested;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef RECORD_STORE_H
+#define RECORD_STORE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "config.h"
+
+enum RecordType {
+  RECORD_NONE,
+  RECORD_SCHEDULES,
+  RECORD_TOTALS,
+  RECORD_TYPE_COUNT
+};
+
+struct RecordHeader {
+  uint16_t magic;
+  uint8_t type;
+  uint8_t length;             // panjang payload
+  uint32_t crc;               // CRC32 dari type, length dan payload
+};
+
+// Penyimpanan key-value append-only di LittleFS. Setiap write menambah satu
+// record (header + payload + CRC) di akhir log; saat boot log di-replay dan
+// record terakhir tiap tipe yang CRC-nya valid yang berlaku. Jika log melebihi
+// STORE_MAX_SIZE, hanya record terbaru ditulis ulang ke file baru (compaction).
+// Wear levelling blok flash ditangani LittleFS.
+class RecordStore {
+private:
+  static bool mounted;
+  static uint8_t cache[RECORD_TYPE_COUNT][STORE_MAX_PAYLOAD];
+  static uint8_t cacheLength[RECORD_TYPE_COUNT];
+  static size_t logSize;
+
+  // statistik write amplification
+  static unsigned long bytesRequested;
+  static unsigned long bytesWritten;
+  static unsigned long recordsWritten;
+  static unsigned long recordsSkipped;
+  static unsigned long compactionCount;
+
+  static void recoverFiles();
+  static void replay();
+  static bool appendRecord(File& file, uint8_t type, const uint8_t* data, uint8_t length);
+  static bool compact();
+
+public:
+  static bool init();
+  static bool write(RecordType type, const void* data, size_t length);
+  static bool read(RecordType type, void* data, size_t length);
+  static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length);
+
+  // Statistik
+  static size_t getLogSize();
+  static float getWriteAmplification();
+  static unsigned long getRecordsWritten();
+  static unsigned long getRecordsSkipped();
+  static unsigned long getCompactionCount();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "scheduler.h"
+#include "profiler.h"
+
+SchedulerTask Scheduler::tasks[MAX_TASKS];
+int Scheduler::taskCount = 0;
+int Scheduler::currentTask = -1;
+long Scheduler::rescheduleDelay = -1;
+unsigned long Scheduler::wakeCount = 0;
+
+int Scheduler::addTask(const char* name, TaskCallback callback,
+                       unsigned long period, unsigned long deadline, uint8_t priority) {
+  if (taskCount >= MAX_TASKS) {
+    Serial.println("❌ Scheduler full, task not added: " + String(name));
+    return -1;
+  }
+
+  SchedulerTask& task = tasks[taskCount];
+  task.name = name;
+  task.callback = callback;
+  task.period = period;
+  task.deadline = deadline;
+  task.priority = priority;
+  task.nextRun = millis();  // jalan pertama langsung di pass berikutnya
+  task.runCount = 0;
+  task.worstRuntime = 0;
+  task.overrunCount = 0;
+  return taskCount++;
+}
+
+  // selisih signed supaya aman dari overflow millis() (~49 hari)
+bool Scheduler::isDue(const SchedulerTask& task, unsigned long now) {
+  return (long)(now - task.nextRun) >= 0;
+}
+
+void Scheduler::runTask(SchedulerTask& task) {
+  unsigned long release = task.nextRun;
+  unsigned long start = millis();
+#if PROFILER_ENABLED
+  Profiler::record(PROFILE_DISPATCH, (start - release) * 1000UL);  // jitter jatuh tempo
+#endif
+  currentTask = &task - tasks;
+  rescheduleDelay = -1;
+  task.callback();
+  currentTask = -1;
+  unsigned long finish = millis();
+
+  unsigned long runtime = finish - start;
+  if (runtime > task.worstRuntime) task.worstRuntime = runtime;
+  if (finish - release > task.deadline) task.overrunCount++;
+  task.runCount++;
+
+  if (rescheduleDelay >= 0) {
+    task.nextRun = finish + rescheduleDelay;  // diminta task sendiri
+    return;
+  }
+
+  // jadwal berikutnya relatif ke jatuh tempo, bukan ke waktu selesai (tanpa drift)
+  task.nextRun = release + task.period;
+  if (isDue(task, finish)) {
+    task.nextRun = finish + task.period;  // tertinggal jauh, lewati eksekusi yang hilang
+  }
+}
+
+void Scheduler::run() {
+  // Jalankan semua task yang jatuh tempo, urut prioritas.
+  // Batas iterasi = jumlah task supaya satu task tidak memonopoli loop.
+  for (int pass = 0; pass < taskCount; pass++) {
+    unsigned long now = millis();
+    int selected = -1;
+    for (int i = 0; i < taskCount; i++) {
+      if (!isDue(tasks[i], now)) continue;
+      if (selected < 0 || tasks[i].priority < tasks[selected].priority) {
+        selected = i;
+      }
+    }
+    if (selected < 0) return;
+    runTask(tasks[selected]);
+  }
+}
+
+unsigned long Scheduler::timeUntilNextTask() {
+  unsigned long now = millis();
+  unsigned long wait = MAX_IDLE_SLEEP;
+  for (int i = 0; i < taskCount; i++) {
+    if (isDue(tasks[i], now)) return 0;
+    unsigned long remaining = tasks[i].nextRun - now;
+    if (remaining < wait) wait = remaining;
+  }
+  return wait;
+}
+
+void Scheduler::sleepUntilNextTask() {
+  unsigned long wait = timeUntilNextTask();
+  if (wait > 0) {
+    delay(wait);  // delay() yield ke WiFi stack dan mengizinkan modem sleep
+  }
+  wakeCount++;
+}
+
+  // dipanggil dari dalam callback task: jalankan lagi task ini setelah delayMs,
+  // menggantikan period untuk eksekusi berikutnya saja
+void Scheduler::rescheduleCurrent(unsigned long delayMs) {
+  if (currentTask < 0) return;
+  rescheduleDelay = delayMs;
+}
+
+int Scheduler::getTaskCount() { return taskCount; }
+const SchedulerTask& Scheduler::getTask(int index) { return tasks[index]; }
+unsigned long Scheduler::getWakeCount() { return wakeCount; }
+
+void Scheduler::printStats() {
+  Serial.printf("⏱ Scheduler: %d tasks, %lu wakeups\n", taskCount, wakeCount);
+  for (int i = 0; i < taskCount; i++) {
+    Serial.printf("   %-10s runs:%lu worst:%lums overrun:%lu\n",
+                  tasks[i].name, tasks[i].runCount,
+                  tasks[i].worstRuntime, tasks[i].overrunCount);
+  }
+}
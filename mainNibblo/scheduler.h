@@ -0,0 +1,46 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+typedef void (*TaskCallback)();
+
+struct SchedulerTask {
+  const char* name;
+  TaskCallback callback;
+  unsigned long period;       // jarak antar eksekusi (ms)
+  unsigned long deadline;     // batas selesai sejak jatuh tempo (ms)
+  uint8_t priority;           // 0 = prioritas tertinggi
+  unsigned long nextRun;
+  unsigned long runCount;
+  unsigned long worstRuntime;
+  unsigned long overrunCount;
+};
+
+class Scheduler {
+private:
+  static SchedulerTask tasks[MAX_TASKS];
+  static int taskCount;
+  static int currentTask;
+  static long rescheduleDelay;
+  static unsigned long wakeCount;
+  static bool isDue(const SchedulerTask& task, unsigned long now);
+  static void runTask(SchedulerTask& task);
+
+public:
+  static int addTask(const char* name, TaskCallback callback,
+                     unsigned long period, unsigned long deadline, uint8_t priority);
+  static void run();
+  static unsigned long timeUntilNextTask();
+  static void sleepUntilNextTask();
+  static void rescheduleCurrent(unsigned long delayMs);
+
+  // Statistik
+  static int getTaskCount();
+  static const SchedulerTask& getTask(int index);
+  static unsigned long getWakeCount();
+  static void printStats();
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <Arduino.h>
+
+// Pipeline filter ukuran tetap (tanpa heap): tolak outlier -> median N sampel -> EMA.
+// Outlier = sampel yang menyimpang > outlierLimit dari median saat ini. Jika
+// ditolak maxRejects kali berturut-turut, dianggap perubahan nyata (mis. wadah
+// baru diisi) dan filter mulai ulang dari sampel tersebut.
+template <int N>
+class SensorFilter {
+private:
+  float window[N];
+  int count;
+  int head;
+  float ema;
+  float alpha;
+  float outlierLimit;
+  int maxRejects;
+  int rejectStreak;
+  unsigned long rejectedCount;
+
+  float median() const {
+    float sorted[N] = {};
+    for (int i = 0; i < count; i++) {
+      float val = window[i];
+      int j = i - 1;
+      while (j >= 0 && sorted[j] > val) {
+        sorted[j + 1] = sorted[j];
+        j--;
+      }
+      sorted[j + 1] = val;
+    }
+    if (count % 2 == 1) return sorted[count / 2];
+    return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+  }
+
+public:
+  SensorFilter(float alpha, float outlierLimit, int maxRejects = 3)
+    : count(0), head(0), ema(0), alpha(alpha), outlierLimit(outlierLimit),
+      maxRejects(maxRejects), rejectStreak(0), rejectedCount(0) {}
+
+  // false jika sampel ditolak sebagai outlier
+  bool add(float sample) {
+    if (count > 0 && fabs(sample - median()) > outlierLimit) {
+      rejectedCount++;
+      if (++rejectStreak < maxRejects) return false;
+      reset();
+    }
+    rejectStreak = 0;
+
+    window[head] = sample;
+    head = (head + 1) % N;
+    if (count < N) count++;
+
+    float med = median();
+    ema = (count == 1) ? med : ema + alpha * (med - ema);
+    return true;
+  }
+
+  void reset() {
+    count = 0;
+    head = 0;
+    rejectStreak = 0;
+  }
+
+  float value() const { return ema; }
+  bool isReady() const { return count > 0; }
+  unsigned long getRejectedCount() const { return rejectedCount; }
+};
+
+#endif
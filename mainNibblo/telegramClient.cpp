@@ -0,0 +1,397 @@
+#include "telegramClient.h"
+
+WiFiClientSecure TelegramClient::client;
+BearSSL::Session TelegramClient::session;
+TelegramClientState TelegramClient::state = TELEGRAM_IDLE;
+unsigned long TelegramClient::requestStart = 0;
+unsigned long TelegramClient::requestTimeout = TELEGRAM_RESPONSE_TIMEOUT;
+unsigned long TelegramClient::lastActivity = 0;
+bool TelegramClient::reusedConnection = false;
+bool TelegramClient::serverClose = false;
+MflnState TelegramClient::mflnState = MFLN_UNKNOWN;
+
+char TelegramClient::request[TELEGRAM_REQUEST_BUFFER];
+size_t TelegramClient::requestLength = 0;
+size_t TelegramClient::requestSent = 0;
+const char* TelegramClient::requestBody = NULL;
+size_t TelegramClient::requestBodyLength = 0;
+BodySource TelegramClient::requestSource = NULL;
+uint8_t TelegramClient::upload[TELEGRAM_UPLOAD_CHUNK];
+size_t TelegramClient::uploadLength = 0;
+size_t TelegramClient::uploadSent = 0;
+
+char TelegramClient::line[TELEGRAM_HEADER_LINE];
+size_t TelegramClient::lineLength = 0;
+int TelegramClient::statusCode = 0;
+long TelegramClient::contentLength = -1;
+bool TelegramClient::chunked = false;
+ChunkState TelegramClient::chunkState = CHUNK_SIZE;
+long TelegramClient::chunkRemaining = 0;
+
+BodySink TelegramClient::bodySink = NULL;
+long TelegramClient::bodyReceived = 0;
+bool TelegramClient::bodyPaused = false;
+
+unsigned long TelegramClient::handshakeCount = 0;
+unsigned long TelegramClient::reuseCount = 0;
+unsigned long TelegramClient::completedCount = 0;
+unsigned long TelegramClient::totalLatency = 0;
+
+void TelegramClient::init() {
+  client.setInsecure();
+  client.setTimeout(TELEGRAM_CONNECT_TIMEOUT);
+  client.setSession(&session);
+  configureBuffers();
+}
+
+void TelegramClient::configureBuffers() {
+#if TELEGRAM_TLS_BUFFER_MODE == TLS_BUFFER_REDUCED
+  // RX kecil hanya aman jika server mendukung Max Fragment Length. Probe
+  // butuh satu koneksi TLS sendiri, jadi setelah deep sleep hasil lama dipakai.
+  if (mflnState == MFLN_UNKNOWN) {
+    bool supported = client.probeMaxFragmentLength(TELEGRAM_HOST, TELEGRAM_PORT, TELEGRAM_TLS_RX_BUFFER);
+    mflnState = supported ? MFLN_SUPPORTED : MFLN_UNSUPPORTED;
+  }
+  bool mfln = mflnState == MFLN_SUPPORTED;
+  int rxSize = mfln ? TELEGRAM_TLS_RX_BUFFER : 16384;
+  client.setBufferSizes(rxSize, TELEGRAM_TLS_TX_BUFFER);
+  Serial.printf("🔐 TLS buffers: RX %d, TX %d (MFLN %s)\n",
+                rxSize, TELEGRAM_TLS_TX_BUFFER, mfln ? "yes" : "no");
+#endif
+}
+
+  // body diteruskan byte per byte ke sink; timeout diperpanjang untuk long polling
+bool TelegramClient::beginGet(const char* path, BodySink sink, unsigned long timeout) {
+  return beginRequest("GET", path, NULL, 0, sink, timeout);
+}
+
+  // payload JSON harus tetap valid sampai request selesai (tidak disalin)
+bool TelegramClient::beginPost(const char* path, const char* payload, size_t payloadLength) {
+  if (!beginRequest("POST", path, "application/json", payloadLength, NULL, TELEGRAM_RESPONSE_TIMEOUT)) {
+    return false;
+  }
+  requestBody = payload;
+  return true;
+}
+
+  // Body tidak pernah ada utuh di RAM: source dipanggil per TELEGRAM_UPLOAD_CHUNK
+  // dan harus menghasilkan tepat bodyLength byte
+bool TelegramClient::beginUpload(const char* path, const char* contentType,
+                                 size_t bodyLength, BodySource source) {
+  if (!beginRequest("POST", path, contentType, bodyLength, NULL, TELEGRAM_UPLOAD_TIMEOUT)) {
+    return false;
+  }
+  requestSource = source;
+  return true;
+}
+
+bool TelegramClient::beginRequest(const char* method, const char* path,
+                                  const char* contentType, size_t bodyLength,
+                                  BodySink sink, unsigned long timeout) {
+  if (state != TELEGRAM_IDLE) return false;
+
+  int written;
+  if (contentType != NULL) {
+    written = snprintf(request, sizeof(request),
+                       "%s %s HTTP/1.1\r\n"
+                       "Host: " TELEGRAM_HOST "\r\n"
+                       "Content-Type: %s\r\n"
+                       "Content-Length: %u\r\n"
+                       "Connection: keep-alive\r\n\r\n",
+                       method, path, contentType, (unsigned)bodyLength);
+  } else {
+    written = snprintf(request, sizeof(request),
+                       "%s %s HTTP/1.1\r\n"
+                       "Host: " TELEGRAM_HOST "\r\n"
+                       "Connection: keep-alive\r\n\r\n",
+                       method, path);
+  }
+  if (written < 0 || (size_t)written >= sizeof(request)) {
+    Serial.println("❌ Telegram request too long");
+    return false;
+  }
+
+  requestLength = written;
+  requestSent = 0;
+  requestBody = NULL;
+  requestBodyLength = contentType != NULL ? bodyLength : 0;
+  requestSource = NULL;
+  uploadLength = 0;
+  uploadSent = 0;
+  lineLength = 0;
+  statusCode = 0;
+  contentLength = -1;
+  chunked = false;
+  chunkState = CHUNK_SIZE;
+  chunkRemaining = 0;
+  bodySink = sink;
+  bodyReceived = 0;
+  bodyPaused = false;
+  serverClose = false;
+
+  // koneksi lama yang sudah idle terlalu lama kemungkinan sudah ditutup server
+  if (client.connected() && millis() - lastActivity > TELEGRAM_KEEPALIVE_TIMEOUT) {
+    client.stop();
+  }
+
+  requestStart = millis();
+  requestTimeout = timeout;
+  setState(TELEGRAM_CONNECTING);
+  return true;
+}
+
+void TelegramClient::step() {
+  unsigned long stepStart = millis();
+
+  while (millis() - stepStart < TELEGRAM_STEP_BUDGET) {
+    if (state != TELEGRAM_IDLE && state != TELEGRAM_DONE && state != TELEGRAM_ERROR &&
+        millis() - requestStart > requestTimeout) {
+      fail("timeout");
+      return;
+    }
+
+    switch (state) {
+      case TELEGRAM_CONNECTING:
+        connect();
+        return;
+
+      case TELEGRAM_SENDING: {
+        // header dulu, lalu body (jika POST)
+        size_t written;
+        if (requestSent < requestLength) {
+          written = client.write((const uint8_t*)request + requestSent,
+                                 requestLength - requestSent);
+        } else {
+          written = writeBody();
+          if (state != TELEGRAM_SENDING) return;
+        }
+        if (written == 0) {
+          if (!client.connected()) fail("send");
+          return;
+        }
+        lastActivity = millis();
+        requestSent += written;
+        if (requestSent >= requestLength + requestBodyLength) setState(TELEGRAM_WAIT_RESPONSE);
+        break;
+      }
+
+      case TELEGRAM_WAIT_RESPONSE:
+        if (!client.available()) {
+          if (!client.connected()) fail("closed");
+          return;
+        }
+        setState(TELEGRAM_READ_HEADERS);
+        break;
+
+      case TELEGRAM_READ_HEADERS:
+        if (!client.available()) return;
+        readHeaders();
+        break;
+
+      case TELEGRAM_READ_BODY:
+        if (bodyPaused) return;  // sink sedang memproses, lanjut setelah resumeBody()
+        if (chunked) readChunkedBody();
+        else readBody();
+        if (state == TELEGRAM_READ_BODY && !bodyPaused && !client.available()) {
+          // tanpa Content-Length, body selesai saat server menutup koneksi
+          if (!client.connected() && contentLength < 0 && !chunked) {
+            setState(TELEGRAM_DONE);
+          }
+          return;
+        }
+        break;
+
+      default:
+        return;
+    }
+  }
+}
+
+  // Body dari buffer (sendMessage) atau dari source per potongan (upload)
+size_t TelegramClient::writeBody() {
+  size_t bodySent = requestSent - requestLength;
+  if (requestSource == NULL) {
+    return client.write((const uint8_t*)requestBody + bodySent, requestBodyLength - bodySent);
+  }
+
+  if (uploadSent == uploadLength) {
+    size_t wanted = min(sizeof(upload), requestBodyLength - bodySent);
+    uploadLength = requestSource(upload, wanted);
+    uploadSent = 0;
+    if (uploadLength != wanted) {
+      reusedConnection = false;
+      fail("body source");  // panjang tidak sesuai Content-Length
+      return 0;
+    }
+  }
+  size_t written = client.write(upload + uploadSent, uploadLength - uploadSent);
+  uploadSent += written;
+  return written;
+}
+
+  // Pakai ulang koneksi keep-alive jika masih terbuka; jika tidak, handshake
+  // baru (dengan session resumption). Handshake BearSSL tidak bisa dipecah,
+  // jadi connect = satu step penuh.
+void TelegramClient::connect() {
+  if (client.connected()) {
+    reusedConnection = true;
+    reuseCount++;
+    setState(TELEGRAM_SENDING);
+    return;
+  }
+
+  reusedConnection = false;
+  handshakeCount++;
+  if (!client.connect(TELEGRAM_HOST, TELEGRAM_PORT)) {
+    fail("connect");
+    return;
+  }
+  lastActivity = millis();
+  setState(TELEGRAM_SENDING);
+}
+
+void TelegramClient::readHeaders() {
+  while (client.available() && state == TELEGRAM_READ_HEADERS) {
+    if (!readLine(client.read())) continue;
+
+    if (lineLength == 0) {
+      // baris kosong = akhir header
+      if (contentLength == 0 && !chunked) setState(TELEGRAM_DONE);
+      else setState(TELEGRAM_READ_BODY);
+    } else {
+      parseHeaderLine();
+    }
+    lineLength = 0;
+  }
+}
+
+  // true jika satu baris lengkap (tanpa CRLF) sudah ada di line[]
+bool TelegramClient::readLine(char c) {
+  if (c == '\r') return false;
+  if (c == '\n') {
+    line[lineLength] = '\0';
+    return true;
+  }
+  if (lineLength < sizeof(line) - 1) line[lineLength++] = c;  // header kepanjangan dipotong
+  return false;
+}
+
+void TelegramClient::parseHeaderLine() {
+  if (statusCode == 0 && strncmp(line, "HTTP/", 5) == 0) {
+    const char* code = strchr(line, ' ');
+    statusCode = code ? atoi(code + 1) : 0;
+  } else if (strncasecmp(line, "Content-Length:", 15) == 0) {
+    contentLength = atol(line + 15);
+  } else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) {
+    chunked = strstr(line + 18, "chunked") != NULL;
+  } else if (strncasecmp(line, "Connection:", 11) == 0) {
+    serverClose = strstr(line + 11, "close") != NULL;
+  }
+}
+
+void TelegramClient::storeBody(char c) {
+  bodyReceived++;
+  lastActivity = millis();
+  if (bodySink != NULL && !bodySink(c)) bodyPaused = true;
+}
+
+void TelegramClient::readBody() {
+  while (!bodyPaused && client.available() &&
+         (contentLength < 0 || bodyReceived < contentLength)) {
+    storeBody(client.read());
+  }
+  if (!bodyPaused && contentLength >= 0 && bodyReceived >= contentLength) {
+    setState(TELEGRAM_DONE);
+  }
+}
+
+void TelegramClient::readChunkedBody() {
+  while (!bodyPaused && client.available() && state == TELEGRAM_READ_BODY) {
+    char c = client.read();
+    switch (chunkState) {
+      case CHUNK_SIZE:
+        if (!readLine(c)) break;
+        chunkRemaining = strtol(line, NULL, 16);
+        lineLength = 0;
+        if (chunkRemaining == 0) {
+          setState(TELEGRAM_DONE);  // trailer diabaikan
+        } else {
+          chunkState = CHUNK_DATA;
+        }
+        break;
+
+      case CHUNK_DATA:
+        storeBody(c);
+        if (--chunkRemaining == 0) chunkState = CHUNK_CRLF;
+        break;
+
+      case CHUNK_CRLF:
+        if (c == '\n') chunkState = CHUNK_SIZE;
+        break;
+    }
+  }
+}
+
+void TelegramClient::setState(TelegramClientState next) {
+  state = next;
+  if (state == TELEGRAM_DONE) {
+    // long poll menunggu server, bukan latensi jaringan - tidak dihitung
+    if (requestTimeout == TELEGRAM_RESPONSE_TIMEOUT) {
+      completedCount++;
+      totalLatency += millis() - requestStart;
+    }
+    // body tanpa panjang diakhiri dengan close, koneksi tidak bisa dipakai lagi
+    if (serverClose || (contentLength < 0 && !chunked)) client.stop();
+  }
+}
+
+void TelegramClient::fail(const char* reason) {
+  client.stop();
+
+  // koneksi keep-alive yang ternyata sudah ditutup server: ulangi sekali
+  // dengan koneksi baru selama belum ada byte respons yang diterima.
+  // Body upload yang sudah diambil dari source tidak bisa diulang.
+  bool rewindable = requestSource == NULL || uploadLength == 0;
+  if (reusedConnection && rewindable && (state == TELEGRAM_SENDING || state == TELEGRAM_WAIT_RESPONSE)) {
+    reusedConnection = false;
+    requestSent = 0;
+    state = TELEGRAM_CONNECTING;
+    return;
+  }
+
+  Serial.printf("❌ Telegram request failed: %s\n", reason);
+  state = TELEGRAM_ERROR;
+}
+
+  // kembali ke IDLE setelah hasil (DONE/ERROR) diambil pemanggil
+void TelegramClient::finish() {
+  state = TELEGRAM_IDLE;
+}
+
+  // sink selesai memproses, lanjutkan membaca body
+void TelegramClient::resumeBody() {
+  bodyPaused = false;
+}
+
+  // batalkan request yang sedang berjalan
+void TelegramClient::abort() {
+  client.stop();
+  state = TELEGRAM_IDLE;
+}
+
+bool TelegramClient::isIdle() { return state == TELEGRAM_IDLE; }
+bool TelegramClient::isWaiting() { return state == TELEGRAM_WAIT_RESPONSE; }
+bool TelegramClient::isDone() { return state == TELEGRAM_DONE; }
+bool TelegramClient::hasError() { return state == TELEGRAM_ERROR; }
+TelegramClientState TelegramClient::getState() { return state; }
+int TelegramClient::getStatusCode() { return statusCode; }
+unsigned long TelegramClient::getHandshakeCount() { return handshakeCount; }
+unsigned long TelegramClient::getReuseCount() { return reuseCount; }
+
+unsigned long TelegramClient::getAverageLatency() {
+  if (completedCount == 0) return 0;
+  return totalLatency / completedCount;
+}
+
+MflnState TelegramClient::getMflnState() { return mflnState; }
+void TelegramClient::restoreMflnState(MflnState state) { mflnState = state; }
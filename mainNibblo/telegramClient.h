@@ -0,0 +1,120 @@
+#ifndef TELEGRAM_CLIENT_H
+#define TELEGRAM_CLIENT_H
+
+#include <ESP8266WiFi.h>
+#include <WiFiClientSecure.h>
+#include "config.h"
+
+enum TelegramClientState {
+  TELEGRAM_IDLE,
+  TELEGRAM_CONNECTING,
+  TELEGRAM_SENDING,
+  TELEGRAM_WAIT_RESPONSE,
+  TELEGRAM_READ_HEADERS,
+  TELEGRAM_READ_BODY,
+  TELEGRAM_DONE,
+  TELEGRAM_ERROR
+};
+
+// Penerima body respons; return false = berhenti membaca sampai resumeBody()
+typedef bool (*BodySink)(char c);
+
+// Sumber body request upload; isi buffer, return jumlah byte (0 = gagal/habis)
+typedef size_t (*BodySource)(uint8_t* buffer, size_t size);
+
+enum MflnState {
+  MFLN_UNKNOWN,
+  MFLN_SUPPORTED,
+  MFLN_UNSUPPORTED
+};
+
+enum ChunkState {
+  CHUNK_SIZE,
+  CHUNK_DATA,
+  CHUNK_CRLF
+};
+
+// Request HTTPS ke Bot API yang bisa dilanjutkan sedikit demi sedikit:
+// beginGet() menyiapkan request, step() memajukan connect -> send -> receive
+// dalam batas TELEGRAM_STEP_BUDGET ms per panggilan, lalu isDone()/hasError().
+class TelegramClient {
+private:
+  static WiFiClientSecure client;
+  static BearSSL::Session session;    // TLS session resumption antar koneksi
+  static TelegramClientState state;
+  static unsigned long requestStart;
+  static unsigned long requestTimeout;
+  static unsigned long lastActivity;
+  static bool reusedConnection;
+  static bool serverClose;
+  static MflnState mflnState;         // hasil probe, dibawa lewat deep sleep
+
+  static char request[TELEGRAM_REQUEST_BUFFER];
+  static size_t requestLength;
+  static size_t requestSent;
+  static const char* requestBody;
+  static size_t requestBodyLength;
+  static BodySource requestSource;    // body dibangkitkan sambil dikirim (upload)
+  static uint8_t upload[TELEGRAM_UPLOAD_CHUNK];
+  static size_t uploadLength;
+  static size_t uploadSent;
+
+  static char line[TELEGRAM_HEADER_LINE];
+  static size_t lineLength;
+  static int statusCode;
+  static long contentLength;
+  static bool chunked;
+  static ChunkState chunkState;
+  static long chunkRemaining;
+
+  static BodySink bodySink;       // NULL = body dibuang (cukup status code)
+  static long bodyReceived;
+  static bool bodyPaused;
+
+  // statistik
+  static unsigned long handshakeCount;
+  static unsigned long reuseCount;
+  static unsigned long completedCount;
+  static unsigned long totalLatency;
+
+  static bool beginRequest(const char* method, const char* path,
+                           const char* contentType, size_t bodyLength,
+                           BodySink sink, unsigned long timeout);
+  static size_t writeBody();
+  static void configureBuffers();
+  static void connect();
+  static void setState(TelegramClientState next);
+  static void fail(const char* reason);
+  static bool readLine(char c);
+  static void parseHeaderLine();
+  static void storeBody(char c);
+  static void readHeaders();
+  static void readBody();
+  static void readChunkedBody();
+
+public:
+  static void init();
+  static bool beginGet(const char* path, BodySink sink,
+                       unsigned long timeout = TELEGRAM_RESPONSE_TIMEOUT);
+  static bool beginPost(const char* path, const char* payload, size_t payloadLength);
+  static bool beginUpload(const char* path, const char* contentType,
+                          size_t bodyLength, BodySource source);
+  static void step();
+  static void finish();
+  static void abort();
+  static void resumeBody();
+
+  static bool isIdle();
+  static bool isWaiting();
+  static bool isDone();
+  static bool hasError();
+  static TelegramClientState getState();
+  static int getStatusCode();
+  static unsigned long getHandshakeCount();
+  static unsigned long getReuseCount();
+  static unsigned long getAverageLatency();
+  static MflnState getMflnState();
+  static void restoreMflnState(MflnState state);
+};
+
+#endif
@@ -3,344 +3,756 @@
 #include "timeManager.h"
 #include "dataLogger.h"
 #include "powerManager.h"
+#include "scheduler.h"
+#include "recordStore.h"
+#include "profiler.h"
+#include "memoryMonitor.h"
+
+#define COMMAND_INDEX_SIZE (1 << COMMAND_INDEX_BITS)
+#define COMMAND_EMPTY 0xFF
+
+  // FNV-1a dengan basis digeser seed; slot diambil dari bit atas
+constexpr uint32_t commandHash(const char* text, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ seed;
+  for (; *text; text++) hash = (hash ^ (uint8_t)*text) * 16777619u;
+  return hash;
+}
+
+constexpr uint32_t commandSlot(const char* text, uint32_t seed) {
+  return commandHash(text, seed) >> (32 - COMMAND_INDEX_BITS);
+}
+
+  // Dievaluasi saat kompilasi: cari seed pertama yang memberi tiap alias slot unik
+constexpr CommandIndex buildCommandIndex(const CommandEntry* entries, size_t count) {
+  for (uint32_t seed = 1; seed < 1000; seed++) {
+    CommandIndex index = {};
+    index.seed = seed;
+    for (uint8_t& slot : index.slots) slot = COMMAND_EMPTY;
+    
+    bool collision = false;
+    for (size_t i = 0; i < count && !collision; i++) {
+      uint32_t slot = commandSlot(entries[i].alias, seed);
+      if (index.slots[slot] != COMMAND_EMPTY) collision = true;
+      else index.slots[slot] = i;
+    }
+    if (!collision) return index;
+  }
+  return CommandIndex{};
+}
 
 // Static variables
-WiFiClientSecure TelegramHandler::secured_client;
-UniversalTelegramBot TelegramHandler::bot(BOT_TOKEN, secured_client);
-unsigned long TelegramHandler::lastCheckTime = 0;
+TelegramRequest TelegramHandler::activeRequest = REQUEST_NONE;
+unsigned long TelegramHandler::lastPollTime = 0;
+long TelegramHandler::lastUpdateId = 0;
+bool TelegramHandler::morePending = false;
+bool TelegramHandler::pollFailed = false;
+unsigned long TelegramHandler::completedPolls = 0;
 bool TelegramHandler::waitingForTimeInput = false;
-String TelegramHandler::pendingChatId = "";
+char TelegramHandler::pendingChatId[TELEGRAM_CHAT_ID_SIZE] = "";
+
+// Perintah baru = satu baris di sini. Alias huruf kecil (teks pesan
+// di-lowercase sebelum dicari), termasuk label tombol keyboard.
+constexpr CommandEntry TelegramHandler::commands[] = {
+  {"/start",            sendMenuKeyboard},
+  {"/menu",             sendMenuKeyboard},
+  {"/status",           cmdStatus},
+  {"📊 status",         cmdStatus},
+  {"/makan",            cmdFeed},
+  {"🍽 feed now",       cmdFeed},
+  {"/info makan",       cmdFoodInfo},
+  {"🍽 food info",      cmdFoodInfo},
+  {"/info minum",       cmdWaterInfo},
+  {"💧 water info",     cmdWaterInfo},
+  {"/setwaktu",         sendTimeMenuKeyboard},
+  {"⏰ schedule",       sendTimeMenuKeyboard},
+  {"/tambah jadwal",    cmdAddSchedule},
+  {"➕ add schedule",   cmdAddSchedule},
+  {"/lihat jadwal",     cmdViewSchedule},
+  {"📋 view schedule",  cmdViewSchedule},
+  {"/hapus jadwal",     cmdClearSchedule},
+  {"🗑 clear schedule", cmdClearSchedule},
+  {"/system",           sendSystemMenuKeyboard},
+  {"⚙ system",          sendSystemMenuKeyboard},
+  {"/logs",             cmdLogs},
+  {"📝 logs",           cmdLogs},
+  {"/export",           cmdExport},
+  {"📦 export",         cmdExport},
+  {"/sysinfo",          cmdSysInfo},
+  {"ℹ system info",     cmdSysInfo},
+  {"/mem",              cmdMem},
+  {"💾 memory",         cmdMem},
+  {"/perf",             cmdPerf},
+  {"/perf reset",       cmdPerfReset},
+  {"/reboot",           cmdReboot},
+  {"🔄 reboot",         cmdReboot},
+  {"/kembali",          cmdBack},
+  {"🔙 back",           cmdBack},
+};
+
+constexpr CommandIndex TelegramHandler::commandIndex =
+  buildCommandIndex(commands, sizeof(commands) / sizeof(commands[0]));
 
 void TelegramHandler::init() {
-  secured_client.setInsecure();
+  TelegramClient::init();
   Serial.println("✅ Telegram Handler initialized");
 }
 
+  // Satu langkah komunikasi Telegram: poll getUpdates atau kirim satu pesan
+  // dari MessageQueue. Dipanggil scheduler; selama request berjalan dipanggil
+  // lagi tiap TELEGRAM_STEP_INTERVAL (lihat getServiceDelay()) supaya HTTPS
+  // berjalan sedikit-sedikit tanpa menahan jadwal makan, display dan sensor.
 void TelegramHandler::checkMessages() {
-  if (WiFi.status() != WL_CONNECTED) return;
+  PROFILE_SCOPE(PROFILE_TELEGRAM);
+  LogExporter::measureStep();  // pass 1 ekspor berjalan bertahap di sini juga
   
-  if (millis() - lastCheckTime > BOT_CHECK_INTERVAL) {
-    int numNewMessages = bot.getUpdates(bot.last_message_received + 1);
-    while (numNewMessages) {
-      handleNewMessages(numNewMessages);
-      numNewMessages = bot.getUpdates(bot.last_message_received + 1);
+  if (shouldInterruptPoll()) {
+    // offset belum maju, update yang tertunda akan diambil di poll berikutnya
+    TelegramClient::abort();
+    activeRequest = REQUEST_NONE;
+  }
+  
+  if (TelegramClient::isIdle()) {
+    if (WiFi.status() != WL_CONNECTED) {
+      morePending = false;  // pesan keluar tetap di antrian sampai WiFi kembali
+      return;
     }
-    lastCheckTime = millis();
+    // kirim dulu: dengan long polling poll selalu jatuh tempo
+    if (MessageQueue::isReady()) startSend();
+    else if (LogExporter::isReady()) startUpload();
+    else if (isPollDue()) startPoll();
+    else return;
+  }
+  
+  {
+    MEM_TRACK(MEM_SITE_TELEGRAM_STEP);
+    TelegramClient::step();
+  }
+  // socket yang hanya menunggu long poll tidak dihitung aktivitas radio,
+  // supaya sampling baterai tetap mendapat jendela idle
+  if (!TelegramClient::isWaiting()) Hardware::notifyRadioActivity();
+  
+  if (activeRequest == REQUEST_POLL && UpdateParser::hasUpdate()) {
+    dispatchUpdate();  // membaca body berlanjut di step berikutnya
+    return;
   }
+  
+  if (!TelegramClient::isDone() && !TelegramClient::hasError()) return;
+  
+  if (activeRequest == REQUEST_POLL) {
+    pollFailed = TelegramClient::hasError() || TelegramClient::getStatusCode() != 200;
+    if (TelegramClient::isDone() && pollFailed) {
+      Serial.printf("❌ getUpdates HTTP %d\n", TelegramClient::getStatusCode());
+    }
+    // update penuh = kemungkinan masih ada antrian, langsung poll lagi
+    morePending = !pollFailed && UpdateParser::getUpdateCount() >= TELEGRAM_UPDATE_LIMIT;
+    if (!pollFailed) completedPolls++;
+  } else if (activeRequest == REQUEST_SEND) {
+    finishSend();
+  } else if (activeRequest == REQUEST_UPLOAD) {
+    finishUpload();
+  }
+  activeRequest = REQUEST_NONE;
+  TelegramClient::finish();
 }
 
-void TelegramHandler::handleNewMessages(int numNewMessages) {
-  for (int i = 0; i < numNewMessages; i++) {
-    String chat_id = bot.messages[i].chat_id;
-    String text = bot.messages[i].text;
-    
-    // Security check
-    if (!isAuthorizedUser(chat_id)) {
-      sendMessage(chat_id, "❌ Unauthorized access");
-      continue;
-    }
-    
-    text.trim();
-    text.toLowerCase();
-    
-    Serial.println("📩 Telegram: [" + text + "] from " + chat_id);
-    PowerManager::updateActivity(); // Update activity for power management
-    
-    if (waitingForTimeInput && chat_id == pendingChatId) {
-      processTimeInput(chat_id, text);
-    } else {
-      processCommand(chat_id, text);
+  // kapan checkMessages() perlu dipanggil lagi (ms)
+unsigned long TelegramHandler::getServiceDelay() {
+  if (LogExporter::isMeasuring()) return TELEGRAM_STEP_INTERVAL;
+#if TELEGRAM_LONG_POLL
+  // menunggu long poll: cek socket lebih jarang, tapi tetap bangun untuk outbox
+  if (activeRequest == REQUEST_POLL && TelegramClient::isWaiting()) {
+    unsigned long wait = TELEGRAM_LONG_POLL_STEP;
+    if (!MessageQueue::isEmpty()) {
+      wait = max(min(wait, MessageQueue::timeUntilReady()), (unsigned long)TELEGRAM_STEP_INTERVAL);
     }
+    return wait;
   }
+#endif
+  if (!TelegramClient::isIdle() || morePending) return TELEGRAM_STEP_INTERVAL;
+  
+  unsigned long interval = (TELEGRAM_LONG_POLL && !pollFailed) ? 0 : BOT_CHECK_INTERVAL;
+  unsigned long sincePoll = millis() - lastPollTime;
+  unsigned long wait = sincePoll < interval ? interval - sincePoll : 0;
+  if (!MessageQueue::isEmpty() && WiFi.status() == WL_CONNECTED) {
+    wait = min(wait, MessageQueue::timeUntilReady());
+  }
+  return max(wait, (unsigned long)TELEGRAM_STEP_INTERVAL);
 }
 
-void TelegramHandler::processCommand(String chat_id, String text) {
-  if (text == "/start" || text == "/menu") {
-    sendMenuKeyboard(chat_id);
-    
-  } else if (text == "/status" || text == "📊 status") {
-    sendMessage(chat_id, formatStatusMessage());
-    
-  } else if (text == "/makan" || text == "🍽 feed now") {
-    Hardware::readAllSensors(); // Update sensor readings
-    bool success = Hardware::feedHamster();
-    if (success) {
-      DataLogger::logFeeding("MANUAL", TimeManager::getCurrentTime());
-      sendFeedingResult(true);
-    } else {
-      sendFeedingResult(false, "Food level too low or battery critical");
-    }
-    
-  } else if (text == "/info makan" || text == "🍽 food info") {
-    Hardware::readAllSensors();
-    String msg = "📦 Food Status\n";
-    msg += "Level: " + String(Hardware::getFoodLevel()) + "%\n";
-    msg += "Total feeds: " + String(DataLogger::getTotalFeeds()) + "\n";
-    if (Hardware::getFoodLevel() < FOOD_CRITICAL_THRESHOLD) {
-      msg += "⚠ CRITICAL - Refill needed!";
-    } else if (Hardware::getFoodLevel() < FOOD_WARNING_THRESHOLD) {
-      msg += "⚠ LOW - Consider refilling";
-    } else {
-      msg += "✅ Level OK";
+  // Kirim seluruh antrian secara blocking (maks timeout ms), dipakai sebelum
+  // restart supaya pesan terakhir tidak hilang. Poll yang berjalan dibatalkan.
+void TelegramHandler::flushMessages(unsigned long timeout) {
+  unsigned long start = millis();
+  if (activeRequest == REQUEST_POLL || activeRequest == REQUEST_UPLOAD) {
+    TelegramClient::abort();
+    activeRequest = REQUEST_NONE;
+    morePending = false;
+  }
+  LogExporter::finish();
+  
+  while (millis() - start < timeout && WiFi.status() == WL_CONNECTED) {
+    if (activeRequest == REQUEST_NONE) {
+      if (MessageQueue::isEmpty()) return;
+      startSend();
+      continue;
     }
-    sendMessage(chat_id, msg, "Markdown");
-    
-  } else if (text == "/info minum" || text == "💧 water info") {
-    Hardware::readAllSensors();
-    String msg = "💧 Water Status\n";
-    msg += "Level: " + String(Hardware::getWaterLevel()) + "%\n";
-    if (Hardware::getWaterLevel() < WATER_CRITICAL_THRESHOLD) {
-      msg += "⚠ CRITICAL - Refill needed!";
-    } else if (Hardware::getWaterLevel() < WATER_WARNING_THRESHOLD) {
-      msg += "⚠ LOW - Consider refilling";
+    TelegramClient::step();
+    if (TelegramClient::isDone() || TelegramClient::hasError()) {
+      finishSend();
+      activeRequest = REQUEST_NONE;
+      TelegramClient::finish();
     } else {
-      msg += "✅ Level OK";
+      delay(TELEGRAM_STEP_INTERVAL);
     }
-    sendMessage(chat_id, msg, "Markdown");
-    
-  } else if (text == "/setwaktu" || text == "⏰ schedule") {
-    sendTimeMenuKeyboard(chat_id);
-    
-  } else if (text == "/tambah jadwal" || text == "➕ add schedule") {
-    waitingForTimeInput = true;
-    pendingChatId = chat_id;
-    sendMessage(chat_id, "⏰ Send time in HH:MM format (24 hour)\nExample: 08:30 or 15:45", "Markdown");
-    
-  } else if (text == "/lihat jadwal" || text == "📋 view schedule") {
-    sendMessage(chat_id, TimeManager::getScheduleList());
-    
-  } else if (text == "/hapus jadwal" || text == "🗑 clear schedule") {
-    TimeManager::clearAllSchedules();
-    sendMessage(chat_id, "🗑 All schedules cleared successfully!");
-    
-  } else if (text == "/system" || text == "⚙ system") {
-    sendSystemMenuKeyboard(chat_id);
-    
-  } else if (text == "/logs" || text == "📝 logs") {
-    sendMessage(chat_id, DataLogger::getDataSummary());
-    
-  } else if (text == "/sysinfo" || text == "ℹ system info") {
-    sendMessage(chat_id, formatSystemInfo());
-    
-  } else if (text == "/reboot" || text == "🔄 reboot") {
-    sendMessage(chat_id, "🔄 Rebooting system...");
-    delay(1000);
-    ESP.restart();
-    
-  } else if (text == "/kembali" || text == "🔙 back") {
-    waitingForTimeInput = false;
-    pendingChatId = "";
-    sendMenuKeyboard(chat_id);
-    
+  }
+}
+
+  // Tidak ada yang hilang jika deep sleep sekarang: sudah poll sejak bangun,
+  // outbox & ekspor kosong, request yang berjalan hanya long poll yang menunggu
+  // (offset di poll itu sudah mengonfirmasi update sebelumnya)
+bool TelegramHandler::isQuiet() {
+  if (completedPolls == 0 || morePending || !MessageQueue::isEmpty() || !LogExporter::isIdle()) {
+    return false;
+  }
+  return TelegramClient::isIdle() || (activeRequest == REQUEST_POLL && TelegramClient::isWaiting());
+}
+
+void TelegramHandler::prepareSleep() {
+  flushMessages(TELEGRAM_RESPONSE_TIMEOUT);  // juga membatalkan poll yang menunggu
+}
+
+  // offset getUpdates dibawa lewat RTC memory; tanpa ini update terakhir
+  // dikirim ulang setelah bangun dan perintahnya dijalankan dua kali
+long TelegramHandler::getLastUpdateId() {
+  return lastUpdateId;
+}
+
+void TelegramHandler::restoreLastUpdateId(long updateId) {
+  lastUpdateId = updateId;
+}
+
+  // Long polling: poll baru langsung setelah yang lama selesai; setelah
+  // error kembali ke jeda BOT_CHECK_INTERVAL supaya tidak reconnect beruntun.
+bool TelegramHandler::isPollDue() {
+  if (morePending) return true;
+  if (TELEGRAM_LONG_POLL && !pollFailed) return true;
+  return millis() - lastPollTime >= BOT_CHECK_INTERVAL;
+}
+
+  // Pesan keluar tidak menunggu long poll habis: poll yang belum menerima
+  // respons dibatalkan. Respons yang sudah mulai masuk dibiarkan selesai.
+bool TelegramHandler::shouldInterruptPoll() {
+#if TELEGRAM_LONG_POLL
+  return activeRequest == REQUEST_POLL && TelegramClient::isWaiting() &&
+         (MessageQueue::isReady() || LogExporter::isReady()) && WiFi.status() == WL_CONNECTED;
+#else
+  return false;
+#endif
+}
+
+void TelegramHandler::startPoll() {
+  char path[TELEGRAM_REQUEST_BUFFER / 2];
+#if TELEGRAM_LONG_POLL
+  // duty cycle: poll pertama setelah bangun tidak ditahan server supaya
+  // siklus bangun tetap singkat
+  int pollTimeout = (DUTY_CYCLE_ENABLED && completedPolls == 0) ? 0 : TELEGRAM_LONG_POLL_TIMEOUT;
+  snprintf(path, sizeof(path), "/bot" BOT_TOKEN "/getUpdates?offset=%ld&limit=%d&timeout=%d",
+           lastUpdateId + 1, TELEGRAM_UPDATE_LIMIT, pollTimeout);
+  unsigned long timeout = pollTimeout * 1000UL + TELEGRAM_RESPONSE_TIMEOUT;
+#else
+  snprintf(path, sizeof(path), "/bot" BOT_TOKEN "/getUpdates?offset=%ld&limit=%d",
+           lastUpdateId + 1, TELEGRAM_UPDATE_LIMIT);
+  unsigned long timeout = TELEGRAM_RESPONSE_TIMEOUT;
+#endif
+  UpdateParser::reset();
+  if (TelegramClient::beginGet(path, UpdateParser::feed, timeout)) {
+    activeRequest = REQUEST_POLL;
+    lastPollTime = millis();
+  }
+}
+
+void TelegramHandler::startSend() {
+  size_t length;
+  const char* payload = MessageQueue::buildPayload(length);
+  if (TelegramClient::beginPost("/bot" BOT_TOKEN "/sendMessage", payload, length)) {
+    activeRequest = REQUEST_SEND;
+  } else {
+    MessageQueue::markFailed(false);
+  }
+}
+
+void TelegramHandler::finishSend() {
+  int status = TelegramClient::getStatusCode();
+  if (TelegramClient::isDone() && status == 200) {
+    MessageQueue::markSent();
+    Serial.println("✅ Message sent successfully");
+    return;
+  }
+  
+  // 429 / 5xx / error jaringan = coba lagi, 4xx lain (mis. Markdown salah) dibuang
+  bool retry = TelegramClient::hasError() || status == 429 || status >= 500;
+  Serial.printf("❌ sendMessage failed (HTTP %d)%s\n", status, retry ? " - will retry" : "");
+  MessageQueue::markFailed(retry);
+}
+
+void TelegramHandler::startUpload() {
+  LogExporter::startUpload();
+  if (TelegramClient::beginUpload("/bot" BOT_TOKEN "/sendDocument", LogExporter::getContentType(),
+                                  LogExporter::getContentLength(), LogExporter::readBody)) {
+    activeRequest = REQUEST_UPLOAD;
+  } else {
+    LogExporter::finish();
+  }
+}
+
+void TelegramHandler::finishUpload() {
+  int status = TelegramClient::getStatusCode();
+  if (TelegramClient::isDone() && status == 200) {
+    Serial.println("✅ Export uploaded");
+  } else {
+    Serial.printf("❌ sendDocument failed (HTTP %d)\n", status);
+    sendMessage(LogExporter::getChatId(), "❌ Export upload failed, try /export again");
+  }
+  LogExporter::finish();
+}
+
+  // Satu update dari parser streaming: majukan offset, jalankan pesannya,
+  // lalu lepas parser supaya TelegramClient lanjut membaca body.
+void TelegramHandler::dispatchUpdate() {
+  if (UpdateParser::getUpdateId() > lastUpdateId) {
+    lastUpdateId = UpdateParser::getUpdateId();
+  }
+  if (UpdateParser::hasMessageText()) {  // update selain pesan teks dilewati
+    handleNewMessage(UpdateParser::getChatId(), UpdateParser::getText());
+  }
+  UpdateParser::release();
+  TelegramClient::resumeBody();
+}
+
+void TelegramHandler::handleNewMessage(const char* chat_id, char* text) {
+  MEM_TRACK(MEM_SITE_TELEGRAM_COMMAND);
+  // Security check
+  if (!isAuthorizedUser(chat_id)) {
+    sendMessage(chat_id, "❌ Unauthorized access");
+    return;
+  }
+  
+  // trim + lowercase di tempat (ASCII saja, emoji tidak berubah)
+  while (isspace((unsigned char)*text)) text++;
+  size_t length = strlen(text);
+  while (length > 0 && isspace((unsigned char)text[length - 1])) text[--length] = '\0';
+  for (char* c = text; *c; c++) *c = tolower((unsigned char)*c);
+  
+  Serial.printf("📩 Telegram: [%s] from %s\n", text, chat_id);
+  PowerManager::updateActivity(); // Update activity for power management
+  
+  if (waitingForTimeInput && strcmp(chat_id, pendingChatId) == 0) {
+    processTimeInput(chat_id, text);
+  } else {
+    processCommand(chat_id, text);
+  }
+}
+
+  // O(1): satu hash + satu strcmp untuk memastikan bukan tabrakan
+CommandHandler TelegramHandler::findCommand(const char* text) {
+  static_assert(sizeof(commands) / sizeof(commands[0]) < COMMAND_EMPTY, "too many commands");
+  static_assert(commandIndex.seed != 0, "no collision-free seed, raise COMMAND_INDEX_BITS");
+  
+  uint8_t entry = commandIndex.slots[commandSlot(text, commandIndex.seed)];
+  if (entry == COMMAND_EMPTY || strcmp(commands[entry].alias, text) != 0) return NULL;
+  return commands[entry].handler;
+}
+
+void TelegramHandler::processCommand(const char* chat_id, const char* text) {
+  CommandHandler handler = findCommand(text);
+  if (handler != NULL) {
+    handler(chat_id);
   } else {
     sendMessage(chat_id, "❓ Unknown command. Use /menu to see available options.");
   }
 }
 
-void TelegramHandler::processTimeInput(String chat_id, String text) {
+void TelegramHandler::cmdStatus(const char* chat_id) {
+  MessageBuffer msg;
+  formatStatusMessage(msg);
+  sendMessage(chat_id, msg.c_str());
+}
+
+  // Level makanan = nilai cache sensorTask (paling lama SENSOR_READ_INTERVAL);
+  // readAllSensors() hanya memulai ping, hasilnya baru ada di pass berikutnya
+void TelegramHandler::cmdFeed(const char* chat_id) {
+  (void)chat_id;  // hasil dikirim sendFeedingResult() ke CHAT_ID, sama seperti feed otomatis
+  bool success = Hardware::feedHamster();
+  if (success) {
+    char timeStr[6];
+    TimeManager::getCurrentTime(timeStr, sizeof(timeStr));
+    DataLogger::logFeeding("MANUAL", timeStr);
+    sendFeedingResult(true);
+  } else {
+    sendFeedingResult(false, "Food level too low or battery critical");
+  }
+}
+
+void TelegramHandler::cmdFoodInfo(const char* chat_id) {
+  MessageBuffer msg;
+  msg.append("📦 Food Status\n");
+  msg.appendf("Level: %d%% (%lus ago)\n", Hardware::getFoodLevel(), Hardware::getLevelAge());
+  msg.appendf("Total feeds: %d\n", DataLogger::getTotalFeeds());
+  appendLevelStatus(msg, Hardware::getFoodLevel(), FOOD_WARNING_THRESHOLD, FOOD_CRITICAL_THRESHOLD);
+  sendMessage(chat_id, msg.c_str(), "Markdown");
+}
+
+void TelegramHandler::cmdWaterInfo(const char* chat_id) {
+  MessageBuffer msg;
+  msg.append("💧 Water Status\n");
+  msg.appendf("Level: %d%% (%lus ago)\n", Hardware::getWaterLevel(), Hardware::getLevelAge());
+  appendLevelStatus(msg, Hardware::getWaterLevel(), WATER_WARNING_THRESHOLD, WATER_CRITICAL_THRESHOLD);
+  sendMessage(chat_id, msg.c_str(), "Markdown");
+}
+
+void TelegramHandler::cmdAddSchedule(const char* chat_id) {
+  waitingForTimeInput = true;
+  strncpy(pendingChatId, chat_id, sizeof(pendingChatId) - 1);
+  pendingChatId[sizeof(pendingChatId) - 1] = '\0';
+  sendMessage(chat_id, "⏰ Send time in HH:MM format (24 hour)\nExample: 08:30 or 15:45", "Markdown");
+}
+
+void TelegramHandler::cmdViewSchedule(const char* chat_id) {
+  MessageBuffer msg;
+  TimeManager::getScheduleList(msg);
+  sendMessage(chat_id, msg.c_str());
+}
+
+void TelegramHandler::cmdClearSchedule(const char* chat_id) {
+  TimeManager::clearAllSchedules();
+  sendMessage(chat_id, "🗑 All schedules cleared successfully!");
+}
+
+void TelegramHandler::cmdLogs(const char* chat_id) {
+  MessageBuffer msg;
+  DataLogger::getDataSummary(msg);
+  sendMessage(chat_id, msg.c_str());
+}
+
+  // Dikirim sebagai dokumen setelah kompresi selesai (lihat LogExporter)
+void TelegramHandler::cmdExport(const char* chat_id) {
+  if (!LogExporter::isIdle()) {
+    sendMessage(chat_id, "⏳ Export already in progress");
+  } else if (DataLogger::getHistoryCount() == 0) {
+    sendMessage(chat_id, "📭 No sensor history to export yet");
+  } else if (LogExporter::begin(chat_id)) {
+    sendMessage(chat_id, "📦 Preparing log export...");
+  } else {
+    sendMessage(chat_id, "❌ Export could not be started");
+  }
+}
+
+void TelegramHandler::cmdSysInfo(const char* chat_id) {
+  MessageBuffer msg;
+  formatSystemInfo(msg);
+  sendMessage(chat_id, msg.c_str());
+}
+
+void TelegramHandler::cmdMem(const char* chat_id) {
+  MessageBuffer msg;
+  MemoryMonitor::formatReport(msg);
+  MemoryMonitor::printStats();
+  sendMessage(chat_id, msg.c_str());
+}
+
+  // Histogram lengkap ke Serial, ringkasan per tahap ke chat
+void TelegramHandler::cmdPerf(const char* chat_id) {
+#if PROFILER_ENABLED
+  MessageBuffer msg;
+  Profiler::formatReport(msg);
+  Profiler::printStats();
+  sendMessage(chat_id, msg.c_str());
+#else
+  sendMessage(chat_id, "⏱ Profiler disabled (build with PROFILER_ENABLED=1)");
+#endif
+}
+
+void TelegramHandler::cmdPerfReset(const char* chat_id) {
+#if PROFILER_ENABLED
+  Profiler::reset();
+  sendMessage(chat_id, "⏱ Profiler statistics cleared");
+#else
+  sendMessage(chat_id, "⏱ Profiler disabled (build with PROFILER_ENABLED=1)");
+#endif
+}
+
+void TelegramHandler::cmdReboot(const char* chat_id) {
+  sendMessage(chat_id, "🔄 Rebooting system...");
+  flushMessages(TELEGRAM_RESPONSE_TIMEOUT);
+  Hal::restart();
+}
+
+void TelegramHandler::cmdBack(const char* chat_id) {
   waitingForTimeInput = false;
-  pendingChatId = "";
+  pendingChatId[0] = '\0';
+  sendMenuKeyboard(chat_id);
+}
+
+void TelegramHandler::processTimeInput(const char* chat_id, const char* input) {
+  waitingForTimeInput = false;
+  pendingChatId[0] = '\0';
   
-  text.trim();
+  String text = input;
   if (text.length() == 4 && text.indexOf(':') == 1) {
     text = "0" + text; // Convert H:MM to HH:MM
   }
   
   if (TimeManager::isValidTimeFormat(text)) {
     TimeManager::addSchedule(text, true);
-    sendMessage(chat_id, "✅ Schedule " + text + " added successfully!", "Markdown");
-    sendDebugInfo("Schedule added: " + text);
+    MessageBuffer msg;
+    msg.appendf("✅ Schedule %s added successfully!", text.c_str());
+    sendMessage(chat_id, msg.c_str(), "Markdown");
+    sendDebugInfo("Schedule added: %s", text.c_str());
   } else {
     sendMessage(chat_id, "❌ Invalid time format. Use HH:MM (24 hour format)\nExample: 08:30 or 15:45");
   }
 }
 
-void TelegramHandler::sendMenuKeyboard(String chat_id) {
+void TelegramHandler::sendMenuKeyboard(const char* chat_id) {
   // Format keyboard seperti contoh yang berhasil - TANPA wrapper "keyboard"
-  String keyboardJson = "[[{\"text\":\"📊 Status\"},{\"text\":\"🍽 Feed Now\"}],"
+  const char* keyboardJson = "[[{\"text\":\"📊 Status\"},{\"text\":\"🍽 Feed Now\"}],"
                        "[{\"text\":\"🍽 Food Info\"},{\"text\":\"💧 Water Info\"}],"
                        "[{\"text\":\"⏰ Schedule\"},{\"text\":\"⚙ System\"}]]";
   
-  bot.sendMessageWithReplyKeyboard(chat_id, 
+  sendMessageWithKeyboard(chat_id, 
     "🐹 *HAMSTER FEEDER CONTROL*\nChoose an option below:", 
-    "Markdown", 
-    keyboardJson, 
-    true);
+    keyboardJson);
 }
 
-void TelegramHandler::sendTimeMenuKeyboard(String chat_id) {
+void TelegramHandler::sendTimeMenuKeyboard(const char* chat_id) {
   // Format keyboard seperti contoh yang berhasil
-  String keyboardJson = "[[{\"text\":\"➕ Add Schedule\"}],"
+  const char* keyboardJson = "[[{\"text\":\"➕ Add Schedule\"}],"
                        "[{\"text\":\"📋 View Schedule\"}],"
                        "[{\"text\":\"🗑 Clear Schedule\"}],"
                        "[{\"text\":\"🔙 Back\"}]]";
   
-  bot.sendMessageWithReplyKeyboard(chat_id, 
+  sendMessageWithKeyboard(chat_id, 
     "⏰ *SCHEDULE MANAGEMENT*\nChoose an option:", 
-    "Markdown", 
-    keyboardJson, 
-    true);
+    keyboardJson);
 }
 
-void TelegramHandler::sendSystemMenuKeyboard(String chat_id) {
+void TelegramHandler::sendSystemMenuKeyboard(const char* chat_id) {
   // Format keyboard seperti contoh yang berhasil
-  String keyboardJson = "[[{\"text\":\"📝 Logs\"},{\"text\":\"ℹ System Info\"}],"
-                       "[{\"text\":\"🔄 Reboot\"}],"
-                       "[{\"text\":\"🔙 Back\"}]]";
+  const char* keyboardJson = "[[{\"text\":\"📝 Logs\"},{\"text\":\"ℹ System Info\"}],"
+                       "[{\"text\":\"📦 Export\"},{\"text\":\"💾 Memory\"}],"
+                       "[{\"text\":\"🔄 Reboot\"},{\"text\":\"🔙 Back\"}]]";
   
-  bot.sendMessageWithReplyKeyboard(chat_id, 
+  sendMessageWithKeyboard(chat_id, 
     "⚙ *SYSTEM MANAGEMENT*\nAdvanced system options:", 
-    "Markdown", 
-    keyboardJson, 
-    true);
+    keyboardJson);
+}
+
+void TelegramHandler::appendLevelStatus(MessageBuffer& msg, int level, int warning, int critical) {
+  if (level < critical) {
+    msg.append("⚠ CRITICAL - Refill needed!");
+  } else if (level < warning) {
+    msg.append("⚠ LOW - Consider refilling");
+  } else {
+    msg.append("✅ Level OK");
+  }
 }
 
-String TelegramHandler::formatStatusMessage() {
-  Hardware::readAllSensors(); // Ensure fresh data
+  // Semua nilai sensor dari cache (sensorTask), umur bacaan ikut ditampilkan
+void TelegramHandler::formatStatusMessage(MessageBuffer& status) {
+  char timeStr[20];
+  TimeManager::getCurrentTimeString(timeStr, sizeof(timeStr));
   
-  String status = "📊 SYSTEM STATUS\n\n";
+  status.append("📊 SYSTEM STATUS\n\n");
   
   // Time info
-  status += "🕐 Time: " + TimeManager::getCurrentTimeString() + "\n";
-  status += "⚡ WiFi: Connected" + "\n";
-  status += "🔋 Battery: " + String(Hardware::getBatteryVolt(), 1) + "V (" + String(Hardware::getBatteryPercent(), 0) + "%)\n\n";
+  status.appendf("🕐 Time: %s\n", timeStr);
+  status.append("⚡ WiFi: Connected\n");
+  status.appendf("🔋 Battery: %.1fV (%.0f%%)\n\n", Hardware::getBatteryVolt(), Hardware::getBatteryPercent());
   
   
-  status += "🍽 Food: " + String(Hardware::getFoodLevel()) + "%\n";
-  status += "💧 Water: " + String(Hardware::getWaterLevel()) + "%\n\n";
+  status.appendf("🍽 Food: %d%%\n", Hardware::getFoodLevel());
+  status.appendf("💧 Water: %d%%\n", Hardware::getWaterLevel());
+  status.appendf("📡 Sensors read %lus ago\n\n", Hardware::getLevelAge());
   
   // Feed info
-  status += "📈 Total feeds: " + String(DataLogger::getTotalFeeds()) + "\n";
+  status.appendf("📈 Total feeds: %d\n", DataLogger::getTotalFeeds());
   
   // Alerts
   if (Hardware::isCriticalBattery()) {
-    status += "\n⚠ CRITICAL: Battery very low!";
+    status.append("\n⚠ CRITICAL: Battery very low!");
   } else if (Hardware::isLowBattery()) {
-    status += "\n⚠ WARNING: Battery low";
+    status.append("\n⚠ WARNING: Battery low");
   }
   
   if (Hardware::getFoodLevel() < FOOD_CRITICAL_THRESHOLD) {
-    status += "\n⚠ CRITICAL: Food very low!";
+    status.append("\n⚠ CRITICAL: Food very low!");
   }
   
   if (Hardware::getWaterLevel() < WATER_CRITICAL_THRESHOLD) {
-    status += "\n⚠ CRITICAL: Water very low!";
+    status.append("\n⚠ CRITICAL: Water very low!");
   }
-  
-  return status;
 }
 
-String TelegramHandler::formatSystemInfo() {
-  String info = "ℹ SYSTEM INFORMATION\n\n";
+void TelegramHandler::formatSystemInfo(MessageBuffer& info) {
+  info.append("ℹ SYSTEM INFORMATION\n\n");
+  
+  info.appendf("💾 Free Memory: %u bytes (block %u, frag %u%%)\n", Hal::getFreeHeap(),
+               Hal::getMaxFreeBlock(), Hal::getHeapFragmentation());
+  // info.appendf("⚡ Chip ID: %u\n", ESP.getChipId());
+  info.appendf("🔄 Uptime: %lu minutes\n", millis() / 1000 / 60);
+  // info.appendf("📶 RSSI: %d dBm\n", WiFi.RSSI());
+  IPAddress ip = WiFi.localIP();
+  info.appendf("🌐 IP: %u.%u.%u.%u\n", ip[0], ip[1], ip[2], ip[3]);
+  // info.appendf("🔧 SDK: %s\n", ESP.getSdkVersion());
   
-  info += "💾 Free Memory: " + String(ESP.getFreeHeap()) + " bytes\n";
-  // info += "⚡ Chip ID: " + String(ESP.getChipId()) + "\n";
-  info += "🔄 Uptime: " + String(millis() / 1000 / 60) + " minutes\n";
-  // info += "📶 RSSI: " + String(WiFi.RSSI()) + " dBm\n";
-  info += "🌐 IP: " + WiFi.localIP().toString() + "\n";
-  // info += "🔧 SDK: " + String(ESP.getSdkVersion()) + "\n";
+  info.appendf("🔋 WiFi reconnects avoided: %lu\n", Hardware::getReconnectsAvoided());
+  info.appendf("🖥 Display: %lu bytes/min, %lu frames skipped\n",
+               Hardware::getDisplayBytesPerMinute(), Hardware::getDisplaySkippedFrames());
+  const UltrasonicSensor& food = Hardware::getFoodSensor();
+  const UltrasonicSensor& water = Hardware::getWaterSensor();
+  info.appendf("📡 Food sensor: %.1fms avg, %.1f%% timeout\n",
+               food.getAverageLatency() / 1000.0, food.getTimeoutRate());
+  info.appendf("📡 Water sensor: %.1fms avg, %.1f%% timeout\n",
+               water.getAverageLatency() / 1000.0, water.getTimeoutRate());
   
-  return info;
+  info.appendf("📤 Outbox: %d queued, %lu sent, %lu coalesced, %lu dropped, %lu failed\n",
+               MessageQueue::getDepth(), MessageQueue::getSentCount(),
+               MessageQueue::getCoalescedCount(), MessageQueue::getDropCount(),
+               MessageQueue::getFailCount());
+  info.appendf("🕒 Clock: drift %+.1f ppm, %lu syncs, next in %lu min\n",
+               TimeManager::getDriftPpm(), TimeManager::getSyncCount(),
+               TimeManager::getSyncInterval() / 60000);
+  info.appendf("🔋 Power: %.1f%% awake, ~%.1f mA avg, ~%.1f days left, %lu sleeps\n",
+               PowerManager::getAwakeRatio() * 100, PowerManager::getAverageCurrent(),
+               PowerManager::getBatteryLifeHours() / 24, PowerManager::getSleepCount());
+  info.appendf("💾 Store: %u B log, %lu writes (%lu skipped), WA %.2fx, %lu compactions\n",
+               (unsigned)RecordStore::getLogSize(), RecordStore::getRecordsWritten(),
+               RecordStore::getRecordsSkipped(), RecordStore::getWriteAmplification(),
+               RecordStore::getCompactionCount());
+  info.appendf("🔐 TLS: %lu handshakes, %lu reused, %lums avg request\n",
+               TelegramClient::getHandshakeCount(), TelegramClient::getReuseCount(),
+               TelegramClient::getAverageLatency());
+  info.appendf("📤 Send latency: %lums avg, %lums max\n",
+               MessageQueue::getAverageLatency(), MessageQueue::getWorstLatency());
+  
+  info.appendf("\n⏱ Tasks (runs/worst ms/overrun), %lu wakeups:\n", Scheduler::getWakeCount());
+  for (int i = 0; i < Scheduler::getTaskCount(); i++) {
+    const SchedulerTask& task = Scheduler::getTask(i);
+    info.appendf("%s: %lu/%lu/%lu\n", task.name, task.runCount, task.worstRuntime, task.overrunCount);
+  }
 }
 
 // Notification methods
 void TelegramHandler::sendStartupNotification() {
-  String message = "🟢 System Started\n";
-  message += "Hamster Feeder is now online!\n";
-  message += "Time: " + TimeManager::getCurrentTimeString();
-  sendMessage(CHAT_ID, message, "Markdown");
+  char timeStr[20];
+  TimeManager::getCurrentTimeString(timeStr, sizeof(timeStr));
+  
+  MessageBuffer message;
+  message.append("🟢 System Started\n");
+  message.append("Hamster Feeder is now online!\n");
+  message.appendf("Time: %s", timeStr);
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
-void TelegramHandler::sendAutoFeedNotification(String time) {
-  String message = "🍽 Auto Feed Executed\n";
-  message += "Time: " + time + "\n";
-  message += "Food level: " + String(Hardware::getFoodLevel()) + "%";
-  sendMessage(CHAT_ID, message, "Markdown");
-  sendDebugInfo("Auto feed at " + time);
+void TelegramHandler::sendAutoFeedNotification(const char* time) {
+  MessageBuffer message;
+  message.append("🍽 Auto Feed Executed\n");
+  message.appendf("Time: %s\n", time);
+  message.appendf("Food level: %d%%", Hardware::getFoodLevel());
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
+  sendDebugInfo("Auto feed at %s", time);
 }
 
-void TelegramHandler::sendFeedingResult(bool success, String reason) {
-  String message;
+void TelegramHandler::sendFeedingResult(bool success, const char* reason) {
+  MessageBuffer message;
   if (success) {
-    message = "✅ Feeding Successful\n";
-    message += "Hamster has been fed!\n";
-    message += "Food level: " + String(Hardware::getFoodLevel()) + "%";
+    message.append("✅ Feeding Successful\n");
+    message.append("Hamster has been fed!\n");
   } else {
-    message = "❌ Feeding Failed\n";
-    message += "Reason: " + reason + "\n";
-    message += "Food level: " + String(Hardware::getFoodLevel()) + "%";
+    message.append("❌ Feeding Failed\n");
+    message.appendf("Reason: %s\n", reason);
   }
-  sendMessage(CHAT_ID, message, "Markdown");
+  message.appendf("Food level: %d%%", Hardware::getFoodLevel());
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
 void TelegramHandler::sendFoodAlert(int level, bool critical) {
-  String message = critical ? "🚨 CRITICAL FOOD ALERT\n" : "⚠ Food Warning\n";
-  message += "Food level: " + String(level) + "%\n";
-  message += critical ? "Immediate refill required!" : "Consider refilling soon";
-  sendMessage(CHAT_ID, message, "Markdown");
+  MessageBuffer message;
+  message.append(critical ? "🚨 CRITICAL FOOD ALERT\n" : "⚠ Food Warning\n");
+  message.appendf("Food level: %d%%\n", level);
+  message.append(critical ? "Immediate refill required!" : "Consider refilling soon");
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
 void TelegramHandler::sendWaterAlert(int level, bool critical) {
-  String message = critical ? "🚨 CRITICAL WATER ALERT\n" : "⚠ Water Warning\n";
-  message += "Water level: " + String(level) + "%\n";
-  message += critical ? "Immediate refill required!" : "Consider refilling soon";
-  sendMessage(CHAT_ID, message, "Markdown");
+  MessageBuffer message;
+  message.append(critical ? "🚨 CRITICAL WATER ALERT\n" : "⚠ Water Warning\n");
+  message.appendf("Water level: %d%%\n", level);
+  message.append(critical ? "Immediate refill required!" : "Consider refilling soon");
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
 void TelegramHandler::sendBatteryAlert(float percent, bool critical) {
-  String message = critical ? "🚨 CRITICAL BATTERY ALERT\n" : "⚠ Battery Warning\n";
-  message += "Battery: " + String(percent, 0) + "%\n";
-  message += critical ? "System may shut down soon!" : "Consider charging";
-  sendMessage(CHAT_ID, message, "Markdown");
+  MessageBuffer message;
+  message.append(critical ? "🚨 CRITICAL BATTERY ALERT\n" : "⚠ Battery Warning\n");
+  message.appendf("Battery: %.0f%%\n", percent);
+  message.append(critical ? "System may shut down soon!" : "Consider charging");
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
-void TelegramHandler::sendSystemAlert(String message) {
-  sendMessage(CHAT_ID, "⚠ System Alert\n" + message, "Markdown");
+void TelegramHandler::sendSystemAlert(const char* format, ...) {
+  MessageBuffer message;
+  message.append("⚠ System Alert\n");
+  va_list args;
+  va_start(args, format);
+  char text[MESSAGE_BUFFER_SIZE / 2];
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  text[utf8Prefix(text, strlen(text))] = '\0';
+  message.append(text);
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
-void TelegramHandler::sendLogs(String logs) {
-  sendMessage(CHAT_ID, "📝 System Logs\n" + logs, "Markdown");
+void TelegramHandler::sendLogs(const char* logs) {
+  MessageBuffer message;
+  message.append("📝 System Logs\n");
+  message.append(logs);
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
 }
 
-void TelegramHandler::sendDebugInfo(String info) {
+void TelegramHandler::sendDebugInfo(const char* format, ...) {
+  char info[128];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(info, sizeof(info), format, args);
+  va_end(args);
+  info[utf8Prefix(info, strlen(info))] = '\0';
+  
   #ifdef DEBUG_MODE
-  sendMessage(CHAT_ID, "🔧 DEBUG: " + info, "Markdown");
+  MessageBuffer message;
+  message.appendf("🔧 DEBUG: %s", info);
+  sendMessage(CHAT_ID, message.c_str(), "Markdown");
   #endif
-  Serial.println("🔧 " + info);
+  Serial.printf("🔧 %s\n", info);
 }
 
 // Utility methods
-void TelegramHandler::sendMessage(String chat_id, String message, String parseMode) {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("🔄 WiFi disconnected, attempting reconnect...");
-    WiFi.reconnect();
-    
-    // Wait with timeout
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-      delay(500); // 0.5 detik per attempt
-      attempts++;
-      Serial.print(".");
-    }
-    Serial.println();
-  }
-
-  if (WiFi.status() == WL_CONNECTED) {
-    bot.sendMessage(chat_id, message, parseMode);
-    Serial.println("✅ Message sent successfully");
-  } else {
-    Serial.println("❌ WiFi not connected - message not sent");
+  // Pesan tidak dikirim langsung: masuk MessageQueue (digabung dengan pesan lain
+  // ke chat yang sama) dan dikuras checkMessages(), juga saat WiFi sempat putus.
+void TelegramHandler::sendMessage(const char* chat_id, const char* message, const char* parseMode) {
+  MEM_TRACK(MEM_SITE_TELEGRAM_SEND);
+  if (!MessageQueue::enqueue(chat_id, message, parseMode)) {
+    Serial.println("❌ Outbox full - message not queued");
   }
 }
 
-void TelegramHandler::sendMessageWithKeyboard(String chat_id, String message, String keyboard, String parseMode) {
-  if (WiFi.status() == WL_CONNECTED) {
-    bot.sendMessageWithReplyKeyboard(chat_id, message, parseMode, keyboard, true);
-  } else {
-    Serial.println("❌ WiFi not connected - message not sent");
+void TelegramHandler::sendMessageWithKeyboard(const char* chat_id, const char* message, const char* keyboard, const char* parseMode) {
+  MEM_TRACK(MEM_SITE_TELEGRAM_SEND);
+  if (!MessageQueue::enqueue(chat_id, message, parseMode, keyboard)) {
+    Serial.println("❌ Outbox full - message not queued");
   }
 }
 
-bool TelegramHandler::isAuthorizedUser(String chat_id) {
-  return chat_id == CHAT_ID; // Simple authorization - can be expanded
+bool TelegramHandler::isAuthorizedUser(const char* chat_id) {
+  return strcmp(chat_id, CHAT_ID) == 0; // Simple authorization - can be expanded
 }
\ No newline at end of file
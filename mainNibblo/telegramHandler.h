@@ -2,11 +2,13 @@
 #define TELEGRAM_HANDLER_H
 
 #include <ESP8266WiFi.h>
-#include <WiFiClientSecure.h>
-#include <UniversalTelegramBot.h>
-#include <ArduinoJson.h>
 #include "config.h"
 #include "credential.h"
+#include "messageBuffer.h"
+#include "messageQueue.h"
+#include "telegramClient.h"
+#include "updateParser.h"
+#include "logExporter.h"
 
 // Forward declarations
 class Hardware;
@@ -14,43 +16,103 @@ class TimeManager;
 class DataLogger;
 class PowerManager;
 
+enum TelegramRequest {
+  REQUEST_NONE,
+  REQUEST_POLL,
+  REQUEST_SEND,
+  REQUEST_UPLOAD
+};
+
+typedef void (*CommandHandler)(const char* chat_id);
+
+struct CommandEntry {
+  const char* alias;          // huruf kecil, sama persis dengan teks pesan
+  CommandHandler handler;
+};
+
+// Hash sempurna alias -> index commands[], dibangun saat kompilasi
+struct CommandIndex {
+  uint32_t seed;              // 0 = tidak ditemukan seed tanpa tabrakan
+  uint8_t slots[1 << COMMAND_INDEX_BITS];
+};
+
 class TelegramHandler {
 private:
-  static WiFiClientSecure secured_client;
-  static UniversalTelegramBot bot;
-  static unsigned long lastCheckTime;
+  static TelegramRequest activeRequest;
+  static unsigned long lastPollTime;
+  static long lastUpdateId;
+  static bool morePending;
+  static bool pollFailed;
+  static unsigned long completedPolls;  // sejak boot/bangun
   static bool waitingForTimeInput;
-  static String pendingChatId;
+  static char pendingChatId[TELEGRAM_CHAT_ID_SIZE];
+  static const CommandEntry commands[];
+  static const CommandIndex commandIndex;
   
   // Internal methods
-  static void handleNewMessages(int numNewMessages);
-  static void sendMenuKeyboard(String chat_id);
-  static void sendTimeMenuKeyboard(String chat_id);
-  static void sendSystemMenuKeyboard(String chat_id);
-  static void processTimeInput(String chat_id, String text);
-  static void processCommand(String chat_id, String text);
-  static String formatStatusMessage();
-  static String formatSystemInfo();
-  static void sendMessage(String chat_id, String message, String parseMode = "");
-  static void sendMessageWithKeyboard(String chat_id, String message, String keyboard, String parseMode = "Markdown");
+  static void startPoll();
+  static bool shouldInterruptPoll();
+  static void startSend();
+  static void finishSend();
+  static void startUpload();
+  static void finishUpload();
+  static bool isPollDue();
+  static void dispatchUpdate();
+  static void handleNewMessage(const char* chat_id, char* text);
+  static void sendMenuKeyboard(const char* chat_id);
+  static void sendTimeMenuKeyboard(const char* chat_id);
+  static void sendSystemMenuKeyboard(const char* chat_id);
+  static void processTimeInput(const char* chat_id, const char* text);
+  static void processCommand(const char* chat_id, const char* text);
+  
+  // Command handlers (lihat tabel commands[])
+  static void cmdStatus(const char* chat_id);
+  static void cmdFeed(const char* chat_id);
+  static void cmdFoodInfo(const char* chat_id);
+  static void cmdWaterInfo(const char* chat_id);
+  static void cmdAddSchedule(const char* chat_id);
+  static void cmdViewSchedule(const char* chat_id);
+  static void cmdClearSchedule(const char* chat_id);
+  static void cmdLogs(const char* chat_id);
+  static void cmdExport(const char* chat_id);
+  static void cmdSysInfo(const char* chat_id);
+  static void cmdMem(const char* chat_id);
+  static void cmdPerf(const char* chat_id);
+  static void cmdPerfReset(const char* chat_id);
+  static void cmdReboot(const char* chat_id);
+  static void cmdBack(const char* chat_id);
+  static void formatStatusMessage(MessageBuffer& status);
+  static void formatSystemInfo(MessageBuffer& info);
+  static void appendLevelStatus(MessageBuffer& msg, int level, int warning, int critical);
+  static void sendMessage(const char* chat_id, const char* message, const char* parseMode = "");
+  static void sendMessageWithKeyboard(const char* chat_id, const char* message, const char* keyboard, const char* parseMode = "Markdown");
 
 public:
   static void init();
   static void checkMessages();
+  static unsigned long getServiceDelay();
+  static void flushMessages(unsigned long timeout);
+  
+  // Deep sleep (PowerManager)
+  static bool isQuiet();
+  static void prepareSleep();
+  static long getLastUpdateId();
+  static void restoreLastUpdateId(long updateId);
   
   // Notification methods
   static void sendStartupNotification();
-  static void sendAutoFeedNotification(String time);
-  static void sendFeedingResult(bool success, String reason = "");
+  static void sendAutoFeedNotification(const char* time);
+  static void sendFeedingResult(bool success, const char* reason = "");
   static void sendFoodAlert(int level, bool critical);
   static void sendWaterAlert(int level, bool critical);
   static void sendBatteryAlert(float percent, bool critical);
-  static void sendSystemAlert(String message);
+  static void sendSystemAlert(const char* format, ...) __attribute__((format(printf, 1, 2)));
   
   // Utility methods
-  static void sendLogs(String logs);
-  static void sendDebugInfo(String info);
-  static bool isAuthorizedUser(String chat_id);
+  static void sendLogs(const char* logs);
+  static void sendDebugInfo(const char* format, ...) __attribute__((format(printf, 1, 2)));
+  static bool isAuthorizedUser(const char* chat_id);
+  static CommandHandler findCommand(const char* text);  // teks sudah trim + lowercase
 };
 
 #endif
\ No newline at end of file
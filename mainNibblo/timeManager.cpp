@@ -2,130 +2,432 @@
 #include "hardware.h"
 #include "dataLogger.h"
 #include "telegramHandler.h"
+#include "recordStore.h"
+#include "profiler.h"
 
 WiFiUDP TimeManager::ntpUDP;
-NTPClient TimeManager::timeClient(ntpUDP, NTP_SERVER, TIME_ZONE*ONE_HOUR_SECOND, 60000); 
-//konveri UTC ke WITA, sinkronisasi tiap 60 detik
+uint64_t TimeManager::baseEpochMs = 0;
+unsigned long TimeManager::baseMillis = 0;
+uint64_t TimeManager::syncEpochMs = 0;
+float TimeManager::driftPpm = 0;
+bool TimeManager::clockSynced = false;
+bool TimeManager::driftKnown = false;
+unsigned long TimeManager::syncInterval = CLOCK_SYNC_MIN_INTERVAL;
+unsigned long TimeManager::syncCount = 0;
 FeedSchedule TimeManager::schedules[MAX_SCHEDULES];
 int TimeManager::scheduleCount = 0;
+int TimeManager::nextIndex = NO_SCHEDULE;
+unsigned long TimeManager::nextDueEpoch = 0;
 unsigned long TimeManager::lastTimeSync = 0;
+unsigned long TimeManager::sleptSinceSync = 0;
+bool TimeManager::driftReference = false;
 
 void TimeManager::init() {
-  timeClient.begin();
+  ntpUDP.begin(NTP_LOCAL_PORT);
   
-  // Add default schedules
-  addSchedule("08:00", true);
+  // Jadwal & eksekusi terakhir dari flash, jika belum ada pakai default
+  if (!loadSchedules()) {
+    addSchedule("08:00", true);
+  }
   
-  syncTime();
+  // bangun dari deep sleep: jam dari RTC memory, NTP hanya jika sudah lama
+  if (!clockSynced) syncTime();
   Serial.println("✅ Time Manager initialized");
 }
 
 void TimeManager::update() {
-  // sinkronisasi per jam, PASTIKAN > agar millis() tidak overflow
-  if (millis() - lastTimeSync > ONE_HOUR_MILLIS) {
+  PROFILE_SCOPE(PROFILE_TIME);
+  // Sebelum sync pertama coba tiap TIME_UPDATE_INTERVAL, setelah itu
+  // mengikuti syncInterval (adaptif). PASTIKAN > agar millis() tidak overflow
+  if (!clockSynced || millis() - lastTimeSync >= syncInterval) {
     syncTime();
   }
+  if (millis() - baseMillis >= CLOCK_REBASE_INTERVAL) {
+    rebase();
+  }
 }
 
 void TimeManager::syncTime() {
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("Syncing time...");
-    if (timeClient.update()) {
-      lastTimeSync = millis();
-      Serial.println("Time synced: " + getCurrentTimeString());
+    uint64_t epochMs;
+    if (requestNtpTime(epochMs)) {
+      bool wasValid = isClockValid(getEpoch());
+      applySync(epochMs);
+      if (!wasValid) anchorSchedules(getEpoch() - millis() / 1000);  // epoch saat boot
+      updateNextDue();  // jam bisa melompat setelah sinkronisasi
+      char timeStr[20];
+      getCurrentTimeString(timeStr, sizeof(timeStr));
+      Serial.printf("Time synced: %s (drift %+.1f ppm, next sync %lu min)\n",
+                    timeStr, driftPpm, syncInterval / 60000);
     }
   }
 }
 
-  // EPOCHTIME dimulai dari 1 januari 1970. 
-  // Sedangkan struct tm (dari lib c), dimulai dari 1 januari 1900
+  // SNTP satu paket; timestamp transmit server termasuk pecahan detik,
+  // ditambah setengah round-trip. Blocking maksimal NTP_TIMEOUT.
+bool TimeManager::requestNtpTime(uint64_t& epochMs) {
+  uint8_t packet[NTP_PACKET_SIZE];
+  while (ntpUDP.parsePacket() > 0) ntpUDP.flush();  // buang balasan lama
+  
+  memset(packet, 0, sizeof(packet));
+  packet[0] = 0x1B;  // LI 0, versi 3, mode client
+  unsigned long sent = millis();
+  if (!ntpUDP.beginPacket(NTP_SERVER, NTP_PORT)) return false;
+  ntpUDP.write(packet, sizeof(packet));
+  if (!ntpUDP.endPacket()) return false;
+  
+  while (ntpUDP.parsePacket() < NTP_PACKET_SIZE) {
+    if (millis() - sent > NTP_TIMEOUT) {
+      Serial.println("❌ NTP timeout");
+      return false;
+    }
+    delay(10);
+  }
+  ntpUDP.read(packet, sizeof(packet));
+  unsigned long roundTrip = millis() - sent;
+  
+  uint32_t seconds = (uint32_t)packet[40] << 24 | (uint32_t)packet[41] << 16 |
+                     (uint32_t)packet[42] << 8 | packet[43];
+  uint32_t fraction = (uint32_t)packet[44] << 24 | (uint32_t)packet[45] << 16 |
+                      (uint32_t)packet[46] << 8 | packet[47];
+  if (seconds < NTP_UNIX_OFFSET) return false;
+  
+  epochMs = (uint64_t)(seconds - NTP_UNIX_OFFSET + (long)TIME_ZONE * ONE_HOUR_SECOND) * 1000 +
+            (((uint64_t)fraction * 1000) >> 32) + roundTrip / 2;
+  return true;
+}
 
-  String TimeManager::getCurrentTime() {
-    time_t rawTime = timeClient.getEpochTime(); // ambil dari NTP
-    struct tm * timeInfo = localtime(&rawTime); // ubah ke struktur sec min hour dst
-    char timeStr[6];  // HH:MM
-    sprintf(timeStr, "%02d:%02d", timeInfo->tm_hour, timeInfo->tm_min); //simpan HH:MM
-    return String(timeStr);
+  // Bandingkan hasil NTP dengan prediksi jam lokal: perbedaan laju sejak sync
+  // sebelumnya = drift kristal. Jika prediksi sudah akurat, interval sync
+  // digandakan (radio tidak perlu dibangunkan untuk waktu).
+void TimeManager::applySync(uint64_t epochMs) {
+  unsigned long now = millis();
+  
+  if (clockSynced) {
+    long error = (long)((int64_t)epochMs - (int64_t)getEpochMs());
+    unsigned long localSpan = now - lastTimeSync;
+    
+    // Error lebih besar dari yang bisa dihasilkan kristal CLOCK_DRIFT_MAX_PPM
+    // selama localSpan = jam server melompat (atau koreksi manual), bukan drift
+    long stepLimit = CLOCK_SYNC_TOLERANCE + (long)(localSpan / 1000 * CLOCK_DRIFT_MAX_PPM / 1000);
+    bool step = labs(error) > stepLimit;
+    if (driftReference && localSpan >= CLOCK_DRIFT_MIN_SPAN && !step) {
+      float measured = ((float)(int64_t)(epochMs - syncEpochMs) - localSpan) * 1e6 / localSpan;
+      if (fabsf(measured) <= CLOCK_DRIFT_MAX_PPM) {
+        driftPpm = driftKnown ? driftPpm + CLOCK_DRIFT_ALPHA * (measured - driftPpm) : measured;
+        driftKnown = true;
+      } else {
+        step = true;
+      }
+    }
+    if (step) Serial.printf("⏱️ Clock step %+ld ms, drift estimate kept\n", error);
+    
+    if (labs(error) <= CLOCK_SYNC_TOLERANCE) {
+      syncInterval = min(syncInterval * 2, CLOCK_SYNC_MAX_INTERVAL);
+    } else {
+      syncInterval = max(syncInterval / 2, CLOCK_SYNC_MIN_INTERVAL);
+    }
   }
+  
+  baseEpochMs = epochMs;
+  baseMillis = now;
+  syncEpochMs = epochMs;
+  lastTimeSync = now;
+  clockSynced = true;
+  driftReference = true;
+  sleptSinceSync = 0;
+  syncCount++;
+}
 
-String TimeManager::getCurrentTimeString() {
-  time_t rawTime = timeClient.getEpochTime();
-  struct tm * timeInfo = localtime(&rawTime);
-  char timeStr[20];
-  sprintf(timeStr, "%02d:%02d:%02d %02d/%02d/%04d", 
-          timeInfo->tm_hour, 
-          timeInfo->tm_min, 
-          timeInfo->tm_sec,
-          timeInfo->tm_mday, 
-          timeInfo->tm_mon + 1, 
-          timeInfo->tm_year + 1900);
-  return String(timeStr);
+  // Lipat offset millis() ke epoch dasar supaya selisih tidak mendekati
+  // batas overflow millis() (~49 hari) bila sync lama tidak berhasil
+void TimeManager::rebase() {
+  uint64_t now = getEpochMs();
+  baseMillis = millis();
+  baseEpochMs = now;
 }
 
+uint64_t TimeManager::getEpochMs() {
+  unsigned long elapsed = millis() - baseMillis;
+  return baseEpochMs + elapsed + (int64_t)(elapsed * driftPpm / 1e6);
+}
+
+  // epoch lokal (sudah termasuk TIME_ZONE); sebelum sync pertama = uptime
+unsigned long TimeManager::getEpoch() {
+  return getEpochMs() / 1000;
+}
+
+  // EPOCHTIME dimulai dari 1 januari 1970. Konversi ke tanggal tanpa
+  // localtime(): algoritma days-to-civil (kalender Gregorian)
+void TimeManager::breakEpoch(unsigned long epoch, ClockTime& time) {
+  unsigned long secondOfDay = epoch % ONE_DAY_SECOND;
+  time.hour = secondOfDay / 3600;
+  time.minute = (secondOfDay / 60) % 60;
+  time.second = secondOfDay % 60;
+  
+  unsigned long z = epoch / ONE_DAY_SECOND + 719468;  // hari sejak 0000-03-01
+  unsigned long era = z / 146097;
+  unsigned long dayOfEra = z - era * 146097;
+  unsigned long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  unsigned long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  unsigned long mp = (5 * dayOfYear + 2) / 153;  // bulan mulai Maret
+  time.day = dayOfYear - (153 * mp + 2) / 5 + 1;
+  time.month = mp < 10 ? mp + 3 : mp - 9;
+  time.year = yearOfEra + era * 400 + (time.month <= 2 ? 1 : 0);
+}
+
+  // format "HH:MM", buffer minimal 6 byte
+void TimeManager::getCurrentTime(char* buffer, size_t size) {
+  ClockTime now;
+  breakEpoch(getEpoch(), now);
+  snprintf(buffer, size, "%02d:%02d", now.hour, now.minute);
+}
+
+  // format "HH:MM:SS DD/MM/YYYY", buffer minimal 20 byte
+void TimeManager::getCurrentTimeString(char* buffer, size_t size) {
+  ClockTime now;
+  breakEpoch(getEpoch(), now);
+  snprintf(buffer, size, "%02d:%02d:%02d %02d/%02d/%04d", 
+          now.hour, 
+          now.minute, 
+          now.second,
+          now.day, 
+          now.month, 
+          now.year);
+}
+
+  // Cukup satu perbandingan integer dengan deadline jadwal berikutnya.
+  // Berbasis deadline dengan jendela catch-up: pengecekan yang terlambat
+  // (operasi blocking, reboot, brownout) tetap mengeksekusi jadwal tepat
+  // sekali selama belum lewat FEED_CATCHUP_WINDOW.
 void TimeManager::checkAutoFeedSchedule() {
-  String currentTime = getCurrentTime();
-  time_t rawTime = timeClient.getEpochTime();
-  struct tm * timeInfo = localtime(&rawTime);
-  int currentDay = timeInfo->tm_mday;
+  PROFILE_SCOPE(PROFILE_FEED);
+  if (nextIndex == NO_SCHEDULE) return;
+  unsigned long now = getEpoch();
+  if (now < nextDueEpoch) return;
+  
+  FeedSchedule& schedule = schedules[nextIndex];
+  char timeStr[6];
+  formatMinute(schedule.minute, timeStr, sizeof(timeStr));
+  
+  if (now - nextDueEpoch > FEED_CATCHUP_WINDOW) {
+    Serial.printf("⚠️ Feed %s missed (%lus late)\n", timeStr, now - nextDueEpoch);
+    TelegramHandler::sendSystemAlert("Scheduled feed %s missed", timeStr);
+    schedule.lastExecuted = nextDueEpoch;
+    saveSchedules();
+    updateNextDue();
+    return;
+  }
+  
+  // coba lagi selama masih dalam jendela catch-up
+  if (Hardware::getFoodLevel() <= FOOD_CRITICAL_THRESHOLD || Hardware::getBatteryPercent() <= LOW_BATTERY_THRESHOLD) {
+    return;
+  }
+  
+  // Catat dulu sebelum servo bergerak: jika reset di tengah pemberian makan,
+  // jadwal ini tidak diulang setelah boot (lebih aman dari makan dua kali)
+  schedule.lastExecuted = nextDueEpoch;
+  saveSchedules();
+  
+  // Execute auto feed
+  if (now - nextDueEpoch >= 60) {
+    Serial.printf("⏰ Catch-up feed %s (%lus late)\n", timeStr, now - nextDueEpoch);
+  }
+  Hardware::feedHamster();
+  DataLogger::logFeeding("AUTO", timeStr);
+  TelegramHandler::sendAutoFeedNotification(timeStr);
+  updateNextDue();
+}
+
+  // Jadwal berikutnya pasti tidak dieksekusi (mis. baterai kritis saat akan
+  // deep sleep): dilaporkan sekarang, bukan setelah FEED_CATCHUP_WINDOW lewat
+void TimeManager::skipNextFeed(const char* reason) {
+  if (nextIndex == NO_SCHEDULE) return;
+  FeedSchedule& schedule = schedules[nextIndex];
+  char timeStr[6];
+  formatMinute(schedule.minute, timeStr, sizeof(timeStr));
+  Serial.printf("⚠️ Feed %s skipped (%s)\n", timeStr, reason);
+  TelegramHandler::sendSystemAlert("Scheduled feed %s skipped: %s", timeStr, reason);
+  schedule.lastExecuted = nextDueEpoch;
+  saveSchedules();
+  updateNextDue();
+}
+
+  // ms sampai checkAutoFeedSchedule() perlu jalan lagi
+unsigned long TimeManager::getTimeUntilNextFeed() {
+  if (nextIndex == NO_SCHEDULE) return FEED_MAX_SLEEP;
+  unsigned long now = getEpoch();
+  if (now >= nextDueEpoch) return FEED_CHECK_INTERVAL;
+  unsigned long wait = (nextDueEpoch - now) * 1000UL;
+  return wait < FEED_MAX_SLEEP ? wait : FEED_MAX_SLEEP;
+}
+
+  // detik sampai jadwal berikutnya tanpa batas FEED_MAX_SLEEP (untuk deep sleep);
+  // NO_FEED_DUE jika tidak ada jadwal aktif
+unsigned long TimeManager::getSecondsUntilNextFeed() {
+  if (nextIndex == NO_SCHEDULE) return NO_FEED_DUE;
+  unsigned long now = getEpoch();
+  return now >= nextDueEpoch ? 0 : nextDueEpoch - now;
+}
+
+void TimeManager::getSleepState(ClockState& saved) {
+  memset(&saved, 0, sizeof(saved));
+  saved.epochMs = getEpochMs();
+  saved.driftPpm = driftPpm;
+  saved.syncInterval = syncInterval;
+  saved.sleptSinceSync = sleptSinceSync;
+  saved.synced = clockSynced;
+  saved.driftKnown = driftKnown;
+}
+
+  // Dipanggil sebelum init(): millis() mulai dari 0 saat bangun, jadi epoch
+  // dasar = epoch saat tidur + lama tidur. Error timer RTC ikut terbawa sampai
+  // NTP berikutnya, karena itu drift tidak diukur dari span yang melewati sleep.
+void TimeManager::restoreSleepState(const ClockState& saved, unsigned long sleptMs) {
+  baseEpochMs = saved.epochMs + sleptMs;
+  baseMillis = 0;
+  driftPpm = saved.driftPpm;
+  driftKnown = saved.driftKnown;
+  syncInterval = saved.syncInterval;
+  sleptSinceSync = saved.sleptSinceSync + sleptMs / 1000;
+  clockSynced = saved.synced && sleptSinceSync < DUTY_RESYNC_SLEEP;
+  driftReference = false;
+  lastTimeSync = 0;
+}
+
+  // Deadline terdekat yang belum dieksekusi: kejadian terakhir yang sudah
+  // lewat jika masih dalam jendela catch-up, selain itu kejadian berikutnya.
+  // Epoch dari getEpoch() sudah termasuk offset zona waktu.
+unsigned long TimeManager::nextOccurrence(const FeedSchedule& schedule, unsigned long now) {
+  unsigned long today = now - now % ONE_DAY_SECOND;
+  unsigned long occurrence = today + schedule.minute * 60UL;
+  if (occurrence > now) occurrence -= ONE_DAY_SECOND;  // kejadian terakhir = kemarin
+  
+  if (schedule.lastExecuted >= occurrence || now - occurrence > FEED_CATCHUP_WINDOW) {
+    occurrence += ONE_DAY_SECOND;
+  }
+  // jam mundur (koreksi NTP) ke sebelum jadwal yang baru saja dieksekusi
+  if (schedule.lastExecuted == occurrence) {
+    occurrence += ONE_DAY_SECOND;
+  }
+  return occurrence;
+}
+
+bool TimeManager::isClockValid(unsigned long now) {
+  return now >= MIN_VALID_EPOCH;
+}
+
+  // Jadwal tidak berjalan sebelum jam tersinkron; syncTime() menghitung ulang
+void TimeManager::updateNextDue() {
+  unsigned long now = getEpoch();
+  nextIndex = NO_SCHEDULE;
+  if (!isClockValid(now)) return;
   
   for (int i = 0; i < scheduleCount; i++) {
-    //jadwal aktif, waktu saat itu, belum dieksekusi
-    if (schedules[i].enabled && 
-        schedules[i].time == currentTime &&
-        (!schedules[i].executed || schedules[i].lastDay != currentDay)) {
-      
-      // Execute auto feed
-      if (Hardware::getFoodLevel() > FOOD_CRITICAL_THRESHOLD && Hardware::getBatteryPercent() > LOW_BATTERY_THRESHOLD) {
-        Hardware::feedHamster();
-        DataLogger::logFeeding("AUTO", schedules[i].time);
-        TelegramHandler::sendAutoFeedNotification(schedules[i].time);
-        
-        // Update last day feed
-        schedules[i].executed = true;
-        schedules[i].lastDay = currentDay;
-      }
-    }
-    
-    // Reset execution flag for new day
-    if (schedules[i].lastDay != currentDay) {
-      schedules[i].executed = false;
+    if (!schedules[i].enabled) continue;
+    unsigned long due = nextOccurrence(schedules[i], now);
+    if (nextIndex == NO_SCHEDULE || due < nextDueEpoch) {
+      nextIndex = i;
+      nextDueEpoch = due;
     }
   }
 }
 
+  // Sync pertama: jadwal yang ditambahkan saat jam belum valid (di init())
+  // diberi acuan seperti di addSchedule() dengan waktu boot, jadi kejadian
+  // pada menit boot tetap dieksekusi walau join WiFi + NTP melewati menit itu
+void TimeManager::anchorSchedules(unsigned long now) {
+  bool changed = false;
+  for (int i = 0; i < scheduleCount; i++) {
+    if (schedules[i].lastExecuted != 0) continue;
+    schedules[i].lastExecuted = now - now % 60 - 1;
+    changed = true;
+  }
+  if (changed) saveSchedules();
+}
+
+void TimeManager::saveSchedules() {
+  static_assert(sizeof(ScheduleRecord) <= STORE_MAX_PAYLOAD, "ScheduleRecord too large");
+  ScheduleRecord record;
+  memset(&record, 0, sizeof(record));
+  record.count = scheduleCount;
+  memcpy(record.schedules, schedules, scheduleCount * sizeof(FeedSchedule));
+  
+  if (!RecordStore::write(RECORD_SCHEDULES, &record, sizeof(record))) {
+    Serial.println("❌ Failed to save schedules");
+  }
+}
+
+bool TimeManager::loadSchedules() {
+  ScheduleRecord record;
+  if (!RecordStore::read(RECORD_SCHEDULES, &record, sizeof(record)) ||
+      record.count > MAX_SCHEDULES) {
+    return false;
+  }
+  
+  memcpy(schedules, record.schedules, sizeof(schedules));
+  scheduleCount = record.count;
+  updateNextDue();
+  Serial.printf("📥 Loaded %d schedules from flash\n", scheduleCount);
+  return true;
+}
+
 void TimeManager::addSchedule(String time, bool enabled) {
   time.trim();  // Hilangkan spasi di awal/akhir
   if (time.length() == 4) time = "0" + time;  // Pastikan format selalu HH:MM
 
-  // Cek duplikat
+  // Validasi format dan batas maksimal
+  int minute = parseTime(time);
+  if (minute < 0) {
+    Serial.println("❌ Format waktu tidak valid: \"" + time + "\". Gunakan format HH:MM.");
+    return;
+  }
+
+  // Cek duplikat, sekaligus cari posisi supaya tetap urut
+  int position = scheduleCount;
   for (int i = 0; i < scheduleCount; i++) {
-    if (schedules[i].time == time) {
+    if (schedules[i].minute == minute) {
       Serial.println("⚠️ Jadwal \"" + time + "\" sudah ada. Tidak ditambahkan.");
       return;
     }
+    if (schedules[i].minute > minute && position == scheduleCount) position = i;
   }
 
-  // Validasi format dan batas maksimal
   if (scheduleCount >= MAX_SCHEDULES) {
     Serial.println("❌ Jumlah maksimum jadwal (" + String(MAX_SCHEDULES) + ") telah tercapai.");
     return;
   }
 
-  if (!isValidTimeFormat(time)) {
-    Serial.println("❌ Format waktu tidak valid: \"" + time + "\". Gunakan format HH:MM.");
-    return;
-  }
-
   // Tambahkan jadwal
-  schedules[scheduleCount].time = time;
-  schedules[scheduleCount].enabled = enabled;
-  schedules[scheduleCount].executed = false;
-  schedules[scheduleCount].lastDay = 0;
+  for (int i = scheduleCount; i > position; i--) {
+    schedules[i] = schedules[i - 1];
+  }
+  schedules[position].minute = minute;
+  schedules[position].enabled = enabled;
+  // Jadwal baru tidak di-catch-up untuk kejadian yang sudah lewat, kecuali
+  // menit ini. Sebelum jam tersinkron (jadwal default saat boot pertama)
+  // belum ada acuan: 0 = belum di-anchor, diisi anchorSchedules() saat sync.
+  unsigned long now = getEpoch();
+  schedules[position].lastExecuted = isClockValid(now) ? now - now % 60 - 1 : 0;
   scheduleCount++;
+  saveSchedules();
+  updateNextDue();
 
   Serial.println("✅ Jadwal \"" + time + "\" berhasil ditambahkan.");
 }
 
+  // "HH:MM" -> menit dalam hari, -1 jika tidak valid
+int TimeManager::parseTime(String time) {
+  if (!isValidTimeFormat(time)) return -1;
+  return time.substring(0, 2).toInt() * 60 + time.substring(3, 5).toInt();
+}
+
+  // jam di-modulo 24 supaya selalu 2 digit (muat di buffer "HH:MM")
+void TimeManager::formatMinute(uint16_t minute, char* buffer, size_t size) {
+  snprintf(buffer, size, "%02u:%02u", (unsigned)(minute / 60 % 24), (unsigned)(minute % 60));
+}
+
 bool TimeManager::isValidTimeFormat(String time) {
   if (time.length() != 5 || time.charAt(2) != ':') return false;  //validasi HH:MM
   int hour = time.substring(0, 2).toInt();  // ambil karakter 0,1
@@ -136,23 +438,30 @@ bool TimeManager::isValidTimeFormat(String time) {
   //hapus semua schedule
 void TimeManager::clearAllSchedules() {
   scheduleCount = 0;
+  nextIndex = NO_SCHEDULE;
+  saveSchedules();
 }
 
-String TimeManager::getScheduleList() {
-  String result = "📆 Feed Schedule:\n";
+void TimeManager::getScheduleList(MessageBuffer& result) {
+  result.append("📆 Feed Schedule:\n");
   if (scheduleCount == 0) {
-    result += "- No schedule -\n";
-    return result;
+    result.append("- No schedule -\n");
+    return;
   }
 
   for (int i = 0; i < scheduleCount; i++) {
-    result += String(i + 1) + ". " + schedules[i].time;
-    result += schedules[i].enabled ? " ✅\n" : " ❌\n";
+    char timeStr[6];
+    formatMinute(schedules[i].minute, timeStr, sizeof(timeStr));
+    result.appendf("%d. %s", i + 1, timeStr);
+    result.append(schedules[i].enabled ? " ✅\n" : " ❌\n");
   }
-  return result;
 }
 
 
+float TimeManager::getDriftPpm() { return driftPpm; }
+unsigned long TimeManager::getSyncCount() { return syncCount; }
+unsigned long TimeManager::getSyncInterval() { return syncInterval; }
+
 void TimeManager::removeSchedule(int index) {
   if (index < 0 || index >= scheduleCount) return;  // Validasi batas index
 
@@ -160,4 +469,6 @@ void TimeManager::removeSchedule(int index) {
     schedules[i] = schedules[i + 1];  // Geser semua elemen ke kiri
   }
   scheduleCount--;  // Kurangi jumlah total jadwal
+  saveSchedules();
+  updateNextDue();
 }
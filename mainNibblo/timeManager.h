@@ -2,40 +2,106 @@
 #define TIME_MANAGER_H
 
 #include <WiFiUdp.h>
-#include <NTPClient.h>
 #include <TimeLib.h>
 #include "config.h"
+#include "messageBuffer.h"
 
 #define ONE_HOUR_MILLIS 3600000
 #define ONE_HOUR_SECOND 3600
+#define ONE_DAY_SECOND 86400L
+#define NO_SCHEDULE -1
+#define NO_FEED_DUE 0xFFFFFFFFUL
+#define NTP_PACKET_SIZE 48
+#define NTP_UNIX_OFFSET 2208988800UL  // detik 1900 -> 1970
+
+struct ClockTime {
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+};
 
 struct FeedSchedule {
-  String time;
+  uint16_t minute;            // menit dalam hari (jam * 60 + menit)
   bool enabled;
-  bool executed;
-  int lastDay;
+  uint32_t lastExecuted;      // epoch deadline terakhir yang sudah dieksekusi
+};
+
+// Jam yang dibawa melewati deep sleep (RTC memory, lihat PowerManager)
+struct ClockState {
+  uint64_t epochMs;           // epoch lokal saat masuk sleep
+  float driftPpm;
+  uint32_t syncInterval;
+  uint32_t sleptSinceSync;    // detik tidur sejak NTP terakhir
+  uint8_t synced;
+  uint8_t driftKnown;
+  uint8_t reserved[2];
+};
+
+// Record RECORD_SCHEDULES di RecordStore, bertahan walau daya putus
+struct ScheduleRecord {
+  uint32_t count;
+  FeedSchedule schedules[MAX_SCHEDULES];
 };
 
 class TimeManager {
 private:
   static WiFiUDP ntpUDP;
-  static NTPClient timeClient;
-  static FeedSchedule schedules[MAX_SCHEDULES];  //cuma bisa 10 waktu dalam 1 jadwal
+  static uint64_t baseEpochMs;    // epoch lokal (UTC + TIME_ZONE) saat baseMillis
+  static unsigned long baseMillis;
+  static uint64_t syncEpochMs;    // dari sync terakhir, untuk mengukur drift
+  static float driftPpm;          // + = kristal lambat, hasil dikoreksi maju
+  static bool clockSynced;
+  static bool driftKnown;
+  static unsigned long syncInterval;
+  static unsigned long syncCount;
+  static FeedSchedule schedules[MAX_SCHEDULES];  //cuma bisa 10 waktu dalam 1 jadwal, urut menit
   static int scheduleCount;
+  static int nextIndex;                          //jadwal berikutnya, NO_SCHEDULE jika kosong
+  static unsigned long nextDueEpoch;
   static unsigned long lastTimeSync;
+  static unsigned long sleptSinceSync;
+  static bool driftReference;     // syncEpochMs/lastTimeSync dari jam yang berjalan terus
+
+  static bool requestNtpTime(uint64_t& epochMs);
+  static void applySync(uint64_t epochMs);
+  static void rebase();
+  static void breakEpoch(unsigned long epoch, ClockTime& time);
+  static void updateNextDue();
+  static void anchorSchedules(unsigned long now);
+  static unsigned long nextOccurrence(const FeedSchedule& schedule, unsigned long now);
+  static void saveSchedules();
+  static bool loadSchedules();
+  static int parseTime(String time);
+  static void formatMinute(uint16_t minute, char* buffer, size_t size);
 
 public:
   static void init();
   static void update();
   static void syncTime();
-  static String getCurrentTime();
-  static String getCurrentTimeString();
+  static unsigned long getEpoch();
+  static bool isClockValid(unsigned long now);
+  static uint64_t getEpochMs();
+  static void getCurrentTime(char* buffer, size_t size);
+  static void getCurrentTimeString(char* buffer, size_t size);
   static void checkAutoFeedSchedule();
+  static void skipNextFeed(const char* reason);
+  static unsigned long getTimeUntilNextFeed();
+  static unsigned long getSecondsUntilNextFeed();
+  static void getSleepState(ClockState& saved);
+  static void restoreSleepState(const ClockState& saved, unsigned long sleptMs);
   static void addSchedule(String time, bool enabled = true);
   static void removeSchedule(int index);
-  static String getScheduleList();
+  static void getScheduleList(MessageBuffer& result);
   static bool isValidTimeFormat(String time);
   static void clearAllSchedules();
+
+  // Statistik jam
+  static float getDriftPpm();
+  static unsigned long getSyncCount();
+  static unsigned long getSyncInterval();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "ultrasonicSensor.h"
+#include "hal.h"
+
+UltrasonicSensor::UltrasonicSensor()
+  : trigPin(0), echoPin(0), state(ULTRASONIC_IDLE),
+    echoStartMicros(0), echoEndMicros(0), triggerMicros(0), lastDistance(0),
+    pingCount(0), timeoutCount(0), lastLatency(0), worstLatency(0), totalLatency(0) {}
+
+void UltrasonicSensor::begin(uint8_t trig, uint8_t echo, void (*isr)()) {
+  trigPin = trig;
+  echoPin = echo;
+  Hal::pinOutput(trigPin);
+  Hal::pinInput(echoPin);
+  Hal::writePin(trigPin, false);
+  Hal::attachEdgeInterrupt(echoPin, isr);
+}
+
+void UltrasonicSensor::trigger() {
+  // pulsa trigger 10 us, satu-satunya bagian yang busy-wait
+  Hal::writePin(trigPin, false);
+  delayMicroseconds(2);
+  Hal::writePin(trigPin, true);
+  delayMicroseconds(10);
+  Hal::writePin(trigPin, false);
+  trigger(micros());
+}
+
+void UltrasonicSensor::trigger(unsigned long nowMicros) {
+  echoStartMicros = 0;
+  echoEndMicros = 0;
+  triggerMicros = nowMicros;
+  state = ULTRASONIC_WAIT_ECHO;
+  pingCount++;
+}
+
+  // dipanggil dari ISR (CHANGE) dengan level pin echo saat itu
+void IRAM_ATTR UltrasonicSensor::onEchoEdge(bool level, unsigned long nowMicros) {
+  if (state != ULTRASONIC_WAIT_ECHO) return;
+
+  if (level) {
+    echoStartMicros = nowMicros;
+  } else if (echoStartMicros != 0) {
+    echoEndMicros = nowMicros;
+    state = ULTRASONIC_READY;
+  }
+}
+
+bool UltrasonicSensor::poll() {
+  return poll(micros());
+}
+
+  // true jika ada hasil baru (valid atau timeout) yang diambil pada panggilan ini
+bool UltrasonicSensor::poll(unsigned long nowMicros) {
+  UltrasonicState current = state;
+
+  if (current == ULTRASONIC_WAIT_ECHO) {
+    if (nowMicros - triggerMicros < ULTRASONIC_TIMEOUT_US) return false;
+    state = ULTRASONIC_TIMEOUT;
+    current = ULTRASONIC_TIMEOUT;
+  }
+
+  if (current == ULTRASONIC_READY) {
+    unsigned long duration = echoEndMicros - echoStartMicros;
+    lastDistance = duration * 0.0343 / 2;  // konversi ke cm
+  } else if (current == ULTRASONIC_TIMEOUT) {
+    lastDistance = 0;  // sama seperti pulseIn() timeout
+    timeoutCount++;
+  } else {
+    return false;
+  }
+
+  lastLatency = nowMicros - triggerMicros;
+  totalLatency += lastLatency;
+  if (lastLatency > worstLatency) worstLatency = lastLatency;
+  state = ULTRASONIC_IDLE;
+  return true;
+}
+
+bool UltrasonicSensor::isBusy() const {
+  return state != ULTRASONIC_IDLE;
+}
+
+float UltrasonicSensor::getDistanceCM() const { return lastDistance; }
+unsigned long UltrasonicSensor::getPingCount() const { return pingCount; }
+unsigned long UltrasonicSensor::getTimeoutCount() const { return timeoutCount; }
+unsigned long UltrasonicSensor::getLastLatency() const { return lastLatency; }
+unsigned long UltrasonicSensor::getWorstLatency() const { return worstLatency; }
+
+float UltrasonicSensor::getTimeoutRate() const {
+  if (pingCount == 0) return 0;
+  return timeoutCount * 100.0 / pingCount;
+}
+
+unsigned long UltrasonicSensor::getAverageLatency() const {
+  unsigned long completed = pingCount - (isBusy() ? 1 : 0);
+  if (completed == 0) return 0;
+  return totalLatency / completed;
+}
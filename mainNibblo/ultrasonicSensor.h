@@ -0,0 +1,53 @@
+#ifndef ULTRASONIC_SENSOR_H
+#define ULTRASONIC_SENSOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+enum UltrasonicState {
+  ULTRASONIC_IDLE,
+  ULTRASONIC_WAIT_ECHO,
+  ULTRASONIC_READY,
+  ULTRASONIC_TIMEOUT
+};
+
+// Pengukuran HC-SR04 tanpa pulseIn(): trigger() mengirim ping, ISR mencatat
+// timestamp tepi naik/turun echo, poll() mengambil hasil di pass loop berikutnya.
+// onEchoEdge() dan poll() menerima waktu sebagai argumen supaya bisa disimulasikan.
+class UltrasonicSensor {
+private:
+  uint8_t trigPin;
+  uint8_t echoPin;
+  volatile UltrasonicState state;
+  volatile unsigned long echoStartMicros;
+  volatile unsigned long echoEndMicros;
+  unsigned long triggerMicros;
+  float lastDistance;
+
+  // statistik
+  unsigned long pingCount;
+  unsigned long timeoutCount;
+  unsigned long lastLatency;
+  unsigned long worstLatency;
+  unsigned long totalLatency;
+
+public:
+  UltrasonicSensor();
+  void begin(uint8_t trig, uint8_t echo, void (*isr)());
+  void trigger();
+  void trigger(unsigned long nowMicros);
+  void onEchoEdge(bool level, unsigned long nowMicros);
+  bool poll();
+  bool poll(unsigned long nowMicros);
+  bool isBusy() const;
+
+  float getDistanceCM() const;  // 0 jika ping terakhir timeout
+  unsigned long getPingCount() const;
+  unsigned long getTimeoutCount() const;
+  float getTimeoutRate() const;   // persen
+  unsigned long getLastLatency() const;   // us, trigger sampai hasil diambil
+  unsigned long getWorstLatency() const;
+  unsigned long getAverageLatency() const;
+};
+
+#endif
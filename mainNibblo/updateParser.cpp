@@ -0,0 +1,261 @@
+#include "updateParser.h"
+
+ParserState UpdateParser::state = PARSE_VALUE;
+ParserFrame UpdateParser::frames[UPDATE_PARSER_DEPTH];
+int UpdateParser::depth = 0;
+UpdateField UpdateParser::field = FIELD_NONE;
+char* UpdateParser::target = NULL;
+size_t UpdateParser::targetSize = 0;
+size_t UpdateParser::targetLength = 0;
+uint16_t UpdateParser::unicode = 0;
+uint8_t UpdateParser::unicodeDigits = 0;
+uint16_t UpdateParser::highSurrogate = 0;
+char UpdateParser::literal[UPDATE_LITERAL_SIZE];
+
+long UpdateParser::updateId = -1;
+char UpdateParser::chatId[TELEGRAM_CHAT_ID_SIZE];
+char UpdateParser::text[UPDATE_TEXT_SIZE];
+bool UpdateParser::hasText = false;
+bool UpdateParser::ready = false;
+int UpdateParser::updateCount = 0;
+
+  // dipanggil sebelum tiap getUpdates
+void UpdateParser::reset() {
+  state = PARSE_VALUE;
+  depth = 0;
+  field = FIELD_NONE;
+  target = NULL;
+  updateCount = 0;
+  release();
+}
+
+  // return false jika satu update lengkap sedang ditahan (berhenti membaca)
+bool UpdateParser::feed(char c) {
+  switch (state) {
+    case PARSE_STRING:
+      if (c == '"') finishString();
+      else if (c == '\\') state = PARSE_ESCAPE;
+      else append(c);
+      break;
+
+    case PARSE_ESCAPE:
+      state = PARSE_STRING;
+      switch (c) {
+        case 'n': append('\n'); break;
+        case 'r': append('\r'); break;
+        case 't': append('\t'); break;
+        case 'b': append('\b'); break;
+        case 'f': append('\f'); break;
+        case 'u':
+          unicode = 0;
+          unicodeDigits = 0;
+          state = PARSE_UNICODE;
+          break;
+        default: append(c); break;  // \" \\ \/
+      }
+      break;
+
+    case PARSE_UNICODE: {
+      uint8_t digit = isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10) & 0x0F;
+      unicode = (unicode << 4) | digit;
+      if (++unicodeDigits < 4) break;
+
+      state = PARSE_STRING;
+      // emoji dikirim sebagai pasangan surrogate UTF-16
+      if (unicode >= 0xD800 && unicode <= 0xDBFF) {
+        highSurrogate = unicode;
+      } else if (unicode >= 0xDC00 && unicode <= 0xDFFF) {
+        if (highSurrogate != 0) {
+          appendCodepoint(0x10000 + (((uint32_t)highSurrogate - 0xD800) << 10) + (unicode - 0xDC00));
+        }
+        highSurrogate = 0;
+      } else {
+        appendCodepoint(unicode);
+        highSurrogate = 0;
+      }
+      break;
+    }
+
+    case PARSE_LITERAL:
+      if (isalnum(c) || c == '-' || c == '+' || c == '.') {
+        append(c);
+        break;
+      }
+      finishLiteral();
+      handleStructural(c);
+      break;
+
+    default:
+      handleStructural(c);
+      break;
+  }
+  return !ready;
+}
+
+void UpdateParser::handleStructural(char c) {
+  // frame di atas UPDATE_PARSER_DEPTH hanya dihitung, tidak disimpan
+  bool tracked = depth > 0 && depth <= UPDATE_PARSER_DEPTH;
+  ParserFrame* top = tracked ? &frames[depth - 1] : NULL;
+
+  switch (c) {
+    case ' ': case '\n': case '\r': case '\t':
+      break;
+
+    case '{':
+    case '[':
+      if (depth < UPDATE_PARSER_DEPTH) {
+        frames[depth].isArray = (c == '[');
+        frames[depth].expectKey = (c == '{');
+        frames[depth].key[0] = '\0';
+      }
+      depth++;
+      break;
+
+    case '}':
+    case ']':
+      closeContainer();
+      break;
+
+    case ':':
+      if (top) top->expectKey = false;
+      break;
+
+    case ',':
+      if (top && !top->isArray) top->expectKey = true;
+      break;
+
+    case '"':
+      beginString();
+      break;
+
+    default:
+      beginValue(c);
+      break;
+  }
+}
+
+  // angka / true / false / null
+void UpdateParser::beginValue(char c) {
+  field = matchField();
+  target = literal;
+  targetSize = sizeof(literal);
+  targetLength = 0;
+  literal[0] = '\0';
+  state = PARSE_LITERAL;
+  append(c);
+}
+
+void UpdateParser::beginString() {
+  bool tracked = depth > 0 && depth <= UPDATE_PARSER_DEPTH;
+  targetLength = 0;
+  highSurrogate = 0;
+  state = PARSE_STRING;
+
+  if (tracked && frames[depth - 1].expectKey) {
+    field = FIELD_KEY;
+    target = frames[depth - 1].key;
+    targetSize = UPDATE_KEY_SIZE;
+  } else {
+    field = matchField();
+    target = (field == FIELD_TEXT) ? text : NULL;
+    targetSize = sizeof(text);
+  }
+  if (target) target[0] = '\0';
+}
+
+void UpdateParser::finishString() {
+  state = PARSE_VALUE;
+  if (field == FIELD_TEXT) hasText = true;
+  field = FIELD_NONE;
+  target = NULL;
+}
+
+void UpdateParser::finishLiteral() {
+  state = PARSE_VALUE;
+  if (field == FIELD_UPDATE_ID) {
+    updateId = atol(literal);
+  } else if (field == FIELD_CHAT_ID) {
+    strncpy(chatId, literal, sizeof(chatId) - 1);
+    chatId[sizeof(chatId) - 1] = '\0';
+  }
+  field = FIELD_NONE;
+  target = NULL;
+}
+
+void UpdateParser::closeContainer() {
+  if (depth == 0) return;
+  depth--;
+  // objek elemen result[] ditutup = satu update lengkap
+  if (depth == 2 && keyIs(0, "result") && frames[1].isArray) {
+    ready = true;
+    updateCount++;
+  }
+}
+
+  // Field yang disimpan: result[i].update_id, result[i].message.text,
+  // result[i].message.chat.id. frames[n].key = key value yang sedang dibaca.
+UpdateField UpdateParser::matchField() {
+  if (depth < 3 || depth > 5) return FIELD_NONE;
+  if (!keyIs(0, "result") || !frames[1].isArray) return FIELD_NONE;
+  if (depth == 3) return keyIs(2, "update_id") ? FIELD_UPDATE_ID : FIELD_NONE;
+  if (!keyIs(2, "message")) return FIELD_NONE;
+  if (depth == 4) return keyIs(3, "text") ? FIELD_TEXT : FIELD_NONE;
+  return (keyIs(3, "chat") && keyIs(4, "id")) ? FIELD_CHAT_ID : FIELD_NONE;
+}
+
+bool UpdateParser::keyIs(int level, const char* key) {
+  return !frames[level].isArray && strcmp(frames[level].key, key) == 0;
+}
+
+void UpdateParser::append(char c) {
+  if (target == NULL || targetLength >= targetSize - 1) return;  // dipotong
+  target[targetLength++] = c;
+  target[targetLength] = '\0';
+}
+
+  // encode UTF-8; karakter yang tidak muat utuh dibuang
+void UpdateParser::appendCodepoint(uint32_t codepoint) {
+  char encoded[4];
+  size_t length;
+  if (codepoint < 0x80) {
+    encoded[0] = codepoint;
+    length = 1;
+  } else if (codepoint < 0x800) {
+    encoded[0] = 0xC0 | (codepoint >> 6);
+    encoded[1] = 0x80 | (codepoint & 0x3F);
+    length = 2;
+  } else if (codepoint < 0x10000) {
+    encoded[0] = 0xE0 | (codepoint >> 12);
+    encoded[1] = 0x80 | ((codepoint >> 6) & 0x3F);
+    encoded[2] = 0x80 | (codepoint & 0x3F);
+    length = 3;
+  } else {
+    encoded[0] = 0xF0 | (codepoint >> 18);
+    encoded[1] = 0x80 | ((codepoint >> 12) & 0x3F);
+    encoded[2] = 0x80 | ((codepoint >> 6) & 0x3F);
+    encoded[3] = 0x80 | (codepoint & 0x3F);
+    length = 4;
+  }
+
+  if (target == NULL || targetLength + length > targetSize - 1) return;
+  for (size_t i = 0; i < length; i++) append(encoded[i]);
+}
+
+bool UpdateParser::hasUpdate() {
+  return ready;
+}
+
+  // update sudah diproses, lanjutkan parsing dan kosongkan field
+void UpdateParser::release() {
+  ready = false;
+  updateId = -1;
+  hasText = false;
+  chatId[0] = '\0';
+  text[0] = '\0';
+}
+
+long UpdateParser::getUpdateId() { return updateId; }
+bool UpdateParser::hasMessageText() { return hasText && chatId[0] != '\0'; }
+const char* UpdateParser::getChatId() { return chatId; }
+char* UpdateParser::getText() { return text; }
+int UpdateParser::getUpdateCount() { return updateCount; }
\ No newline at end of file
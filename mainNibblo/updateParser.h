@@ -0,0 +1,79 @@
+#ifndef UPDATE_PARSER_H
+#define UPDATE_PARSER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+enum ParserState {
+  PARSE_VALUE,
+  PARSE_STRING,
+  PARSE_ESCAPE,
+  PARSE_UNICODE,
+  PARSE_LITERAL
+};
+
+enum UpdateField {
+  FIELD_NONE,
+  FIELD_KEY,
+  FIELD_UPDATE_ID,
+  FIELD_CHAT_ID,
+  FIELD_TEXT
+};
+
+struct ParserFrame {
+  bool isArray;
+  bool expectKey;
+  char key[UPDATE_KEY_SIZE];  // key dari value yang sedang dibuka di level ini
+};
+
+// Parser streaming untuk respons getUpdates. Body dimasukkan byte per byte
+// lewat feed(); hanya update_id, message.chat.id dan message.text yang
+// disimpan, ke buffer ukuran tetap. Setiap kali satu update selesai, feed()
+// return false dan parser menahan update itu sampai release() dipanggil,
+// jadi pemakaian memori tidak bergantung pada jumlah update di respons.
+class UpdateParser {
+private:
+  static ParserState state;
+  static ParserFrame frames[UPDATE_PARSER_DEPTH];
+  static int depth;
+  static UpdateField field;
+  static char* target;
+  static size_t targetSize;
+  static size_t targetLength;
+  static uint16_t unicode;
+  static uint8_t unicodeDigits;
+  static uint16_t highSurrogate;
+  static char literal[UPDATE_LITERAL_SIZE];
+
+  static long updateId;
+  static char chatId[TELEGRAM_CHAT_ID_SIZE];
+  static char text[UPDATE_TEXT_SIZE];
+  static bool hasText;
+  static bool ready;
+  static int updateCount;
+
+  static void handleStructural(char c);
+  static void beginValue(char c);
+  static void beginString();
+  static void finishString();
+  static void finishLiteral();
+  static void closeContainer();
+  static UpdateField matchField();
+  static bool keyIs(int level, const char* key);
+  static void append(char c);
+  static void appendCodepoint(uint32_t codepoint);
+
+public:
+  static void reset();
+  static bool feed(char c);
+  static bool hasUpdate();
+  static void release();
+
+  static long getUpdateId();
+  static bool hasMessageText();
+  static const char* getChatId();
+  static char* getText();             // boleh diubah di tempat (trim/lowercase)
+  static int getUpdateCount();
+};
+
+#endif
\ No newline at end of file
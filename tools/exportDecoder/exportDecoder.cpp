@@ -0,0 +1,106 @@
+// Dekoder file .nbz hasil /export (LogExporter di mainNibblo) menjadi CSV.
+//
+//   g++ -O2 -o exportDecoder exportDecoder.cpp
+//   ./exportDecoder nibblo_1760000000.nbz > nibblo.csv
+//
+// Format: "NBZ2", panjang CSV (uint32 little endian), parameter LZSS
+// (window bits, length bits, min match, 1 byte cadangan), lalu stream LZSS
+// (lihat mainNibblo/lzssEncoder.h). File "NBZ1" lama tanpa parameter selalu
+// memakai 10/6/3.
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct LzssParams {
+  int windowBits;
+  int lengthBits;
+  int minMatch;
+};
+
+static const LzssParams nbz1Params = { 10, 6, 3 };
+
+  // panjang header file, 0 jika bukan file ekspor yang dikenal
+static size_t readHeader(const std::vector<uint8_t>& input, uint32_t& rawLength, LzssParams& params) {
+  if (input.size() < 8) return 0;
+  rawLength = input[4] | (input[5] << 8) | (input[6] << 16) | ((uint32_t)input[7] << 24);
+  if (memcmp(input.data(), "NBZ1", 4) == 0) {
+    params = nbz1Params;
+    return 8;
+  }
+  if (input.size() < 12 || memcmp(input.data(), "NBZ2", 4) != 0) return 0;
+  params.windowBits = input[8];
+  params.lengthBits = input[9];
+  params.minMatch = input[10];
+  // token match = 2 byte: offset dan panjang harus mengisi tepat 16 bit
+  if (params.windowBits < 1 || params.lengthBits < 1 || params.windowBits + params.lengthBits != 16) {
+    fprintf(stderr, "unsupported LZSS parameters %d/%d\n", params.windowBits, params.lengthBits);
+    return 0;
+  }
+  return 12;
+}
+
+static bool decode(const std::vector<uint8_t>& input, std::vector<uint8_t>& output) {
+  uint32_t rawLength;
+  LzssParams params;
+  size_t pos = readHeader(input, rawLength, params);
+  if (pos == 0) {
+    fprintf(stderr, "not a Nibblo export file\n");
+    return false;
+  }
+  output.clear();
+  output.reserve(rawLength);
+
+  while (output.size() < rawLength && pos < input.size()) {
+    uint8_t flags = input[pos++];
+    for (int token = 0; token < 8 && output.size() < rawLength; token++) {
+      if (flags & (1 << token)) {
+        if (pos >= input.size()) break;
+        output.push_back(input[pos++]);
+        continue;
+      }
+      if (pos + 1 >= input.size()) break;
+      uint16_t code = input[pos] | (input[pos + 1] << 8);
+      pos += 2;
+      size_t offset = (code & ((1 << params.windowBits) - 1)) + 1;
+      size_t length = (code >> params.windowBits) + params.minMatch;
+      if (offset > output.size()) {
+        fprintf(stderr, "corrupt match at byte %zu\n", pos - 2);
+        return false;
+      }
+      // byte per byte: match boleh tumpang tindih dengan dirinya sendiri
+      for (size_t i = 0; i < length; i++) output.push_back(output[output.size() - offset]);
+    }
+  }
+
+  if (output.size() != rawLength) {
+    fprintf(stderr, "truncated: %zu of %u bytes\n", output.size(), rawLength);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <export.nbz>\n", argv[0]);
+    return 2;
+  }
+
+  FILE* file = fopen(argv[1], "rb");
+  if (!file) {
+    perror(argv[1]);
+    return 1;
+  }
+  std::vector<uint8_t> input;
+  uint8_t buffer[4096];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    input.insert(input.end(), buffer, buffer + count);
+  }
+  fclose(file);
+
+  std::vector<uint8_t> output;
+  if (!decode(input, output)) return 1;
+  fwrite(output.data(), 1, output.size(), stdout);
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Shim API Arduino/ESP8266 untuk simulator host (lihat simulator.h).
+// Hanya bagian yang dipakai firmware; pin, ADC, servo, OLED dan RTC lewat Hal.
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+
+#define HIGH 1
+#define LOW 0
+#define A0 17
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+class String {
+private:
+  std::string text;
+
+public:
+  String() {}
+  String(const char* value) : text(value ? value : "") {}
+  String(const std::string& value) : text(value) {}
+  String(char c, int count = 1) : text(count, c) {}
+  explicit String(int value) : text(std::to_string(value)) {}
+  explicit String(unsigned int value) : text(std::to_string(value)) {}
+  explicit String(long value) : text(std::to_string(value)) {}
+  explicit String(unsigned long value) : text(std::to_string(value)) {}
+  explicit String(float value, unsigned int decimals = 2) { setFloat(value, decimals); }
+  explicit String(double value, unsigned int decimals = 2) { setFloat(value, decimals); }
+
+  const char* c_str() const { return text.c_str(); }
+  unsigned int length() const { return text.size(); }
+  bool isEmpty() const { return text.empty(); }
+  bool reserve(unsigned int size) { text.reserve(size); return true; }
+  char charAt(unsigned int index) const { return index < text.size() ? text[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+
+  String& operator+=(const String& other) { text += other.text; return *this; }
+  String& operator+=(const char* other) { text += other ? other : ""; return *this; }
+  String& operator+=(char c) { text += c; return *this; }
+  String& operator+=(int value) { text += std::to_string(value); return *this; }
+  String& operator+=(unsigned int value) { text += std::to_string(value); return *this; }
+  String& operator+=(long value) { text += std::to_string(value); return *this; }
+  String& operator+=(unsigned long value) { text += std::to_string(value); return *this; }
+  bool concat(const String& other) { text += other.text; return true; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+  friend String operator+(const String& a, const char* b) { return String(a.text + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.text); }
+  friend String operator+(const String& a, char c) { return String(a.text + c); }
+
+  bool operator==(const String& other) const { return text == other.text; }
+  bool operator==(const char* other) const { return text == (other ? other : ""); }
+  bool operator!=(const String& other) const { return text != other.text; }
+  bool operator!=(const char* other) const { return !(*this == other); }
+  bool equals(const String& other) const { return text == other.text; }
+  bool equalsIgnoreCase(const String& other) const;
+  bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+  bool endsWith(const String& suffix) const;
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String& value, unsigned int from = 0) const;
+  int lastIndexOf(char c) const;
+  String substring(unsigned int from) const;
+  String substring(unsigned int from, unsigned int to) const;
+  void trim();
+  void toLowerCase();
+  void toUpperCase();
+  void replace(const String& from, const String& to);
+  void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+  long toInt() const { return atol(text.c_str()); }
+  float toFloat() const { return atof(text.c_str()); }
+  void toCharArray(char* buffer, unsigned int size) const;
+
+private:
+  void setFloat(double value, unsigned int decimals);
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+  virtual void flush() {}
+
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned int value) { return printf("%u", value); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(unsigned long value) { return printf("%lu", value); }
+  size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T& value) { return print(value) + println(); }
+  size_t println(double value, int digits) { return print(value, digits) + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() { return -1; }
+  void setTimeout(unsigned long ms) { timeout = ms; }
+
+protected:
+  unsigned long timeout = 1000;
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+class IPAddress {
+private:
+  uint32_t address;
+
+public:
+  IPAddress() : address(0) {}
+  IPAddress(uint32_t value) : address(value) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    : address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+  operator uint32_t() const { return address; }
+  uint8_t operator[](int index) const { return (address >> (index * 8)) & 0xFF; }
+  bool isSet() const { return address != 0; }
+  String toString() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef SIM_ESP8266_WIFI_H
+#define SIM_ESP8266_WIFI_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+enum wl_status_t {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+};
+
+enum WiFiMode_t { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA };
+enum WiFiSleepType_t { WIFI_NONE_SLEEP, WIFI_LIGHT_SLEEP, WIFI_MODEM_SLEEP };
+
+// Station WiFi simulasi: asosiasi selesai setelah waktu scan + DHCP
+// (atau lebih cepat dengan channel/BSSID/IP statis), putus selama gangguan soak
+class ESP8266WiFiClass {
+private:
+  WiFiMode_t wifiMode;
+  bool joining;
+  uint64_t joinStartUs;
+  uint64_t joinedAtUs;
+  bool staticIp;
+
+public:
+  ESP8266WiFiClass() : wifiMode(WIFI_OFF), joining(false), joinStartUs(0), joinedAtUs(0), staticIp(false) {}
+  wl_status_t status();
+  void mode(WiFiMode_t value);
+  void begin(const char* ssid, const char* password, int32_t channel = 0,
+             const uint8_t* bssid = NULL, bool connect = true);
+  bool config(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns = IPAddress());
+  void disconnect(bool wifiOff = false);
+  void persistent(bool value) { (void)value; }
+  bool setSleepMode(WiFiSleepType_t type) { (void)type; return true; }
+  bool setAutoReconnect(bool value) { (void)value; return true; }
+
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  IPAddress subnetMask();
+  IPAddress dnsIP(uint8_t index = 0);
+  String SSID();
+  int32_t RSSI();
+  uint8_t* BSSID();
+  int32_t channel();
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+namespace fs {
+
+enum SeekMode { SeekSet, SeekCur, SeekEnd };
+
+// File LittleFS = file biasa di direktori host (--fs)
+class File : public Stream {
+private:
+  std::shared_ptr<FILE> handle;
+
+public:
+  File() {}
+  explicit File(FILE* file);
+  operator bool() const { return handle != nullptr; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  size_t read(uint8_t* buffer, size_t size);
+  int peek() override;
+  bool seek(uint32_t position, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void flush() override;
+  void close() { handle.reset(); }
+};
+
+class FS {
+public:
+  bool begin();
+  bool format();
+  File open(const char* path, const char* mode);
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+};
+
+}
+
+using fs::File;
+
+#endif
\ No newline at end of file
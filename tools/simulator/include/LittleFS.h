@@ -0,0 +1,8 @@
+#ifndef SIM_LITTLEFS_H
+#define SIM_LITTLEFS_H
+
+#include <FS.h>
+
+extern fs::FS LittleFS;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef SIM_TIMELIB_H
+#define SIM_TIMELIB_H
+
+// TimeManager tidak memakai fungsi TimeLib; header kosong untuk simulator
+
+#endif
\ No newline at end of file
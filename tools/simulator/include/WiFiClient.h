@@ -0,0 +1,33 @@
+#ifndef SIM_WIFI_CLIENT_H
+#define SIM_WIFI_CLIENT_H
+
+#include <Arduino.h>
+
+struct SimConnection;
+
+// Koneksi TCP ke server palsu simulator (lihat simNetwork.cpp). Data respons
+// baru terbaca setelah jam virtual melewati latensi jaringan.
+class WiFiClient : public Stream {
+protected:
+  SimConnection* connection;
+
+public:
+  WiFiClient();
+  virtual ~WiFiClient();
+  WiFiClient(const WiFiClient&) = delete;
+  WiFiClient& operator=(const WiFiClient&) = delete;
+
+  virtual int connect(const char* host, uint16_t port);
+  uint8_t connected();
+  void stop();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size);
+  int peek() override;
+  void setNoDelay(bool noDelay) { (void)noDelay; }
+};
+
+#endif
\ No newline at end of file
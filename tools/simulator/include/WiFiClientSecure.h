@@ -0,0 +1,32 @@
+#ifndef SIM_WIFI_CLIENT_SECURE_H
+#define SIM_WIFI_CLIENT_SECURE_H
+
+#include <WiFiClient.h>
+
+namespace BearSSL {
+
+// hanya menandai handshake penuh sudah pernah terjadi
+class Session {
+public:
+  bool valid = false;
+};
+
+// TLS tidak disimulasikan; yang dihitung hanya waktu handshake
+class WiFiClientSecure : public WiFiClient {
+private:
+  Session* session;
+
+public:
+  WiFiClientSecure() : session(NULL) {}
+  void setInsecure() {}
+  void setSession(Session* value) { session = value; }
+  void setBufferSizes(int receive, int transmit) { (void)receive; (void)transmit; }
+  bool probeMaxFragmentLength(const char* host, uint16_t port, uint16_t length);
+  int connect(const char* host, uint16_t port) override;
+};
+
+}
+
+using BearSSL::WiFiClientSecure;
+
+#endif
\ No newline at end of file
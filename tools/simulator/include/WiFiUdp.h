@@ -0,0 +1,29 @@
+#ifndef SIM_WIFI_UDP_H
+#define SIM_WIFI_UDP_H
+
+#include <Arduino.h>
+
+#define SIM_UDP_PACKET_SIZE 48
+
+// UDP ke server NTP palsu: satu paket balasan per request
+class WiFiUDP {
+private:
+  uint8_t packet[SIM_UDP_PACKET_SIZE];
+  size_t packetLength;
+  bool replyPending;
+  uint64_t replyAtUs;
+  bool sending;
+
+public:
+  WiFiUDP() : packetLength(0), replyPending(false), replyAtUs(0), sending(false) {}
+  uint8_t begin(uint16_t port) { (void)port; return 1; }
+  void stop() { replyPending = false; }
+  int beginPacket(const char* host, uint16_t port);
+  size_t write(const uint8_t* buffer, size_t size);
+  int endPacket();
+  int parsePacket();
+  int read(uint8_t* buffer, size_t size);
+  void flush() { packetLength = 0; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef CREDENTIAL_H
+#define CREDENTIAL_H
+
+// Kredensial palsu simulator, dipakai jika mainNibblo/credential.h tidak ada
+#define WIFI_SSID "nibblo-sim"
+#define WIFI_PASSWORD "nibblo-sim"
+#define BOT_TOKEN "0:SIM"
+#define CHAT_ID "100000001"
+
+#endif
\ No newline at end of file
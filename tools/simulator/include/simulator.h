@@ -0,0 +1,118 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define SIM_RTC_MEMORY_SIZE 512
+#define SIM_TIMER_SLOTS 8
+#define SIM_CALL_COST_US 5               // biaya virtual tiap millis()/micros(), busy-wait tetap maju
+#define SIM_WDT_TIMEOUT_US 3200000ULL    // soft WDT ESP8266: tanpa yield()/delay() selama ini = reset
+#define SIM_HEAP_FREE 42000              // heap bebas ESP8266 setelah WiFi + TLS siap
+#define SIM_BOOT_ROM_US 120000ULL        // ROM bootloader sampai setup()
+
+enum SimResetReason {
+  SIM_RESET_POWER_ON,
+  SIM_RESET_DEEP_SLEEP,
+  SIM_RESET_RESTART,
+  SIM_RESET_WDT
+};
+
+// Satu baris trace sensor; nilai di antara dua baris diinterpolasi linear
+struct SimSensorSample {
+  uint32_t second;            // detik sejak awal simulasi
+  float foodCm;               // jarak ultrasonik, <= 0 = tidak ada echo
+  float waterCm;
+  float batteryVolt;
+};
+
+// State yang bertahan antar boot. Tiap boot firmware dijalankan di proses
+// anak (fork) sehingga variabel static firmware kembali ke nilai awal seperti
+// RAM setelah reset; hanya blok ini (memori bersama) yang dibawa ke boot berikutnya.
+struct SimShared {
+  uint64_t nowUs;             // waktu virtual sejak awal simulasi
+  uint64_t endUs;
+  uint64_t bootUs;            // nowUs saat reset terakhir
+  uint64_t startEpoch;        // UTC saat nowUs = 0
+  uint8_t resetReason;        // penyebab boot yang sedang berjalan
+  uint8_t exitReason;         // reset yang diminta firmware saat proses anak keluar
+  uint8_t finished;
+  uint64_t sleepUs;
+  uint32_t rtcMemory[SIM_RTC_MEMORY_SIZE / 4];
+  int16_t servoAngle;         // posisi fisik servo, -1 = belum pernah digerakkan
+
+  // server Telegram palsu
+  long telegramOffset;        // update_id yang sudah dikonfirmasi getUpdates
+
+  // server NTP palsu: jam server salah sebesar ini (tes host), selain gangguan soak
+  int64_t ntpOffsetUs;
+
+  // statistik
+  uint32_t bootCount;
+  uint32_t sleepCount;
+  uint32_t restartCount;
+  uint32_t wdtCount;
+  uint32_t feedCount;
+  uint32_t messageCount;
+  uint32_t ntpCount;
+  uint64_t awakeUs;
+};
+
+// Pilihan dari command line, dibaca proses anak (hasil fork)
+struct SimOptions {
+  const char* fsRoot;         // direktori pengganti LittleFS
+  const char* eventsPath;     // CSV event (feed, boot, sleep, pesan Telegram)
+  const char* framesPath;     // dump frame OLED
+  bool quiet;                 // Serial tidak dicetak
+  uint32_t millisOffset;      // millis() saat reset, untuk menguji wrap (hanya berarti dengan -m32)
+};
+
+// Inti simulator: jam virtual, timer (tepi echo), reset, trace sensor dan
+// keluaran. Dipakai halSim.cpp dan shim API Arduino.
+class Sim {
+private:
+  static bool inTimer;
+  static uint64_t lastYieldUs;
+  static bool lineStart;
+  static FILE* eventsFile;
+  static FILE* framesFile;
+  static size_t heapBaseline;
+
+public:
+  static SimShared* shared;
+  static SimOptions options;
+
+  // Disiapkan proses induk sebelum boot pertama
+  static bool loadTrace(const char* path);
+  static void addTraceSample(const SimSensorSample& sample);
+  static bool hasTrace();
+  static void addTelegramCommand(uint64_t atUs, const char* text);
+  static void beginBoot();
+
+  // Jam virtual. advance() = waktu CPU (diawasi WDT), sleep() = delay()/yield()
+  static uint64_t now();
+  static uint64_t getBootMicros();
+  static uint64_t getUtcMicros();
+  static void advance(uint64_t us);
+  static void sleep(uint64_t us);
+  static void schedule(uint64_t atUs, void (*callback)(int), int arg);
+
+  static void reset(SimResetReason reason, uint64_t sleepUs);   // tidak kembali
+  static void finish();                                         // tidak kembali
+  static SimSensorSample getTrace();        // nilai sebenarnya dari trace
+  static SimSensorSample getSensors();      // yang dibaca sensor (+ gangguan soak)
+  static void recordFeed();
+  static uint32_t getFreeHeap();
+
+  // Keluaran: Serial (stdout), event CSV, frame OLED
+  static void serialWrite(uint8_t c);
+  static void event(const char* type, const char* format, ...);
+  static void dumpFrame(const char* frame);
+  static void formatTime(uint64_t us, char* buffer, size_t size);
+
+  static const char* getFsRoot();
+  static const char* getTelegramCommand(uint32_t index, uint64_t& atUs);
+};
+
+#endif
\ No newline at end of file
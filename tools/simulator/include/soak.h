@@ -0,0 +1,63 @@
+#ifndef SOAK_H
+#define SOAK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define SOAK_MAX_DAYS 400
+#define SOAK_MAX_FEEDS 4096
+#define SOAK_MAX_EXPECTED 10
+#define SOAK_PROBE_INTERVAL_US 10000000ULL   // sampel heap, jam & flag alert selama firmware bangun
+#define SOAK_WARMUP_US 3600000000ULL          // jam pertama (cold boot, jadwal default dibuat) tidak dinilai
+#define SOAK_FEED_SLACK_S 180                 // boot + WiFi + sensor sebelum feed catch-up
+#define SOAK_ALERT_GRACE_US 2700000000ULL     // 45 menit waktu bangun: lag filter sensor + konfirmasi bacaan
+#define SOAK_HEAP_FLOOR 10000                 // heap bebas minimum (health check firmware mulai di 5 KB)
+#define SOAK_HEAP_DRIFT 2048                  // heap minimum minggu terakhir boleh turun segini dari minggu pertama
+#define SOAK_WIFI_DROP_MIN_S 20
+#define SOAK_WIFI_DROP_MAX_S 1500             // gangguan biasa, < FEED_CATCHUP_WINDOW
+#define SOAK_OUTAGE_MIN_S 7200                // AP mati berjam-jam: > FEED_CATCHUP_WINDOW, banyak siklus sleep
+#define SOAK_OUTAGE_MAX_S 28800
+#define SOAK_MAX_OUTAGES 256
+#define SOAK_RESTART_LOOP 3                   // restart sebanyak ini dalam satu gangguan panjang = gagal
+#define SOAK_OUTAGE_AWAKE_MAX 0.10            // fraksi waktu bangun selama gangguan panjang (duty cycle)
+#define SOAK_NTP_JUMP_MIN_S 30
+#define SOAK_NTP_JUMP_MAX_S 600
+#define SOAK_LOW_BATTERY_VOLT 6.15f           // ~6%, di bawah CRITICAL_BATTERY_THRESHOLD
+
+// Profil gangguan; nilai < 0 = pakai default profil soak
+struct SoakOptions {
+  bool enabled;
+  uint64_t seed;
+  float wifiDropsPerDay;
+  float outagesPerDay;        // gangguan WiFi panjang (SOAK_OUTAGE_MIN_S..MAX_S)
+  float ntpJumpsPerDay;
+  float noiseCm;              // sigma noise ultrasonik (+ spike & echo hilang)
+  float lowBatteryEvery;      // hari per episode baterai kritis
+  const char* dailyPath;      // CSV statistik per hari virtual
+  int expectedMinutes[SOAK_MAX_EXPECTED];  // jadwal makan harian (menit waktu lokal)
+  int expectedCount;
+};
+
+// Soak test: gangguan (WiFi putus, noise sensor, baterai kritis, lompatan
+// NTP) dijadwalkan dari seed oleh proses induk sebelum boot pertama, lalu
+// dibaca hook simulator di proses anak. probe() mengambil sampel firmware
+// selama bangun; report() menilai hasil akhir dan menulis CSV per hari.
+class Soak {
+public:
+  static SoakOptions options;
+
+  static bool parseFeedTime(const char* text);
+  static void plan(uint64_t endUs, bool hasTrace);    // proses induk, sebelum boot pertama
+  static void collect();                              // proses induk, setelah tiap boot
+  static int report(FILE* out);                       // jumlah pelanggaran
+
+  // Hook simulator (netral jika soak tidak aktif)
+  static bool isNetworkUp(uint64_t us, uint64_t& restoredUs);
+  static int64_t getNtpOffsetUs(uint64_t us);
+  static void perturb(uint64_t us, float& foodCm, float& waterCm, float& batteryVolt);
+  static void recordFeed(uint64_t us);
+  static void probe();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,241 @@
+// Simulator host untuk firmware Nibblo: setup() dan loop() asli berjalan di
+// atas jam virtual (lihat include/simulator.h dan mainNibblo/halSim.cpp).
+//
+//   cd tools/simulator
+//   g++ -std=gnu++17 -O2 -DNIBBLO_SIM -Iinclude -I../../mainNibblo
+//       *.cpp ../../mainNibblo/*.cpp -o nibbloSim
+//   ./nibbloSim --days 3 --trace trace.csv --events events.csv
+//       --frames frames.txt --command 3600:/status
+//
+// Soak test 60 hari dengan gangguan (WiFi putus, noise sensor, baterai
+// kritis, lompatan NTP) dan penilaian feed/alert/heap, exit 3 jika gagal:
+//
+//   ./nibbloSim --soak --quiet --seed 7 --daily soak.csv
+//
+// Tambahkan -m32 jika toolchain host mendukung: unsigned long jadi 32 bit
+// seperti ESP8266 sehingga millis() wrap di ~49.7 hari (lebih cepat dengan
+// --millis-offset, atau -DDUTY_CYCLE_ENABLED=0 supaya satu boot berjalan
+// berhari-hari). Di host 64 bit millis() tidak pernah wrap.
+//
+// Tes & benchmark per modul (tanpa setup()/loop()) ada di tests/, jalankan
+// tests/run.sh.
+#include <simulator.h>
+#include <soak.h>
+#include <LittleFS.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SIM_DEFAULT_START 1760054400ULL  // 2025-10-10 00:00 UTC
+
+void setup();
+void loop();
+
+static const char* resetName(uint8_t reason) {
+  switch (reason) {
+    case SIM_RESET_DEEP_SLEEP: return "deep sleep";
+    case SIM_RESET_RESTART: return "restart";
+    case SIM_RESET_WDT: return "wdt";
+    default: return "power on";
+  }
+}
+
+static void usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --days N            virtual days to run (default 1)\n"
+          "  --hours N           virtual hours to run\n"
+          "  --start EPOCH       UTC at simulation start\n"
+          "  --trace FILE        sensor trace: second,food_cm,water_cm,battery_v\n"
+          "  --command SEC:TEXT  Telegram message from the owner at SEC (repeatable)\n"
+          "  --fs DIR            directory backing LittleFS (default simfs, cleared)\n"
+          "  --keep-fs           keep LittleFS contents from a previous run\n"
+          "  --events FILE       CSV of boots, feeds, servo moves and bot messages\n"
+          "  --frames FILE       OLED frame dump\n"
+          "  --quiet             do not print Serial output\n"
+          "  --millis-offset MS  millis() value at reset (wrap testing, needs a 32-bit build)\n"
+          "soak test (60 days unless --days/--hours is given):\n"
+          "  --soak              inject faults and check feeds, alerts and heap (exit 3 on failure)\n"
+          "  --seed N            fault schedule seed (default 1)\n"
+          "  --wifi-drops N      WiFi outages per day (default 2)\n"
+          "  --outages N         WiFi outages of 2-8 hours per day (default 0.2)\n"
+          "  --ntp-jumps N       NTP server offset episodes per day (default 0.25)\n"
+          "  --noise CM          ultrasonic noise sigma (default 0.3)\n"
+          "  --low-battery DAYS  one critical battery episode every DAYS (default 15, 0 = off)\n"
+          "  --expect-feed HH:MM daily feed to check (repeatable, default 08:00)\n"
+          "  --daily FILE        per-virtual-day statistics CSV\n",
+          program);
+}
+
+  // satu boot = satu proses anak: static firmware mulai dari nilai awal
+static bool runBoot() {
+  fflush(NULL);
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    return false;
+  }
+  if (pid == 0) {
+    Sim::beginBoot();
+    Sim::event("boot", "%s", resetName(Sim::shared->resetReason));
+    setup();
+    for (;;) loop();
+  }
+
+  int status;
+  waitpid(pid, &status, 0);
+  if (WIFSIGNALED(status) || WEXITSTATUS(status) != 0) {
+    char stamp[24];
+    Sim::formatTime(Sim::shared->nowUs, stamp, sizeof(stamp));
+    fprintf(stderr, "firmware crashed at %s (%s %d)\n", stamp,
+            WIFSIGNALED(status) ? "signal" : "exit", WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+    return false;
+  }
+  return true;
+}
+
+static void truncateFile(const char* path, const char* header) {
+  if (!path) return;
+  FILE* file = fopen(path, "w");
+  if (!file) return;
+  fputs(header, file);
+  fclose(file);
+}
+
+int main(int argc, char** argv) {
+  static const struct option longOptions[] = {
+    { "days", required_argument, NULL, 'd' },
+    { "hours", required_argument, NULL, 'h' },
+    { "start", required_argument, NULL, 's' },
+    { "trace", required_argument, NULL, 't' },
+    { "command", required_argument, NULL, 'c' },
+    { "fs", required_argument, NULL, 'f' },
+    { "keep-fs", no_argument, NULL, 'k' },
+    { "events", required_argument, NULL, 'e' },
+    { "frames", required_argument, NULL, 'o' },
+    { "quiet", no_argument, NULL, 'q' },
+    { "millis-offset", required_argument, NULL, 'm' },
+    { "soak", no_argument, NULL, 'S' },
+    { "seed", required_argument, NULL, 'R' },
+    { "wifi-drops", required_argument, NULL, 'W' },
+    { "outages", required_argument, NULL, 'O' },
+    { "ntp-jumps", required_argument, NULL, 'N' },
+    { "noise", required_argument, NULL, 'n' },
+    { "low-battery", required_argument, NULL, 'B' },
+    { "expect-feed", required_argument, NULL, 'x' },
+    { "daily", required_argument, NULL, 'D' },
+    { NULL, 0, NULL, 0 }
+  };
+
+  Sim::shared = (SimShared*)mmap(NULL, sizeof(SimShared), PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (Sim::shared == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  memset(Sim::shared, 0, sizeof(SimShared));
+  SimShared& shared = *Sim::shared;
+  shared.startEpoch = SIM_DEFAULT_START;
+  shared.servoAngle = -1;
+  double hours = 0;
+  bool keepFs = false;
+
+  int option;
+  while ((option = getopt_long(argc, argv, "", longOptions, NULL)) != -1) {
+    switch (option) {
+      case 'd': hours = atof(optarg) * 24; break;
+      case 'h': hours = atof(optarg); break;
+      case 's': shared.startEpoch = strtoull(optarg, NULL, 10); break;
+      case 't':
+        if (!Sim::loadTrace(optarg)) {
+          fprintf(stderr, "cannot load trace %s\n", optarg);
+          return 1;
+        }
+        break;
+      case 'c': {
+        const char* text = strchr(optarg, ':');
+        if (!text) {
+          usage(argv[0]);
+          return 1;
+        }
+        Sim::addTelegramCommand((uint64_t)(atof(optarg) * 1e6), text + 1);
+        break;
+      }
+      case 'f': Sim::options.fsRoot = optarg; break;
+      case 'k': keepFs = true; break;
+      case 'e': Sim::options.eventsPath = optarg; break;
+      case 'o': Sim::options.framesPath = optarg; break;
+      case 'q': Sim::options.quiet = true; break;
+      case 'm': Sim::options.millisOffset = strtoul(optarg, NULL, 0); break;
+      case 'S': Soak::options.enabled = true; break;
+      case 'R': Soak::options.seed = strtoull(optarg, NULL, 10); break;
+      case 'W': Soak::options.wifiDropsPerDay = atof(optarg); break;
+      case 'O': Soak::options.outagesPerDay = atof(optarg); break;
+      case 'N': Soak::options.ntpJumpsPerDay = atof(optarg); break;
+      case 'n': Soak::options.noiseCm = atof(optarg); break;
+      case 'B': Soak::options.lowBatteryEvery = atof(optarg); break;
+      case 'x':
+        if (!Soak::parseFeedTime(optarg)) {
+          usage(argv[0]);
+          return 1;
+        }
+        break;
+      case 'D': Soak::options.dailyPath = optarg; break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+  if (hours <= 0) hours = Soak::options.enabled ? 60 * 24 : 24;
+  shared.endUs = (uint64_t)(hours * 3600e6);
+  shared.resetReason = SIM_RESET_POWER_ON;
+  if (Sim::options.millisOffset && sizeof(unsigned long) > 4) {
+    fprintf(stderr, "--millis-offset ignored: unsigned long is 64-bit on this host, build with -m32\n");
+    Sim::options.millisOffset = 0;
+  }
+  if (Soak::options.enabled) Soak::plan(shared.endUs, Sim::hasTrace());
+
+  LittleFS.begin();
+  if (!keepFs) LittleFS.format();
+  truncateFile(Sim::options.eventsPath, "second,type,detail\n");
+  truncateFile(Sim::options.framesPath, "");
+
+  struct timespec wallStart, wallEnd;
+  clock_gettime(CLOCK_MONOTONIC, &wallStart);
+
+  bool crashed = false;
+  while (!shared.finished) {
+    if (!runBoot()) {
+      crashed = true;
+      break;
+    }
+    if (shared.finished) break;
+
+    switch (shared.exitReason) {
+      case SIM_RESET_DEEP_SLEEP: shared.sleepCount++; break;
+      case SIM_RESET_RESTART: shared.restartCount++; break;
+      case SIM_RESET_WDT: shared.wdtCount++; break;
+    }
+    Soak::collect();
+    if (shared.exitReason == SIM_RESET_DEEP_SLEEP) shared.nowUs += shared.sleepUs;
+    shared.nowUs += SIM_BOOT_ROM_US;
+    shared.resetReason = shared.exitReason;
+    if (shared.nowUs >= shared.endUs) break;
+  }
+
+  Soak::collect();
+  clock_gettime(CLOCK_MONOTONIC, &wallEnd);
+  double wall = (wallEnd.tv_sec - wallStart.tv_sec) + (wallEnd.tv_nsec - wallStart.tv_nsec) / 1e9;
+  double simulated = shared.endUs / 1e6;
+  fprintf(stderr, "Simulated %.2f days in %.2f s (%.0fx real time)\n",
+          simulated / 86400, wall, wall > 0 ? simulated / wall : 0);
+  fprintf(stderr, "  boots: %u (deep sleep %u, restart %u, wdt %u), awake %.1f%%\n",
+          shared.bootCount, shared.sleepCount, shared.restartCount, shared.wdtCount,
+          shared.awakeUs * 100.0 / simulated / 1e6);
+  fprintf(stderr, "  feeds: %u, bot messages: %u, ntp requests: %u\n",
+          shared.feedCount, shared.messageCount, shared.ntpCount);
+  if (crashed) return 2;
+  return Soak::report(stderr) ? 3 : 0;
+}
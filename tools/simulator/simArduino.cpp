@@ -0,0 +1,127 @@
+#include <Arduino.h>
+#include <simulator.h>
+
+HardwareSerial Serial;
+
+  // Jam firmware = waktu virtual sejak reset (+ --millis-offset). unsigned long
+  // mengikuti ABI host: dengan -m32 millis() wrap di 2^32 seperti ESP8266.
+unsigned long millis() {
+  Sim::advance(SIM_CALL_COST_US);
+  return (unsigned long)(Sim::getBootMicros() / 1000 + Sim::options.millisOffset);
+}
+
+unsigned long micros() {
+  Sim::advance(SIM_CALL_COST_US);
+  return (unsigned long)(Sim::getBootMicros() + Sim::options.millisOffset * 1000ULL);
+}
+
+void delay(unsigned long ms) { Sim::sleep((uint64_t)ms * 1000); }
+void delayMicroseconds(unsigned int us) { Sim::advance(us); }
+void yield() { Sim::sleep(SIM_CALL_COST_US); }
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+  return text.size() == other.text.size() && strcasecmp(text.c_str(), other.text.c_str()) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  return text.size() >= suffix.text.size() &&
+         text.compare(text.size() - suffix.text.size(), suffix.text.size(), suffix.text) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t found = text.find(c, from);
+  return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::indexOf(const String& value, unsigned int from) const {
+  size_t found = text.find(value.text, from);
+  return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t found = text.rfind(c);
+  return found == std::string::npos ? -1 : (int)found;
+}
+
+String String::substring(unsigned int from) const {
+  return from >= text.size() ? String() : String(text.substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= text.size()) return String();
+  return String(text.substr(from, to - from));
+}
+
+void String::trim() {
+  size_t first = 0;
+  while (first < text.size() && isspace((unsigned char)text[first])) first++;
+  size_t last = text.size();
+  while (last > first && isspace((unsigned char)text[last - 1])) last--;
+  text = text.substr(first, last - first);
+}
+
+void String::toLowerCase() {
+  for (char& c : text) c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char& c : text) c = toupper((unsigned char)c);
+}
+
+void String::replace(const String& from, const String& to) {
+  if (from.text.empty()) return;
+  size_t position = 0;
+  while ((position = text.find(from.text, position)) != std::string::npos) {
+    text.replace(position, from.text.size(), to.text);
+    position += to.text.size();
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index < text.size()) text.erase(index, count);
+}
+
+void String::toCharArray(char* buffer, unsigned int size) const {
+  if (size == 0) return;
+  strncpy(buffer, text.c_str(), size - 1);
+  buffer[size - 1] = '\0';
+}
+
+void String::setFloat(double value, unsigned int decimals) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+  text = buffer;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0;
+  while (size--) written += write(*buffer++);
+  return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char buffer[1024];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) return 0;
+  if ((size_t)length >= sizeof(buffer)) length = sizeof(buffer) - 1;
+  return write((const uint8_t*)buffer, length);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  Sim::serialWrite(c);
+  return 1;
+}
+
+String IPAddress::toString() const {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return String(buffer);
+}
@@ -0,0 +1,104 @@
+#include <LittleFS.h>
+#include <simulator.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+fs::FS LittleFS;
+
+static std::string hostPath(const char* path) {
+  return std::string(Sim::getFsRoot()) + (path[0] == '/' ? "" : "/") + path;
+}
+
+namespace fs {
+
+File::File(FILE* file) : handle(file, fclose) {}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!handle) return 0;
+  return fwrite(buffer, 1, size, handle.get());
+}
+
+int File::available() {
+  if (!handle) return 0;
+  return (int)(size() - position());
+}
+
+int File::read() {
+  if (!handle) return -1;
+  return fgetc(handle.get());
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+  if (!handle) return 0;
+  return fread(buffer, 1, size, handle.get());
+}
+
+int File::peek() {
+  if (!handle) return -1;
+  int c = fgetc(handle.get());
+  if (c != EOF) ungetc(c, handle.get());
+  return c;
+}
+
+bool File::seek(uint32_t offset, SeekMode mode) {
+  if (!handle) return false;
+  int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+  return fseek(handle.get(), offset, whence) == 0;
+}
+
+size_t File::position() const {
+  if (!handle) return 0;
+  return ftell(handle.get());
+}
+
+size_t File::size() const {
+  if (!handle) return 0;
+  fflush(handle.get());
+  struct stat info;
+  if (fstat(fileno(handle.get()), &info) != 0) return 0;
+  return info.st_size;
+}
+
+void File::flush() {
+  if (handle) fflush(handle.get());
+}
+
+bool FS::begin() {
+  mkdir(Sim::getFsRoot(), 0755);
+  struct stat info;
+  return stat(Sim::getFsRoot(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+bool FS::format() {
+  DIR* dir = opendir(Sim::getFsRoot());
+  if (!dir) return false;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') continue;
+    unlink(hostPath(entry->d_name).c_str());
+  }
+  closedir(dir);
+  return true;
+}
+
+  // mode LittleFS ("r", "w", "a", "r+", ...) = mode fopen biner
+File FS::open(const char* path, const char* mode) {
+  std::string hostMode = std::string(mode) + "b";
+  FILE* file = fopen(hostPath(path).c_str(), hostMode.c_str());
+  return file ? File(file) : File();
+}
+
+bool FS::exists(const char* path) {
+  struct stat info;
+  return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) { return unlink(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char* from, const char* to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+}
@@ -0,0 +1,329 @@
+#include <ESP8266WiFi.h>
+#include <WiFiClientSecure.h>
+#include <WiFiUdp.h>
+#include <simulator.h>
+#include <soak.h>
+#include "config.h"
+#include "credential.h"
+
+#define SIM_JOIN_US 2500000ULL           // scan + asosiasi + DHCP
+#define SIM_FAST_JOIN_US 300000ULL       // channel, BSSID & IP statis dari RTC memory
+#define SIM_HANDSHAKE_US 900000ULL       // TLS penuh
+#define SIM_RESUME_US 250000ULL          // TLS session resumption
+#define SIM_HTTP_LATENCY_US 120000ULL
+#define SIM_NTP_LATENCY_US 35000ULL
+#define SIM_FIRST_UPDATE_ID 1000
+#define SIM_NTP_UNIX_OFFSET 2208988800ULL
+
+ESP8266WiFiClass WiFi;
+
+static const uint8_t simBssid[6] = { 0x02, 0x4E, 0x42, 0x53, 0x49, 0x4D };
+
+  // AP mati (gangguan soak) memutus station; setelah AP kembali station
+  // asosiasi ulang sendiri (auto reconnect) selama begin() masih berlaku
+wl_status_t ESP8266WiFiClass::status() {
+  if (wifiMode == WIFI_OFF || !joining) return WL_DISCONNECTED;
+  uint64_t now = Sim::now(), restoredUs;
+  if (!Soak::isNetworkUp(now, restoredUs)) return WL_CONNECTION_LOST;
+  uint64_t readyUs = joinedAtUs;
+  if (restoredUs > joinStartUs && restoredUs + SIM_JOIN_US > readyUs) readyUs = restoredUs + SIM_JOIN_US;
+  return now >= readyUs ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+void ESP8266WiFiClass::mode(WiFiMode_t value) {
+  wifiMode = value;
+  if (value == WIFI_OFF) joining = false;
+}
+
+void ESP8266WiFiClass::begin(const char* ssid, const char* password, int32_t channel,
+                             const uint8_t* bssid, bool connect) {
+  (void)ssid;
+  (void)password;
+  if (wifiMode == WIFI_OFF) wifiMode = WIFI_STA;
+  if (!connect) return;
+  bool fast = channel != 0 && bssid != NULL && staticIp;
+  joining = true;
+  joinStartUs = Sim::now();
+  joinedAtUs = joinStartUs + (fast ? SIM_FAST_JOIN_US : SIM_JOIN_US);
+  Sim::event("wifi", fast ? "fast join" : "join");
+}
+
+bool ESP8266WiFiClass::config(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+  (void)gateway;
+  (void)subnet;
+  (void)dns;
+  staticIp = ip.isSet();
+  return true;
+}
+
+void ESP8266WiFiClass::disconnect(bool wifiOff) {
+  joining = false;
+  if (wifiOff) wifiMode = WIFI_OFF;
+}
+
+IPAddress ESP8266WiFiClass::localIP() { return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+IPAddress ESP8266WiFiClass::gatewayIP() { return IPAddress(192, 168, 1, 1); }
+IPAddress ESP8266WiFiClass::subnetMask() { return IPAddress(255, 255, 255, 0); }
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t index) { (void)index; return IPAddress(192, 168, 1, 1); }
+String ESP8266WiFiClass::SSID() { return String(WIFI_SSID); }
+int32_t ESP8266WiFiClass::RSSI() { return status() == WL_CONNECTED ? -58 : 31; }
+uint8_t* ESP8266WiFiClass::BSSID() { return (uint8_t*)simBssid; }
+int32_t ESP8266WiFiClass::channel() { return 6; }
+
+// Satu koneksi ke api.telegram.org palsu. Request dikumpulkan sampai header
+// + body lengkap, respons disiapkan langsung tapi baru terbaca setelah
+// readyAtUs (latensi jaringan / long poll yang ditahan server).
+struct SimConnection {
+  std::string request;
+  std::string response;
+  size_t responseRead = 0;
+  uint64_t readyAtUs = 0;
+};
+
+static long queryValue(const std::string& path, const char* key, long fallback) {
+  std::string pattern = std::string(key) + "=";
+  size_t found = path.find(pattern);
+  if (found == std::string::npos) return fallback;
+  return atol(path.c_str() + found + pattern.size());
+}
+
+static void appendJsonString(std::string& out, const char* text) {
+  out += '"';
+  for (const char* p = text; *p; p++) {
+    if (*p == '"' || *p == '\\') out += '\\';
+    if (*p == '\n') { out += "\\n"; continue; }
+    out += *p;
+  }
+  out += '"';
+}
+
+  // nilai "text" pertama di body JSON sendMessage
+static std::string extractText(const std::string& body) {
+  std::string text;
+  size_t found = body.find("\"text\":\"");
+  if (found == std::string::npos) return text;
+  for (size_t i = found + 8; i < body.size() && body[i] != '"'; i++) {
+    if (body[i] == '\\' && i + 1 < body.size()) {
+      i++;
+      text += body[i] == 'n' ? '\n' : body[i];
+    } else {
+      text += body[i];
+    }
+  }
+  return text;
+}
+
+  // getUpdates: update = perintah --command yang waktunya sudah lewat dan
+  // belum dikonfirmasi lewat offset. Tanpa update, server menahan respons
+  // sampai perintah berikutnya atau timeout long poll habis.
+static uint64_t answerUpdates(const std::string& path, std::string& body) {
+  long offset = queryValue(path, "offset", 0);
+  long limit = queryValue(path, "limit", 100);
+  long timeout = queryValue(path, "timeout", 0);
+  if (offset > Sim::shared->telegramOffset) Sim::shared->telegramOffset = offset;
+
+  uint64_t now = Sim::now();
+  uint64_t readyAt = now;
+  uint32_t first = offset > SIM_FIRST_UPDATE_ID ? offset - SIM_FIRST_UPDATE_ID : 0;
+  uint64_t atUs;
+  const char* text = Sim::getTelegramCommand(first, atUs);
+  if (text && atUs > now) {
+    uint64_t held = now + timeout * 1000000ULL;
+    readyAt = atUs < held ? atUs : held;
+  }
+
+  body = "{\"ok\":true,\"result\":[";
+  long count = 0;
+  for (uint32_t index = first; count < limit; index++) {
+    text = Sim::getTelegramCommand(index, atUs);
+    if (!text || atUs > readyAt) break;
+    char head[160];
+    snprintf(head, sizeof(head),
+             "%s{\"update_id\":%lu,\"message\":{\"message_id\":%lu,\"chat\":{\"id\":%s,\"type\":\"private\"},"
+             "\"date\":%llu,\"text\":",
+             count ? "," : "", (unsigned long)(SIM_FIRST_UPDATE_ID + index), (unsigned long)index + 1,
+             CHAT_ID, (unsigned long long)(Sim::getUtcMicros() / 1000000ULL));
+    body += head;
+    appendJsonString(body, text);
+    body += "}}";
+    count++;
+  }
+  body += "]}";
+  if (count == 0 && !text) readyAt = now + timeout * 1000000ULL;  // tidak ada perintah lagi
+  return readyAt;
+}
+
+static void answerRequest(SimConnection* connection, const std::string& head, const std::string& body) {
+  size_t pathStart = head.find(' ') + 1;
+  std::string path = head.substr(pathStart, head.find(' ', pathStart) - pathStart);
+  uint64_t readyAt = Sim::now();
+  int status = 200;
+  std::string reply;
+
+  if (path.find("/getUpdates") != std::string::npos) {
+    readyAt = answerUpdates(path, reply);
+  } else if (path.find("/sendMessage") != std::string::npos) {
+    Sim::shared->messageCount++;
+    Sim::event("telegram", "%s", extractText(body).c_str());
+    reply = "{\"ok\":true,\"result\":{\"message_id\":1}}";
+  } else if (path.find("/sendDocument") != std::string::npos) {
+    Sim::event("document", "%u bytes", (unsigned)body.size());
+    reply = "{\"ok\":true,\"result\":{\"message_id\":1}}";
+  } else {
+    status = 404;
+    reply = "{\"ok\":false,\"error_code\":404}";
+  }
+
+  char header[160];
+  snprintf(header, sizeof(header),
+           "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+           "Connection: keep-alive\r\n\r\n",
+           status, status == 200 ? "OK" : "Not Found", (unsigned)reply.size());
+  connection->response.erase(0, connection->responseRead);
+  connection->responseRead = 0;
+  connection->response += header + reply;
+  connection->readyAtUs = readyAt + SIM_HTTP_LATENCY_US;
+}
+
+static void processRequests(SimConnection* connection) {
+  for (;;) {
+    size_t headerEnd = connection->request.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return;
+    std::string head = connection->request.substr(0, headerEnd);
+    long contentLength = 0;
+    size_t found = head.find("Content-Length:");
+    if (found != std::string::npos) contentLength = atol(head.c_str() + found + 15);
+    size_t total = headerEnd + 4 + contentLength;
+    if (connection->request.size() < total) return;
+
+    answerRequest(connection, head, connection->request.substr(headerEnd + 4, contentLength));
+    connection->request.erase(0, total);
+  }
+}
+
+WiFiClient::WiFiClient() : connection(NULL) {}
+WiFiClient::~WiFiClient() { stop(); }
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+  if (WiFi.status() != WL_CONNECTED) return 0;
+  if (strcmp(host, TELEGRAM_HOST) != 0 || port != TELEGRAM_PORT) return 0;
+  connection = new SimConnection();
+  return 1;
+}
+
+  // koneksi putus bersama WiFi; sisa respons yang sudah diterima tetap terbaca
+uint8_t WiFiClient::connected() {
+  if (!connection) return 0;
+  if (WiFi.status() != WL_CONNECTED) {
+    if (available() > 0) return 1;
+    stop();
+    return 0;
+  }
+  return 1;
+}
+
+void WiFiClient::stop() {
+  delete connection;
+  connection = NULL;
+}
+
+size_t WiFiClient::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+  if (!connected()) return 0;
+  connection->request.append((const char*)buffer, size);
+  processRequests(connection);
+  return size;
+}
+
+int WiFiClient::available() {
+  if (!connection || Sim::now() < connection->readyAtUs) return 0;
+  return connection->response.size() - connection->responseRead;
+}
+
+int WiFiClient::read() {
+  if (available() <= 0) return -1;
+  return (uint8_t)connection->response[connection->responseRead++];
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+  int count = 0;
+  while ((size_t)count < size && available() > 0) buffer[count++] = read();
+  return count;
+}
+
+int WiFiClient::peek() {
+  if (available() <= 0) return -1;
+  return (uint8_t)connection->response[connection->responseRead];
+}
+
+namespace BearSSL {
+
+bool WiFiClientSecure::probeMaxFragmentLength(const char* host, uint16_t port, uint16_t length) {
+  (void)host;
+  (void)port;
+  (void)length;
+  if (WiFi.status() != WL_CONNECTED) return false;
+  Sim::sleep(SIM_HTTP_LATENCY_US * 2);
+  return true;
+}
+
+  // handshake memblokir seperti BearSSL; session yang sudah ada lebih singkat
+int WiFiClientSecure::connect(const char* host, uint16_t port) {
+  if (!WiFiClient::connect(host, port)) return 0;
+  bool resumed = session && session->valid;
+  Sim::sleep(resumed ? SIM_RESUME_US : SIM_HANDSHAKE_US);
+  if (session) session->valid = true;
+  return connected();
+}
+
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+  (void)host;
+  (void)port;
+  sending = WiFi.status() == WL_CONNECTED;  // DNS gagal tanpa WiFi
+  return sending;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+  (void)buffer;  // request NTP selalu sama, isinya tidak dibaca server
+  return sending ? size : 0;
+}
+
+  // server NTP palsu: waktu UTC virtual (+ lompatan soak), dicap di tengah
+  // perjalanan paket
+int WiFiUDP::endPacket() {
+  if (!sending) return 0;
+  sending = false;
+  replyPending = true;
+  replyAtUs = Sim::now() + SIM_NTP_LATENCY_US;
+  Sim::shared->ntpCount++;
+  return 1;
+}
+
+int WiFiUDP::parsePacket() {
+  if (!replyPending || Sim::now() < replyAtUs) return packetLength;
+  replyPending = false;
+
+  uint64_t utc = Sim::getUtcMicros() + Sim::shared->ntpOffsetUs + Soak::getNtpOffsetUs(Sim::now()) -
+                 SIM_NTP_LATENCY_US / 2;
+  uint32_t seconds = utc / 1000000ULL + SIM_NTP_UNIX_OFFSET;
+  uint32_t fraction = ((utc % 1000000ULL) << 32) / 1000000ULL;
+  memset(packet, 0, sizeof(packet));
+  packet[0] = 0x24;  // LI 0, versi 4, mode server
+  for (int i = 0; i < 4; i++) {
+    packet[40 + i] = seconds >> (24 - i * 8);
+    packet[44 + i] = fraction >> (24 - i * 8);
+  }
+  packetLength = sizeof(packet);
+  return packetLength;
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t size) {
+  size_t count = size < packetLength ? size : packetLength;
+  memcpy(buffer, packet, count);
+  packetLength = 0;
+  return count;
+}
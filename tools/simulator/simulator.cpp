@@ -0,0 +1,253 @@
+#include <simulator.h>
+#include <soak.h>
+#include <malloc.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+struct SimTimer {
+  bool active;
+  uint64_t atUs;
+  void (*callback)(int);
+  int arg;
+};
+
+struct SimCommand {
+  uint64_t atUs;
+  std::string text;
+};
+
+static std::vector<SimSensorSample> trace;
+static std::vector<SimCommand> commands;
+static SimTimer timers[SIM_TIMER_SLOTS];
+
+SimShared* Sim::shared = NULL;
+SimOptions Sim::options = { "simfs", NULL, NULL, false, 0 };
+bool Sim::inTimer = false;
+uint64_t Sim::lastYieldUs = 0;
+bool Sim::lineStart = true;
+FILE* Sim::eventsFile = NULL;
+FILE* Sim::framesFile = NULL;
+size_t Sim::heapBaseline = 0;
+
+  // format: detik,jarak_makanan_cm,jarak_air_cm,volt_baterai (baris '#' = komentar)
+bool Sim::loadTrace(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (!file) return false;
+
+  char line[160];
+  while (fgets(line, sizeof(line), file)) {
+    SimSensorSample sample;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%u,%f,%f,%f", &sample.second, &sample.foodCm,
+               &sample.waterCm, &sample.batteryVolt) != 4) continue;  // header
+    if (!trace.empty() && sample.second < trace.back().second) {
+      fprintf(stderr, "trace not sorted at second %u\n", sample.second);
+      fclose(file);
+      return false;
+    }
+    trace.push_back(sample);
+  }
+  fclose(file);
+  return !trace.empty();
+}
+
+void Sim::addTraceSample(const SimSensorSample& sample) { trace.push_back(sample); }
+bool Sim::hasTrace() { return !trace.empty(); }
+
+void Sim::addTelegramCommand(uint64_t atUs, const char* text) {
+  SimCommand command = { atUs, text };
+  size_t index = commands.size();
+  while (index > 0 && commands[index - 1].atUs > atUs) index--;
+  commands.insert(commands.begin() + index, command);
+}
+
+  // index = update_id - SIM_FIRST_UPDATE_ID; NULL jika tidak ada
+const char* Sim::getTelegramCommand(uint32_t index, uint64_t& atUs) {
+  if (index >= commands.size()) return NULL;
+  atUs = commands[index].atUs;
+  return commands[index].text.c_str();
+}
+
+  // Buffer stdio simulator statis supaya tidak terhitung heap firmware
+static FILE* openOutput(const char* path, char* buffer, size_t size) {
+  if (!path) return NULL;
+  FILE* file = fopen(path, "a");
+  if (file) setvbuf(file, buffer, _IOFBF, size);
+  return file;
+}
+
+  // dipanggil di proses anak sebelum setup()
+void Sim::beginBoot() {
+  static char stdoutBuffer[BUFSIZ];
+  static char eventsBuffer[BUFSIZ];
+  static char framesBuffer[BUFSIZ];
+  setvbuf(stdout, stdoutBuffer, _IOFBF, sizeof(stdoutBuffer));
+  eventsFile = openOutput(options.eventsPath, eventsBuffer, sizeof(eventsBuffer));
+  framesFile = openOutput(options.framesPath, framesBuffer, sizeof(framesBuffer));
+
+  memset(timers, 0, sizeof(timers));
+  inTimer = false;
+  lineStart = true;
+  lastYieldUs = shared->nowUs;
+  shared->bootUs = shared->nowUs;
+  shared->bootCount++;
+  heapBaseline = mallinfo2().uordblks;
+}
+
+uint64_t Sim::now() { return shared->nowUs; }
+uint64_t Sim::getBootMicros() { return shared->nowUs - shared->bootUs; }
+uint64_t Sim::getUtcMicros() { return shared->startEpoch * 1000000ULL + shared->nowUs; }
+
+  // Maju us waktu CPU; timer yang jatuh tempo di tengah jalan dijalankan
+  // pada waktunya (seperti ISR). Loop tanpa yield terlalu lama = WDT reset.
+void Sim::advance(uint64_t us) {
+  uint64_t target = shared->nowUs + us;
+  while (!inTimer) {
+    int next = -1;
+    for (int i = 0; i < SIM_TIMER_SLOTS; i++) {
+      if (!timers[i].active || timers[i].atUs > target) continue;
+      if (next < 0 || timers[i].atUs < timers[next].atUs) next = i;
+    }
+    if (next < 0) break;
+    timers[next].active = false;
+    if (timers[next].atUs > shared->nowUs) shared->nowUs = timers[next].atUs;
+    inTimer = true;
+    timers[next].callback(timers[next].arg);
+    inTimer = false;
+  }
+  if (target > shared->nowUs) shared->nowUs = target;
+
+  if (shared->nowUs >= shared->endUs) finish();
+  if (!inTimer && shared->nowUs - lastYieldUs > SIM_WDT_TIMEOUT_US) {
+    event("wdt", "no yield for %llu ms", (unsigned long long)(shared->nowUs - lastYieldUs) / 1000);
+    reset(SIM_RESET_WDT, 0);
+  }
+}
+
+  // delay()/yield(): waktu berjalan tanpa CPU, WDT direset
+void Sim::sleep(uint64_t us) {
+  lastYieldUs = shared->nowUs + us;
+  advance(us);
+  Soak::probe();
+}
+
+void Sim::schedule(uint64_t atUs, void (*callback)(int), int arg) {
+  for (int i = 0; i < SIM_TIMER_SLOTS; i++) {
+    if (timers[i].active) continue;
+    timers[i].active = true;
+    timers[i].atUs = atUs;
+    timers[i].callback = callback;
+    timers[i].arg = arg;
+    return;
+  }
+  fprintf(stderr, "sim: timer slots full\n");
+  abort();
+}
+
+void Sim::reset(SimResetReason reason, uint64_t sleepUs) {
+  shared->exitReason = reason;
+  shared->sleepUs = sleepUs;
+  shared->awakeUs += shared->nowUs - shared->bootUs;
+  fflush(NULL);
+  _exit(0);
+}
+
+void Sim::finish() {
+  shared->finished = 1;
+  shared->awakeUs += shared->nowUs - shared->bootUs;
+  fflush(NULL);
+  _exit(0);
+}
+
+  // interpolasi linear; sebelum/sesudah trace = nilai baris pertama/terakhir
+SimSensorSample Sim::getTrace() {
+  SimSensorSample sample = { 0, 4.0f, 3.0f, 7.8f };  // tanpa trace: wadah penuh, baterai sehat
+  if (trace.empty()) return sample;
+
+  double second = shared->nowUs / 1e6;
+  if (second <= trace.front().second) return trace.front();
+  if (second >= trace.back().second) return trace.back();
+
+  size_t high = 1;
+  while (trace[high].second < second) high++;
+  const SimSensorSample& a = trace[high - 1];
+  const SimSensorSample& b = trace[high];
+  float t = (second - a.second) / (b.second - a.second);
+  sample.second = (uint32_t)second;
+  // jarak <= 0 (tidak ada echo) tidak diinterpolasi
+  sample.foodCm = (a.foodCm <= 0 || b.foodCm <= 0) ? a.foodCm : a.foodCm + t * (b.foodCm - a.foodCm);
+  sample.waterCm = (a.waterCm <= 0 || b.waterCm <= 0) ? a.waterCm : a.waterCm + t * (b.waterCm - a.waterCm);
+  sample.batteryVolt = a.batteryVolt + t * (b.batteryVolt - a.batteryVolt);
+  return sample;
+}
+
+SimSensorSample Sim::getSensors() {
+  SimSensorSample sample = getTrace();
+  Soak::perturb(shared->nowUs, sample.foodCm, sample.waterCm, sample.batteryVolt);
+  return sample;
+}
+
+void Sim::recordFeed() {
+  shared->feedCount++;
+  event("feed", "%u", shared->feedCount);
+  Soak::recordFeed(shared->nowUs);
+}
+
+  // heap yang dipakai firmware sejak boot dikurangkan dari heap bebas ESP8266
+uint32_t Sim::getFreeHeap() {
+  size_t used = mallinfo2().uordblks;
+  long grown = used > heapBaseline ? (long)(used - heapBaseline) : 0;
+  return grown >= SIM_HEAP_FREE ? 0 : SIM_HEAP_FREE - grown;
+}
+
+void Sim::formatTime(uint64_t us, char* buffer, size_t size) {
+  uint64_t ms = us / 1000;
+  snprintf(buffer, size, "d%03u %02u:%02u:%02u.%03u",
+           (unsigned)(ms / 86400000ULL), (unsigned)(ms / 3600000 % 24),
+           (unsigned)(ms / 60000 % 60), (unsigned)(ms / 1000 % 60), (unsigned)(ms % 1000));
+}
+
+  // Serial ke stdout, tiap baris diawali waktu virtual
+void Sim::serialWrite(uint8_t c) {
+  if (options.quiet || c == '\r') return;
+  if (lineStart) {
+    char stamp[24];
+    formatTime(shared->nowUs, stamp, sizeof(stamp));
+    printf("[%s] ", stamp);
+    lineStart = false;
+  }
+  putchar(c);
+  if (c == '\n') lineStart = true;
+}
+
+  // satu baris CSV: detik,tipe,"detail"
+void Sim::event(const char* type, const char* format, ...) {
+  if (!eventsFile) return;
+
+  char detail[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(detail, sizeof(detail), format, args);
+  va_end(args);
+
+  fprintf(eventsFile, "%.3f,%s,\"", shared->nowUs / 1e6, type);
+  for (const char* p = detail; *p; p++) {
+    if (*p == '"') fputs("\"\"", eventsFile);
+    else if (*p == '\n') fputs(" | ", eventsFile);
+    else fputc(*p, eventsFile);
+  }
+  fputs("\"\n", eventsFile);
+}
+
+void Sim::dumpFrame(const char* frame) {
+  if (!framesFile) return;
+
+  char stamp[24];
+  formatTime(shared->nowUs, stamp, sizeof(stamp));
+  fprintf(framesFile, "== %s ==\n%s", stamp, frame);
+}
+
+const char* Sim::getFsRoot() { return options.fsRoot; }
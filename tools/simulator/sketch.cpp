@@ -0,0 +1,15 @@
+// mainNibblo.ino dikompilasi sebagai C++ biasa; prototipe yang biasanya
+// dibuat arduino-builder ditulis di sini
+#include <Arduino.h>
+
+bool initializeSystem();
+bool connectWiFi();
+void logBootPhase(const char* phase);
+void registerTasks();
+void feedTask();
+void sensorTask();
+void telegramTask();
+void sendSensorDebugInfo();
+void checkSystemHealth();
+
+#include "mainNibblo.ino"
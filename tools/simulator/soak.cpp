@@ -0,0 +1,562 @@
+#include <soak.h>
+#include <simulator.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <vector>
+#include "alertManager.h"
+#include "timeManager.h"
+#include "hal.h"
+
+#define SOAK_DAY_US 86400000000ULL
+
+static_assert(SOAK_OUTAGE_MIN_S > FEED_CATCHUP_WINDOW && SOAK_OUTAGE_MIN_S > 4 * SLEEP_DURATION_SECONDS,
+              "long outages must outlast the catch-up window and several sleep cycles");
+
+struct SoakWindow {
+  uint64_t startUs;
+  uint64_t endUs;
+  int64_t value;              // offset NTP (us); tidak dipakai untuk WiFi & baterai
+};
+
+struct SoakDay {
+  uint32_t boots;
+  uint32_t sleeps;
+  uint32_t restarts;
+  uint32_t wdtResets;
+  uint32_t messages;
+  uint32_t ntpRequests;
+  uint64_t awakeUs;
+  uint64_t outageAwakeUs;     // waktu bangun selama gangguan WiFi panjang
+  uint32_t minFreeHeap;       // 0 = belum ada sampel
+  uint32_t maxClockErrorMs;
+  uint32_t stuckAlerts;
+  uint32_t silentAlerts;
+  uint32_t spuriousAlerts;
+};
+
+// Satu jenis alert: flag firmware dibandingkan level sebenarnya (tanpa noise)
+struct SoakAlertTrack {
+  uint64_t stuckUs;           // waktu bangun selama flag masih set padahal level sudah pulih
+  uint64_t silentUs;          // waktu bangun selama level buruk tanpa flag
+  bool stuckReported;
+  bool silentReported;
+  bool flagged;               // flag pada probe sebelumnya
+};
+
+// Bertahan antar boot (memori bersama, seperti SimShared)
+struct SoakShared {
+  SoakDay days[SOAK_MAX_DAYS];
+  uint64_t feedUs[SOAK_MAX_FEEDS];
+  uint32_t feedCount;
+  SoakAlertTrack alerts[3];
+  uint32_t outageRestarts[SOAK_MAX_OUTAGES];
+
+  // nilai counter SimShared yang sudah dibagi ke hari
+  uint32_t boots;
+  uint32_t sleeps;
+  uint32_t restarts;
+  uint32_t wdtResets;
+  uint32_t messages;
+  uint32_t ntpRequests;
+  uint64_t awakeUs;
+};
+
+enum SoakAlert { SOAK_ALERT_FOOD, SOAK_ALERT_WATER, SOAK_ALERT_BATTERY };
+
+static const char* alertNames[] = { "food", "water", "battery" };
+
+SoakOptions Soak::options = { false, 1, -1, -1, -1, -1, -1, NULL, { 0 }, 0 };
+
+static SoakShared* soakShared = NULL;
+static std::vector<SoakWindow> wifiDrops;
+static std::vector<SoakWindow> outages;      // juga ada di wifiDrops, dinilai terpisah
+static std::vector<SoakWindow> ntpJumps;
+static std::vector<SoakWindow> lowBattery;
+static uint64_t lastProbeUs = 0;    // proses anak = satu boot, mulai dari 0 lagi
+
+  // splitmix64: deterministik per seed, juga dipakai sebagai hash noise
+static uint64_t mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t randomState = 0;
+
+static double uniform(double low, double high) {
+  randomState = mix(randomState);
+  return low + (high - low) * ((randomState >> 11) * (1.0 / 9007199254740992.0));
+}
+
+static double hashUnit(uint64_t key) {
+  return (mix(key ^ Soak::options.seed * 0xD1B54A32D192ED03ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+  // jumlah kejadian per hari ~ Poisson(rate)
+static int poisson(double rate) {
+  double limit = exp(-rate), product = uniform(0, 1);
+  int count = 0;
+  while (product > limit) {
+    product *= uniform(0, 1);
+    count++;
+  }
+  return count;
+}
+
+static const SoakWindow* findWindow(const std::vector<SoakWindow>& windows, uint64_t us) {
+  for (const SoakWindow& window : windows) {
+    if (window.startUs > us) break;
+    if (us < window.endUs) return &window;
+  }
+  return NULL;
+}
+
+static bool overlaps(const std::vector<SoakWindow>& windows, uint64_t startUs, uint64_t endUs) {
+  for (const SoakWindow& window : windows) {
+    if (window.startUs < endUs && window.endUs > startUs) return true;
+  }
+  return false;
+}
+
+static SoakDay& dayAt(uint64_t us) {
+  uint64_t day = us / SOAK_DAY_US;
+  return soakShared->days[day < SOAK_MAX_DAYS ? day : SOAK_MAX_DAYS - 1];
+}
+
+  // "HH:MM" waktu lokal, seperti perintah jadwal di Telegram
+bool Soak::parseFeedTime(const char* text) {
+  int hour, minute;
+  if (options.expectedCount >= SOAK_MAX_EXPECTED) return false;
+  if (sscanf(text, "%d:%d", &hour, &minute) != 2 || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+    return false;
+  }
+  options.expectedMinutes[options.expectedCount++] = hour * 60 + minute;
+  return true;
+}
+
+  // Trace sintetis jika --trace tidak diberikan: makanan habis ke ~18% dalam
+  // 36 jam lalu diisi ulang, air ke ~16% dalam 48 jam, baterai turun pelan
+  // 8.2 -> 7.2 V selama 9 hari lalu diisi sehari. Level melewati ambang
+  // warning dan kembali normal, jadi alert harus muncul dan harus hilang.
+static void addSyntheticTrace(uint64_t endUs) {
+  uint32_t endSecond = endUs / 1000000ULL + 3600;
+  for (uint32_t second = 0; second <= endSecond; second += 1800) {
+    double food = fmod(second / 3600.0, 36) / 36;
+    double water = fmod(second / 3600.0 + 12, 48) / 48;
+    double battery = fmod(second / 86400.0, 10);
+    SimSensorSample sample;
+    sample.second = second;
+    sample.foodCm = 3.0 + 8.5 * food;
+    sample.waterCm = 2.2 + 3.4 * water;
+    sample.batteryVolt = battery < 9 ? 8.2 - battery / 9 : 7.2 + (battery - 9);
+    Sim::addTraceSample(sample);
+  }
+}
+
+void Soak::plan(uint64_t endUs, bool hasTrace) {
+  soakShared = (SoakShared*)mmap(NULL, sizeof(SoakShared), PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (soakShared == MAP_FAILED) {
+    perror("mmap");
+    exit(1);
+  }
+  memset(soakShared, 0, sizeof(SoakShared));
+  if (options.wifiDropsPerDay < 0) options.wifiDropsPerDay = 2;
+  if (options.outagesPerDay < 0) options.outagesPerDay = 0.2;
+  if (options.ntpJumpsPerDay < 0) options.ntpJumpsPerDay = 0.25;
+  if (options.noiseCm < 0) options.noiseCm = 0.3;
+  if (options.lowBatteryEvery < 0) options.lowBatteryEvery = 15;
+  if (options.expectedCount == 0) parseFeedTime("08:00");  // jadwal default firmware
+  if (!hasTrace) addSyntheticTrace(endUs);
+
+  randomState = options.seed;
+  uint32_t days = (endUs + SOAK_DAY_US - 1) / SOAK_DAY_US;
+  for (uint32_t day = 0; day < days; day++) {
+    uint64_t dayUs = day * SOAK_DAY_US;
+
+    int drops = poisson(options.wifiDropsPerDay);
+    for (int i = 0; i < drops; i++) {
+      // 80% gangguan singkat, sisanya AP mati sampai SOAK_WIFI_DROP_MAX_S
+      double seconds = uniform(0, 1) < 0.8 ? uniform(SOAK_WIFI_DROP_MIN_S, 300)
+                                           : uniform(300, SOAK_WIFI_DROP_MAX_S);
+      uint64_t start = dayUs + (uint64_t)uniform(0, SOAK_DAY_US);
+      wifiDrops.push_back({ start, start + (uint64_t)(seconds * 1e6), 0 });
+    }
+
+    // AP mati berjam-jam: perangkat harus tetap tidur, makan & mencatat offline
+    int longDrops = poisson(options.outagesPerDay);
+    for (int i = 0; i < longDrops; i++) {
+      uint64_t start = dayUs + (uint64_t)uniform(0, SOAK_DAY_US);
+      SoakWindow outage = { start, start + (uint64_t)(uniform(SOAK_OUTAGE_MIN_S, SOAK_OUTAGE_MAX_S) * 1e6), 0 };
+      outages.push_back(outage);
+      wifiDrops.push_back(outage);
+    }
+
+    int jumps = poisson(options.ntpJumpsPerDay);
+    for (int i = 0; i < jumps; i++) {
+      // server NTP salah selama 1-6 jam lalu benar lagi
+      double offset = uniform(SOAK_NTP_JUMP_MIN_S, SOAK_NTP_JUMP_MAX_S) * (uniform(0, 1) < 0.5 ? -1 : 1);
+      uint64_t start = dayUs + (uint64_t)uniform(0, SOAK_DAY_US);
+      ntpJumps.push_back({ start, start + (uint64_t)(uniform(1, 6) * 3600e6), (int64_t)(offset * 1e6) });
+    }
+
+    if (options.lowBatteryEvery > 0 && day > 0 && fmod(day, options.lowBatteryEvery) < 1) {
+      uint64_t start = dayUs + (uint64_t)uniform(0, SOAK_DAY_US);
+      lowBattery.push_back({ start, start + (uint64_t)(uniform(6, 20) * 3600e6), 0 });
+    }
+  }
+
+  // jendela yang tumpang tindih digabung, urut waktu mulai
+  for (std::vector<SoakWindow>* windows : { &wifiDrops, &outages, &ntpJumps, &lowBattery }) {
+    std::vector<SoakWindow> merged;
+    std::sort(windows->begin(), windows->end(),
+              [](const SoakWindow& a, const SoakWindow& b) { return a.startUs < b.startUs; });
+    for (const SoakWindow& window : *windows) {
+      if (!merged.empty() && window.startUs <= merged.back().endUs) {
+        if (window.endUs > merged.back().endUs) merged.back().endUs = window.endUs;
+      } else {
+        merged.push_back(window);
+      }
+    }
+    *windows = merged;
+  }
+  if (outages.size() > SOAK_MAX_OUTAGES) outages.resize(SOAK_MAX_OUTAGES);
+}
+
+  // Selisih counter SimShared sejak collect() terakhir dibagi ke hari sekarang
+static void accumulate(uint64_t awakeUs) {
+  SimShared& shared = *Sim::shared;
+  SoakDay& day = dayAt(shared.nowUs);
+  day.boots += shared.bootCount - soakShared->boots;
+  day.sleeps += shared.sleepCount - soakShared->sleeps;
+  day.restarts += shared.restartCount - soakShared->restarts;
+  day.wdtResets += shared.wdtCount - soakShared->wdtResets;
+  day.messages += shared.messageCount - soakShared->messages;
+  day.ntpRequests += shared.ntpCount - soakShared->ntpRequests;
+  day.awakeUs += awakeUs - soakShared->awakeUs;
+  const SoakWindow* outage = findWindow(outages, shared.nowUs);
+  if (outage) {
+    day.outageAwakeUs += awakeUs - soakShared->awakeUs;
+    soakShared->outageRestarts[outage - outages.data()] += shared.restartCount - soakShared->restarts;
+  }
+  soakShared->boots = shared.bootCount;
+  soakShared->sleeps = shared.sleepCount;
+  soakShared->restarts = shared.restartCount;
+  soakShared->wdtResets = shared.wdtCount;
+  soakShared->messages = shared.messageCount;
+  soakShared->ntpRequests = shared.ntpCount;
+  soakShared->awakeUs = awakeUs;
+}
+
+void Soak::collect() {
+  if (!options.enabled) return;
+  accumulate(Sim::shared->awakeUs);
+}
+
+  // WiFi mati selama jendela gangguan; restoredUs = akhir gangguan terakhir
+  // (station perlu asosiasi ulang setelahnya)
+bool Soak::isNetworkUp(uint64_t us, uint64_t& restoredUs) {
+  restoredUs = 0;
+  for (const SoakWindow& window : wifiDrops) {
+    if (window.startUs > us) break;
+    if (us < window.endUs) return false;
+    restoredUs = window.endUs;
+  }
+  return true;
+}
+
+int64_t Soak::getNtpOffsetUs(uint64_t us) {
+  const SoakWindow* jump = findWindow(ntpJumps, us);
+  return jump ? jump->value : 0;
+}
+
+  // episode baterai: turun ke SOAK_LOW_BATTERY_VOLT dalam 2 jam, naik lagi di 2 jam terakhir
+static float applyLowBattery(uint64_t us, float volt) {
+  const SoakWindow* dip = findWindow(lowBattery, us);
+  if (!dip) return volt;
+  double edge = fmin(fmin(us - dip->startUs, dip->endUs - us) / 7200e6, 1);
+  float low = SOAK_LOW_BATTERY_VOLT * edge + volt * (1 - edge);
+  return low < volt ? low : volt;
+}
+
+  // Noise deterministik dari waktu: ping yang sama selalu memberi hasil sama
+void Soak::perturb(uint64_t us, float& foodCm, float& waterCm, float& batteryVolt) {
+  if (!options.enabled) return;
+  batteryVolt = applyLowBattery(us, batteryVolt);
+
+  float* channels[2] = { &foodCm, &waterCm };
+  for (int i = 0; i < 2; i++) {
+    uint64_t key = us * 4 + i;
+    double roll = hashUnit(key);
+    if (*channels[i] <= 0) continue;
+    if (roll < 0.01) {
+      *channels[i] = 0;                                   // echo hilang
+    } else if (roll < 0.015) {
+      *channels[i] += (hashUnit(key + 1) - 0.3) * 20;     // pantulan liar
+    } else {
+      double u1 = fmax(hashUnit(key + 2), 1e-12), u2 = hashUnit(key + 3);
+      *channels[i] += options.noiseCm * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+    }
+    if (*channels[i] < 0) *channels[i] = 0;
+  }
+  batteryVolt += options.noiseCm * 0.05 * (hashUnit(us * 4 + 3) - 0.5);
+}
+
+void Soak::recordFeed(uint64_t us) {
+  if (!options.enabled || soakShared->feedCount >= SOAK_MAX_FEEDS) return;
+  soakShared->feedUs[soakShared->feedCount++] = us;
+}
+
+  // flag alert vs kondisi sebenarnya; pelanggaran dihitung sekali per episode.
+  // Alert palsu hanya dilaporkan, bukan pelanggaran.
+static void trackAlert(SoakAlert kind, bool flagged, bool recovered, bool bad, uint64_t elapsedUs) {
+  SoakAlertTrack& track = soakShared->alerts[kind];
+  SoakDay& day = dayAt(Sim::now());
+
+  // flag baru muncul padahal level sebenarnya normal: alert palsu (noise)
+  if (flagged && !track.flagged && recovered) day.spuriousAlerts++;
+  track.flagged = flagged;
+
+  if (flagged && recovered) {
+    track.stuckUs += elapsedUs;
+    if (track.stuckUs > SOAK_ALERT_GRACE_US && !track.stuckReported) {
+      track.stuckReported = true;
+      day.stuckAlerts++;
+      Sim::event("soak", "%s alert stuck after recovery", alertNames[kind]);
+    }
+  } else {
+    track.stuckUs = 0;
+    track.stuckReported = false;
+  }
+
+  if (!flagged && bad) {
+    track.silentUs += elapsedUs;
+    if (track.silentUs > SOAK_ALERT_GRACE_US && !track.silentReported) {
+      track.silentReported = true;
+      day.silentAlerts++;
+      Sim::event("soak", "%s level low without alert", alertNames[kind]);
+    }
+  } else {
+    track.silentUs = 0;
+    track.silentReported = false;
+  }
+}
+
+static int toPercent(float distance, float maxDistance) {
+  float percent = (maxDistance - distance) / (maxDistance - MIN_DISTANCE) * 100;
+  return percent < 0 ? 0 : percent > 100 ? 100 : (int)(percent + 0.5f);
+}
+
+  // Dipanggil dari Sim::sleep(): firmware sedang di delay()/yield(), aman
+  // membaca state modul. Margin ambang menampung filter EMA di Hardware.
+void Soak::probe() {
+  static bool probing = false;
+  if (!options.enabled || probing) return;
+  uint64_t now = Sim::now();
+  if (lastProbeUs == 0) {
+    lastProbeUs = now ? now : 1;
+    return;
+  }
+  if (now - lastProbeUs < SOAK_PROBE_INTERVAL_US) return;
+  probing = true;
+  uint64_t elapsed = now - lastProbeUs;
+  lastProbeUs = now;
+  accumulate(Sim::shared->awakeUs + Sim::getBootMicros());
+
+  SoakDay& day = dayAt(now);
+  uint32_t freeHeap = Hal::getFreeHeap();
+  if (day.minFreeHeap == 0 || freeHeap < day.minFreeHeap) day.minFreeHeap = freeHeap;
+
+  uint64_t local = TimeManager::getEpochMs();
+  if (local / 1000 >= MIN_VALID_EPOCH) {
+    int64_t truth = (int64_t)(Sim::getUtcMicros() / 1000) + (int64_t)TIME_ZONE * ONE_HOUR_SECOND * 1000;
+    uint64_t error = llabs((int64_t)local - truth);
+    if (error > day.maxClockErrorMs) day.maxClockErrorMs = error > UINT32_MAX ? UINT32_MAX : error;
+  }
+
+  SimSensorSample truth = Sim::getTrace();
+  int food = toPercent(truth.foodCm, MAX_FOOD_DISTANCE);
+  int water = toPercent(truth.waterCm, MAX_WATER_DISTANCE);
+  float volt = applyLowBattery(now, truth.batteryVolt);
+  float battery = (volt - BATTERY_MIN_VOLT) / (BATTERY_MAX_VOLT - BATTERY_MIN_VOLT) * 100;
+
+  trackAlert(SOAK_ALERT_FOOD, AlertManager::getLevel(ALERT_FOOD) != ALERT_NORMAL,
+             food > FOOD_WARNING_THRESHOLD + 15, food < FOOD_WARNING_THRESHOLD - 5, elapsed);
+  trackAlert(SOAK_ALERT_WATER, AlertManager::getLevel(ALERT_WATER) != ALERT_NORMAL,
+             water > WATER_WARNING_THRESHOLD + 15, water < WATER_WARNING_THRESHOLD - 5, elapsed);
+  trackAlert(SOAK_ALERT_BATTERY, AlertManager::getLevel(ALERT_BATTERY) != ALERT_NORMAL,
+             battery > LOW_BATTERY_THRESHOLD + 10, battery < LOW_BATTERY_THRESHOLD - 3, elapsed);
+  probing = false;
+}
+
+static uint64_t totalUs(const std::vector<SoakWindow>& windows, uint64_t startUs, uint64_t endUs) {
+  uint64_t total = 0;
+  for (const SoakWindow& window : windows) {
+    uint64_t start = window.startUs > startUs ? window.startUs : startUs;
+    uint64_t end = window.endUs < endUs ? window.endUs : endUs;
+    if (end > start) total += end - start;
+  }
+  return total;
+}
+
+static uint32_t countStarts(const std::vector<SoakWindow>& windows, uint64_t startUs, uint64_t endUs) {
+  uint32_t count = 0;
+  for (const SoakWindow& window : windows) {
+    if (window.startUs >= startUs && window.startUs < endUs) count++;
+  }
+  return count;
+}
+
+  // Tiap jadwal harus dieksekusi tepat sekali dalam [jadwal - toleransi,
+  // jadwal + FEED_CATCHUP_WINDOW + toleransi]; toleransi = lompatan NTP
+  // terbesar + SOAK_FEED_SLACK_S. Jadwal yang bertemu episode baterai kritis
+  // boleh dilewati (firmware menunda feed saat baterai rendah).
+int Soak::report(FILE* out) {
+  if (!options.enabled) return 0;
+  SimShared& shared = *Sim::shared;
+  uint32_t days = (shared.endUs + SOAK_DAY_US - 1) / SOAK_DAY_US;
+  if (days > SOAK_MAX_DAYS) days = SOAK_MAX_DAYS;
+
+  int64_t maxJumpUs = 0;
+  for (const SoakWindow& jump : ntpJumps) maxJumpUs = std::max(maxJumpUs, (int64_t)llabs(jump.value));
+  uint64_t toleranceUs = maxJumpUs + SOAK_FEED_SLACK_S * 1000000ULL;
+  int64_t zoneUs = (int64_t)TIME_ZONE * ONE_HOUR_SECOND * 1000000LL;
+
+  std::vector<uint32_t> expected(days), missed(days), duplicate(days), excused(days), feeds(days), unexpected(days);
+  std::vector<bool> matched(soakShared->feedCount, false);
+  uint64_t localStartUs = shared.startEpoch * 1000000ULL + zoneUs;
+  uint64_t firstLocalDayUs = localStartUs - localStartUs % SOAK_DAY_US;
+  uint32_t offlineSlots = 0, offlineFeeds = 0;   // jadwal yang jatuh di gangguan panjang
+
+  for (uint64_t dayUs = firstLocalDayUs; dayUs < localStartUs + shared.endUs; dayUs += SOAK_DAY_US) {
+    for (int i = 0; i < options.expectedCount; i++) {
+      int64_t slot = (int64_t)(dayUs + options.expectedMinutes[i] * 60000000ULL) - (int64_t)localStartUs;
+      uint64_t windowEnd = slot + FEED_CATCHUP_WINDOW * 1000000ULL + toleranceUs;
+      if (slot < (int64_t)SOAK_WARMUP_US || windowEnd > shared.endUs) continue;
+      uint64_t windowStart = slot - toleranceUs;
+      uint32_t day = slot / SOAK_DAY_US;
+
+      int count = 0;
+      for (uint32_t f = 0; f < soakShared->feedCount; f++) {
+        if (soakShared->feedUs[f] < windowStart || soakShared->feedUs[f] > windowEnd) continue;
+        matched[f] = true;
+        count++;
+      }
+      expected[day]++;
+      if (findWindow(outages, slot)) {
+        offlineSlots++;
+        if (count == 1) offlineFeeds++;
+      }
+      char stamp[24];
+      Sim::formatTime(slot, stamp, sizeof(stamp));
+      if (count > 1) {
+        duplicate[day]++;
+        fprintf(out, "  FAIL %s: feed executed %d times\n", stamp, count);
+      } else if (count == 0 && overlaps(lowBattery, windowStart - 3600000000ULL, windowEnd)) {
+        excused[day]++;
+      } else if (count == 0) {
+        missed[day]++;
+        fprintf(out, "  FAIL %s: scheduled feed missed\n", stamp);
+      }
+    }
+  }
+
+  for (uint32_t f = 0; f < soakShared->feedCount; f++) {
+    uint64_t us = soakShared->feedUs[f];
+    uint32_t day = us / SOAK_DAY_US;
+    if (day >= days) continue;
+    feeds[day]++;
+    if (matched[f] || us < SOAK_WARMUP_US) continue;
+    unexpected[day]++;
+    char stamp[24];
+    Sim::formatTime(us, stamp, sizeof(stamp));
+    fprintf(out, "  FAIL %s: feed outside any schedule window\n", stamp);
+  }
+
+  FILE* csv = options.dailyPath ? fopen(options.dailyPath, "w") : NULL;
+  if (csv) {
+    fputs("day,boots,deep_sleeps,restarts,wdt_resets,awake_pct,feeds,expected_feeds,missed_feeds,"
+          "duplicate_feeds,excused_feeds,unexpected_feeds,bot_messages,ntp_requests,wifi_drops,wifi_down_s,"
+          "long_outages,outage_awake_s,ntp_jumps,low_battery_h,min_free_heap,max_clock_error_s,stuck_alerts,silent_alerts,spurious_alerts\n", csv);
+  }
+
+  uint32_t failures = 0, minHeap = UINT32_MAX, wdtResets = 0;
+  uint32_t stuck = 0, silent = 0, spurious = 0, totalMissed = 0, totalDuplicate = 0, totalExcused = 0, totalUnexpected = 0;
+  for (uint32_t d = 0; d < days; d++) {
+    const SoakDay& day = soakShared->days[d];
+    uint64_t start = d * SOAK_DAY_US, end = start + SOAK_DAY_US;
+    if (day.minFreeHeap && day.minFreeHeap < minHeap) minHeap = day.minFreeHeap;
+    wdtResets += day.wdtResets;
+    stuck += day.stuckAlerts;
+    silent += day.silentAlerts;
+    spurious += day.spuriousAlerts;
+    totalMissed += missed[d];
+    totalDuplicate += duplicate[d];
+    totalExcused += excused[d];
+    totalUnexpected += unexpected[d];
+    if (!csv) continue;
+    fprintf(csv, "%u,%u,%u,%u,%u,%.2f,%u,%u,%u,%u,%u,%u,%u,%u,%u,%.0f,%u,%.0f,%u,%.1f,%u,%.3f,%u,%u,%u\n",
+            d, day.boots, day.sleeps, day.restarts, day.wdtResets, day.awakeUs * 100.0 / SOAK_DAY_US,
+            feeds[d], expected[d], missed[d], duplicate[d], excused[d], unexpected[d], day.messages,
+            day.ntpRequests, countStarts(wifiDrops, start, end), totalUs(wifiDrops, start, end) / 1e6,
+            countStarts(outages, start, end), day.outageAwakeUs / 1e6,
+            countStarts(ntpJumps, start, end), totalUs(lowBattery, start, end) / 3600e6, day.minFreeHeap,
+            day.maxClockErrorMs / 1000.0, day.stuckAlerts, day.silentAlerts, day.spuriousAlerts);
+  }
+  if (csv) fclose(csv);
+
+  // heap: batas bawah absolut dan tidak turun terus (bocor) dari minggu pertama ke minggu terakhir
+  uint32_t firstWeek = UINT32_MAX, lastWeek = UINT32_MAX;
+  for (uint32_t d = 1; d < days; d++) {
+    uint32_t heap = soakShared->days[d].minFreeHeap;
+    if (!heap) continue;
+    if (d <= 7 && heap < firstWeek) firstWeek = heap;
+    if (d + 7 >= days && heap < lastWeek) lastWeek = heap;
+  }
+  bool heapLeak = days > 14 && firstWeek != UINT32_MAX && lastWeek != UINT32_MAX && lastWeek + SOAK_HEAP_DRIFT < firstWeek;
+
+  // gangguan panjang: restart berulang berarti jam & state RTC hilang tiap kali
+  uint32_t outageRestarts = 0, restartLoops = 0;
+  uint64_t outageAwakeUs = 0;
+  for (uint32_t d = 0; d < days; d++) outageAwakeUs += soakShared->days[d].outageAwakeUs;
+  for (size_t i = 0; i < outages.size(); i++) {
+    uint32_t restarts = soakShared->outageRestarts[i];
+    outageRestarts += restarts;
+    if (restarts < SOAK_RESTART_LOOP) continue;
+    restartLoops++;
+    char stamp[24];
+    Sim::formatTime(outages[i].startUs, stamp, sizeof(stamp));
+    fprintf(out, "  FAIL %s: %u restarts during a %.1f h WiFi outage\n", stamp, restarts,
+            (outages[i].endUs - outages[i].startUs) / 3600e6);
+  }
+  uint64_t outageUs = totalUs(outages, 0, shared.endUs);
+  // duty cycle: tanpa WiFi tetap tidur di antara jadwal/log, estimasi baterai
+  // /sysinfo hanya benar jika waktu bangun selama gangguan tetap kecil
+  double outageAwake = outageUs ? (double)outageAwakeUs / outageUs : 0;
+  bool outageAwakeHigh = DUTY_CYCLE_ENABLED && outageAwake > SOAK_OUTAGE_AWAKE_MAX;
+  if (outageAwakeHigh) {
+    fprintf(out, "  FAIL awake %.1f%% during WiFi outages (max %.0f%%)\n", outageAwake * 100,
+            SOAK_OUTAGE_AWAKE_MAX * 100);
+  }
+
+  failures = totalMissed + totalDuplicate + totalUnexpected + stuck + silent + wdtResets +
+             (minHeap < SOAK_HEAP_FLOOR) + heapLeak + restartLoops + outageAwakeHigh;
+  fprintf(out, "Soak (seed %llu): %u wifi drops, %u ntp jumps (max %lld s), %u low battery episodes, noise %.2f cm\n",
+          (unsigned long long)options.seed, (unsigned)wifiDrops.size(), (unsigned)ntpJumps.size(),
+          (long long)(maxJumpUs / 1000000), (unsigned)lowBattery.size(), options.noiseCm);
+  fprintf(out, "  feeds: %u missed, %u duplicate, %u outside schedule, %u skipped on low battery\n",
+          totalMissed, totalDuplicate, totalUnexpected, totalExcused);
+  fprintf(out, "  outages: %u (%.1f h), %u restarts, %u restart loops, awake %.1f%%, %u/%u feeds executed offline\n",
+          (unsigned)outages.size(), outageUs / 3600e6, outageRestarts, restartLoops,
+          outageAwake * 100, offlineFeeds, offlineSlots);
+  fprintf(out, "  alerts: %u stuck, %u silent, %u spurious (not counted); wdt resets: %u\n",
+          stuck, silent, spurious, wdtResets);
+  fprintf(out, "  heap: min free %u bytes (floor %u), first week %u, last week %u%s\n",
+          minHeap == UINT32_MAX ? 0 : minHeap, SOAK_HEAP_FLOOR, firstWeek == UINT32_MAX ? 0 : firstWeek,
+          lastWeek == UINT32_MAX ? 0 : lastWeek, heapLeak ? " (leak)" : "");
+  fprintf(out, "%s: %u violations\n", failures ? "SOAK FAILED" : "SOAK PASSED", failures);
+  return failures;
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+// Alokasi heap per pesan keluar: rantai String += (kode lama, disalin dari
+// baseline) vs MessageBuffer + MessageQueue (firmware sekarang). operator
+// new/delete dihitung selama pengukuran; String simulator memakai
+// std::string (SSO 15 byte), String ESP8266 punya SSO 11 byte, jadi angka
+// "before" di board sedikit lebih tinggi. JSON UniversalTelegramBot lama
+// tidak ikut dihitung, "before" = batas bawah; "after" sudah termasuk
+// membangun payload JSON sendMessage.
+#include "hostTest.h"
+#include "telegramHandler.h"
+#include "dataLogger.h"
+#include "hardware.h"
+#include "timeManager.h"
+#include <malloc.h>
+#include <new>
+
+#define BENCH_ROUNDS 2000
+
+static bool counting = false;
+static unsigned long allocations = 0;
+static size_t liveBytes = 0;
+static size_t peakBytes = 0;
+
+void* operator new(size_t size) {
+  void* block = malloc(size ? size : 1);
+  if (!block) throw std::bad_alloc();
+  if (counting) {
+    allocations++;
+    liveBytes += malloc_usable_size(block);
+    if (liveBytes > peakBytes) peakBytes = liveBytes;
+  }
+  return block;
+}
+
+void operator delete(void* block) noexcept {
+  if (!block) return;
+  if (counting) {
+    size_t size = malloc_usable_size(block);
+    liveBytes = liveBytes > size ? liveBytes - size : 0;
+  }
+  free(block);
+}
+
+void operator delete(void* block, size_t) noexcept { operator delete(block); }
+
+namespace before {
+
+static size_t sink = 0;
+
+  // signature lama: semua argumen String by value
+static void sendMessage(String chat_id, String message, String parseMode) {
+  sink += chat_id.length() + message.length() + parseMode.length();
+}
+
+static String getCurrentTimeString() {
+  char timeStr[20];
+  TimeManager::getCurrentTimeString(timeStr, sizeof(timeStr));
+  return String(timeStr);
+}
+
+static void sendStartupNotification() {
+  String message = "🟢 System Started\n";
+  message += "Hamster Feeder is now online!\n";
+  message += "Time: " + getCurrentTimeString();
+  sendMessage(CHAT_ID, message, "Markdown");
+}
+
+static void sendFoodAlert() {
+  int level = 8;
+  bool critical = true;
+  String message = critical ? "🚨 CRITICAL FOOD ALERT\n" : "⚠ Food Warning\n";
+  message += "Food level: " + String(level) + "%\n";
+  message += critical ? "Immediate refill required!" : "Consider refilling soon";
+  sendMessage(CHAT_ID, message, "Markdown");
+}
+
+static void sendBatteryAlert() {
+  float percent = 18;
+  String message = "⚠ Battery Warning\n";
+  message += "Battery: " + String(percent, 0U) + "%\n";
+  message += "Consider charging";
+  sendMessage(CHAT_ID, message, "Markdown");
+}
+
+static void sendFeedingResult() {
+  String message = "✅ Feeding Successful\n";
+  message += "Hamster has been fed!\n";
+  message += "Food level: " + String(Hardware::getFoodLevel()) + "%";
+  sendMessage(CHAT_ID, message, "Markdown");
+}
+
+static void sendDataSummary() {
+  String summary = "📊 DATA SUMMARY\n\n";
+  summary += "🍽️ Total feeds: " + String(DataLogger::getTotalFeeds()) + "\n";
+  summary += "⏰ Last feed: " + getCurrentTimeString() + "\n";
+  summary += "🔋 Battery: " + String(Hardware::getBatteryVolt(), 1U) + "V\n";
+  summary += "📈 Food: " + String(Hardware::getFoodLevel()) + "%\n";
+  summary += "💧 Water: " + String(Hardware::getWaterLevel()) + "%\n";
+  sendMessage(CHAT_ID, "📝 System Logs\n" + summary, "Markdown");
+}
+
+}
+
+namespace after {
+
+  // pesan diambil dari outbox seperti TelegramClient: payload JSON dibangun di buffer statis
+static void drain() {
+  size_t length;
+  while (!MessageQueue::isEmpty()) {
+    MessageQueue::buildPayload(length);
+    MessageQueue::markSent();
+  }
+}
+
+static void sendStartupNotification() { TelegramHandler::sendStartupNotification(); drain(); }
+
+static void sendFoodAlert() { TelegramHandler::sendFoodAlert(8, true); drain(); }
+static void sendBatteryAlert() { TelegramHandler::sendBatteryAlert(18, false); drain(); }
+static void sendFeedingResult() { TelegramHandler::sendFeedingResult(true); drain(); }
+
+static void sendDataSummary() {
+  MessageBuffer summary;
+  DataLogger::getDataSummary(summary);
+  TelegramHandler::sendLogs(summary.c_str());
+  drain();
+}
+
+}
+
+struct Scenario {
+  const char* name;
+  void (*before)();
+  void (*after)();
+};
+
+struct Measurement {
+  double allocationsPerMessage;
+  size_t peakBytes;           // satu pesan
+  double microseconds;        // per pesan, CPU host
+};
+
+static Measurement measure(void (*send)()) {
+  Measurement result;
+  send();  // pemanasan: static lokal, buffer stdio
+
+  allocations = 0;
+  liveBytes = 0;
+  peakBytes = 0;
+  counting = true;
+  send();
+  counting = false;
+  result.peakBytes = peakBytes;
+
+  allocations = 0;
+  counting = true;
+  double start = hostSeconds();
+  for (int i = 0; i < BENCH_ROUNDS; i++) send();
+  double elapsed = hostSeconds() - start;
+  counting = false;
+  result.allocationsPerMessage = (double)allocations / BENCH_ROUNDS;
+  result.microseconds = elapsed * 1e6 / BENCH_ROUNDS;
+  return result;
+}
+
+int main() {
+  testBegin();
+
+  static const Scenario scenarios[] = {
+    { "startup", before::sendStartupNotification, after::sendStartupNotification },
+    { "food alert", before::sendFoodAlert, after::sendFoodAlert },
+    { "battery alert", before::sendBatteryAlert, after::sendBatteryAlert },
+    { "feed result", before::sendFeedingResult, after::sendFeedingResult },
+    { "data summary", before::sendDataSummary, after::sendDataSummary },
+  };
+
+  printf("%-14s %22s %22s\n", "", "before (String +=)", "after (MessageBuffer)");
+  printf("%-14s %7s %7s %6s %7s %7s %6s\n", "message", "allocs", "peak B", "us", "allocs", "peak B", "us");
+  for (const Scenario& scenario : scenarios) {
+    Measurement old = measure(scenario.before);
+    Measurement now = measure(scenario.after);
+    printf("%-14s %7.1f %7zu %6.2f %7.1f %7zu %6.2f\n", scenario.name,
+           old.allocationsPerMessage, old.peakBytes, old.microseconds,
+           now.allocationsPerMessage, now.peakBytes, now.microseconds);
+
+    CHECK(old.allocationsPerMessage >= 3);
+    CHECK(now.allocationsPerMessage == 0);
+    CHECK(now.peakBytes == 0);
+  }
+  CHECK(MessageQueue::getDropCount() == 0);
+  return testEnd("allocBench");
+}
@@ -0,0 +1,112 @@
+// Lookup perintah Telegram: tabel hash sempurna (TelegramHandler::findCommand)
+// vs rantai if (text == "...") lama yang membandingkan String satu per satu
+// setelah text.toLowerCase() pada salinan. Handler tidak dijalankan, yang
+// diukur hanya mencari handler dari teks pesan. Alias "before" disalin dari
+// tabel commands[] dengan urutan yang sama (urutan if lama).
+#include "hostTest.h"
+#include "telegramHandler.h"
+#include <malloc.h>
+#include <new>
+
+#define BENCH_ROUNDS 200000
+
+static bool counting = false;
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+  void* block = malloc(size ? size : 1);
+  if (!block) throw std::bad_alloc();
+  if (counting) allocations++;
+  return block;
+}
+
+void operator delete(void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+
+static const char* const aliases[] = {
+  "/start", "/menu", "/status", "📊 status", "/makan", "🍽 feed now",
+  "/info makan", "🍽 food info", "/info minum", "💧 water info",
+  "/setwaktu", "⏰ schedule", "/tambah jadwal", "➕ add schedule",
+  "/lihat jadwal", "📋 view schedule", "/hapus jadwal", "🗑 clear schedule",
+  "/system", "⚙ system", "/logs", "📝 logs", "/export", "📦 export",
+  "/sysinfo", "ℹ system info", "/mem", "💾 memory", "/perf", "/perf reset",
+  "/reboot", "🔄 reboot", "/kembali", "🔙 back",
+};
+
+#define ALIAS_COUNT (sizeof(aliases) / sizeof(aliases[0]))
+
+namespace before {
+
+  // text by value + toLowerCase() seperti processCommand(String, String) lama
+static int findCommand(String text) {
+  text.toLowerCase();
+  for (size_t i = 0; i < ALIAS_COUNT; i++) {
+    if (text == aliases[i]) return i;
+  }
+  return -1;
+}
+
+}
+
+static volatile size_t sink = 0;   // hasil lookup dipakai supaya tidak dibuang compiler
+
+static double measureBefore(const char* text) {
+  String message(text);
+  double start = hostSeconds();
+  for (int i = 0; i < BENCH_ROUNDS; i++) sink += before::findCommand(message);
+  return (hostSeconds() - start) * 1e9 / BENCH_ROUNDS;
+}
+
+static double measureAfter(const char* text) {
+  double start = hostSeconds();
+  for (int i = 0; i < BENCH_ROUNDS; i++) {
+    sink += (size_t)TelegramHandler::findCommand(text);
+    __asm__ volatile("" : : "r"(text) : "memory");  // cegah lookup diangkat keluar loop
+  }
+  return (hostSeconds() - start) * 1e9 / BENCH_ROUNDS;
+}
+
+static void testLookup() {
+  for (size_t i = 0; i < ALIAS_COUNT; i++) {
+    CHECK(TelegramHandler::findCommand(aliases[i]) != NULL);
+  }
+  // pasangan alias menunjuk handler yang sama
+  CHECK(TelegramHandler::findCommand("/status") == TelegramHandler::findCommand("📊 status"));
+  CHECK(TelegramHandler::findCommand("/perf") != TelegramHandler::findCommand("/perf reset"));
+
+  static const char* const unknown[] = {
+    "", "/", "/statu", "/status ", "/statuss", "status", "/STATUS", "hello", "08:30",
+    "📊", "/info", "/perf  reset",
+  };
+  for (const char* text : unknown) CHECK(TelegramHandler::findCommand(text) == NULL);
+}
+
+int main() {
+  testBegin();
+  testLookup();
+
+  // pesan yang paling sering, alias di akhir rantai lama, dan teks tak dikenal
+  static const char* const samples[] = { "/status", "🍽 feed now", "🔙 back", "hello bot" };
+  printf("%-14s %14s %14s %8s\n", "message", "before ns", "after ns", "allocs");
+  double worstBefore = 0, worstAfter = 0;
+  for (const char* text : samples) {
+    double oldNs = measureBefore(text);
+    double newNs = measureAfter(text);
+    allocations = 0;
+    counting = true;
+    TelegramHandler::findCommand(text);
+    counting = false;
+    printf("%-14s %14.1f %14.1f %8lu\n", text, oldNs, newNs, allocations);
+    CHECK(allocations == 0);
+    worstBefore = max(worstBefore, oldNs);
+    worstAfter = max(worstAfter, newNs);
+  }
+
+  double start = hostSeconds();
+  for (int i = 0; i < BENCH_ROUNDS; i++) sink += (size_t)TelegramHandler::findCommand(aliases[i % ALIAS_COUNT]);
+  double elapsed = hostSeconds() - start;
+  printf("all %u aliases: %.1f M lookups/s\n", (unsigned)ALIAS_COUNT, BENCH_ROUNDS / elapsed / 1e6);
+
+  CHECK(worstAfter < worstBefore);
+  return testEnd("dispatchBench");
+}
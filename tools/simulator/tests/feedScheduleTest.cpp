@@ -0,0 +1,178 @@
+// Jadwal makan TimeManager di atas jam virtual: feedTask & sensorTask
+// berjalan lewat Scheduler seperti di firmware, "stall" = delay() panjang
+// tanpa loop (operasi blocking, brownout). Yang diuji: catch-up tepat sekali,
+// lastExecuted yang tersimpan mencegah feed ulang setelah reboot dan setelah
+// NTP melangkah mundur, jadwal lewat FEED_CATCHUP_WINDOW dilaporkan terlewat,
+// dan makanan habis ditunggu di dalam jendela.
+#include "hostTest.h"
+#include "timeManager.h"
+#include "hardware.h"
+#include "recordStore.h"
+#include "messageQueue.h"
+#include "scheduler.h"
+#include "credential.h"
+
+#define LEAD_SECONDS 120           // jadwal dibuat sejauh ini di depan jam
+#define SETTLE_MS 120000           // filter sensor sampai stabil
+#define STALL_LATE 600             // detik terlambat, masih di dalam jendela
+#define NTP_STEP_BACK_S 300
+
+static const SimSensorSample FULL = { 0, 4.0f, 3.0f, 7.8f };
+
+static void feedTask() {
+  TimeManager::checkAutoFeedSchedule();
+  Scheduler::rescheduleCurrent(TimeManager::getTimeUntilNextFeed());
+}
+
+static void sensorTask() {
+  if (!Hardware::isMeasuring()) Hardware::readAllSensors();
+  Hardware::updateSensors();
+  if (Hardware::isRanging()) Scheduler::rescheduleCurrent(ULTRASONIC_POLL_INTERVAL);
+  else if (Hardware::isMeasuring()) Scheduler::rescheduleCurrent(Hardware::getBatteryRetryDelay());
+}
+
+static void runFor(unsigned long ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    Scheduler::sleepUntilNextTask();
+    Scheduler::run();
+  }
+}
+
+  // jalankan loop sampai epoch lokal tertentu
+static void runUntil(unsigned long epoch) {
+  while (TimeManager::getEpoch() < epoch) {
+    Scheduler::sleepUntilNextTask();
+    Scheduler::run();
+  }
+}
+
+  // satu-satunya jadwal, menit berikutnya setelah LEAD_SECONDS; epoch deadline
+static unsigned long scheduleAhead() {
+  TimeManager::clearAllSchedules();
+  unsigned long deadline = TimeManager::getEpoch() + LEAD_SECONDS;
+  deadline -= deadline % 60;
+  char time[6];
+  snprintf(time, sizeof(time), "%02lu:%02lu", deadline / 3600 % 24, deadline / 60 % 60);
+  TimeManager::addSchedule(time);
+  CHECK(TimeManager::getSecondsUntilNextFeed() == deadline - TimeManager::getEpoch());
+  return deadline;
+}
+
+  // kosongkan outbox; true jika ada pesan yang memuat text
+static bool drainOutbox(const char* text) {
+  bool found = false;
+  while (!MessageQueue::isEmpty()) {
+    size_t length;
+    if (strstr(MessageQueue::buildPayload(length), text)) found = true;
+    MessageQueue::markSent();
+  }
+  return found;
+}
+
+static void addTrace(unsigned long fromNowS, float foodCm) {
+  SimSensorSample sample = FULL;
+  sample.second = Sim::now() / 1000000ULL + fromNowS;
+  sample.foodCm = foodCm;
+  Sim::addTraceSample(sample);
+}
+
+  // loop berhenti melewati deadline, lalu jalan lagi: dikejar tepat sekali
+static unsigned long testStall() {
+  unsigned long deadline = scheduleAhead();
+  uint32_t feeds = Sim::shared->feedCount;
+  delay((deadline - TimeManager::getEpoch() + STALL_LATE) * 1000UL);
+  runFor(60000);
+  CHECK(Sim::shared->feedCount == feeds + 1);
+  runFor(600000);
+  CHECK(Sim::shared->feedCount == feeds + 1);
+  CHECK(TimeManager::getSecondsUntilNextFeed() > 86400 - LEAD_SECONDS - STALL_LATE - 700);
+  return deadline;
+}
+
+  // reboot masih di dalam FEED_CATCHUP_WINDOW: jadwal & lastExecuted dibaca
+  // ulang dari RecordStore, feed yang sudah jalan tidak diulang
+static void testRebootInWindow(unsigned long deadline) {
+  CHECK(TimeManager::getEpoch() - deadline < FEED_CATCHUP_WINDOW);
+  uint32_t feeds = Sim::shared->feedCount;
+  CHECK(RecordStore::init());
+  TimeManager::init();
+  runFor(300000);
+  CHECK(Sim::shared->feedCount == feeds);
+  CHECK(TimeManager::getSecondsUntilNextFeed() > 86400 - FEED_CATCHUP_WINDOW);
+}
+
+  // stall lebih lama dari jendela: tidak makan terlambat, tapi dilaporkan
+static void testMissed() {
+  drainOutbox("");
+  unsigned long deadline = scheduleAhead();
+  uint32_t feeds = Sim::shared->feedCount;
+  delay((deadline - TimeManager::getEpoch() + FEED_CATCHUP_WINDOW + 60) * 1000UL);
+  runFor(60000);
+  CHECK(Sim::shared->feedCount == feeds);
+  CHECK(drainOutbox("missed"));
+  CHECK(TimeManager::getSecondsUntilNextFeed() > 86400 - FEED_CATCHUP_WINDOW - 200);
+}
+
+  // makanan habis saat deadline: dicoba lagi di dalam jendela, makan sekali
+  // setelah diisi ulang
+static void testLowFoodRetry() {
+  unsigned long deadline = scheduleAhead();
+  unsigned long refillIn = deadline - TimeManager::getEpoch() + STALL_LATE;
+  addTrace(0, FULL.foodCm);
+  addTrace(1, MAX_FOOD_DISTANCE);
+  addTrace(refillIn, MAX_FOOD_DISTANCE);
+  addTrace(refillIn + 1, FULL.foodCm);
+  uint32_t feeds = Sim::shared->feedCount;
+
+  runUntil(deadline + 60);
+  CHECK(Hardware::getFoodLevel() <= FOOD_CRITICAL_THRESHOLD);
+  CHECK(Sim::shared->feedCount == feeds);
+  runUntil(deadline + STALL_LATE - 5);
+  CHECK(Sim::shared->feedCount == feeds);
+  CHECK(TimeManager::getSecondsUntilNextFeed() == 0);   // masih menunggu di jendela
+
+  runUntil(deadline + FEED_CATCHUP_WINDOW - 60);
+  CHECK(Hardware::getFoodLevel() > FOOD_CRITICAL_THRESHOLD);
+  CHECK(Sim::shared->feedCount == feeds + 1);
+}
+
+  // server NTP mundur melewati deadline yang sudah dieksekusi: jam melangkah
+  // mundur, jadwal yang sama tidak dijalankan lagi
+static void testNtpStepBack() {
+  unsigned long deadline = scheduleAhead();
+  uint32_t feeds = Sim::shared->feedCount;
+  runUntil(deadline + 60);
+  CHECK(Sim::shared->feedCount == feeds + 1);
+
+  Sim::shared->ntpOffsetUs = -NTP_STEP_BACK_S * 1000000LL;
+  TimeManager::syncTime();
+  CHECK(TimeManager::getEpoch() < deadline);
+  runFor((NTP_STEP_BACK_S + 600) * 1000UL);
+  CHECK(TimeManager::getEpoch() > deadline);
+  CHECK(Sim::shared->feedCount == feeds + 1);
+  Sim::shared->ntpOffsetUs = 0;
+}
+
+int main() {
+  testBegin();
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  while (WiFi.status() != WL_CONNECTED) delay(100);
+
+  CHECK(RecordStore::init());
+  Hardware::init(false);
+  TimeManager::init();
+  CHECK(TimeManager::isClockValid(TimeManager::getEpoch()));
+  Scheduler::addTask("feed", feedTask, FEED_CHECK_INTERVAL, 5000, 0);
+  Scheduler::addTask("sensors", sensorTask, SENSOR_READ_INTERVAL, 1000, 2);
+  runFor(SETTLE_MS);
+  CHECK(Hardware::getFoodLevel() > FOOD_CRITICAL_THRESHOLD);
+
+  unsigned long deadline = testStall();
+  testRebootInWindow(deadline);
+  testMissed();
+  testLowFoodRetry();
+  testNtpStepBack();
+  return testEnd("feedScheduleTest");
+}
@@ -0,0 +1,182 @@
+// SensorFilter dengan trace jarak dalam format Serial sketch
+// testKalibrasi/testUltrasonic ("Jarak Makanan: x cm<TAB>Jarak Air: y cm",
+// -1 = echo hilang), diproses seperti Hardware::readFoodSensor/readWaterSensor.
+//
+//   ./filterTest                 # trace bawaan di traces/
+//   ./filterTest capture.txt     # statistik untuk log Serial sendiri
+#include "hostTest.h"
+#include "config.h"
+#include "sensorFilter.h"
+#include <vector>
+
+#define TRACE_DIR "../traces/"
+
+struct TraceLine {
+  float foodCm;
+  float waterCm;
+};
+
+struct ChannelResult {
+  int samples;                // bacaan valid (echo ada)
+  int skipped;                // timeout, tidak masuk filter
+  unsigned long rejected;
+  float minValue;             // cm setelah filter
+  float maxValue;
+  int rawCrossings;           // berapa kali level mentah melewati ambang warning
+  int filteredCrossings;
+  std::vector<float> values;
+};
+
+static bool loadTrace(const char* path, std::vector<TraceLine>& lines) {
+  FILE* file = fopen(path, "r");
+  if (!file) return false;
+  char text[128];
+  while (fgets(text, sizeof(text), file)) {
+    TraceLine line;
+    // baris lain (judul sketch, pesan boot) dilewati
+    if (sscanf(text, "Jarak Makanan: %f cm Jarak Air: %f cm", &line.foodCm, &line.waterCm) == 2) {
+      lines.push_back(line);
+    }
+  }
+  fclose(file);
+  return !lines.empty();
+}
+
+  // sama dengan Hardware::distanceToPercent
+static int toPercent(float distance, float maxDistance) {
+  float percent = (maxDistance - distance) / (maxDistance - MIN_DISTANCE) * 100;
+  return constrain((int)(percent + 0.5), 0, 100);
+}
+
+static ChannelResult runChannel(const std::vector<TraceLine>& lines, bool food) {
+  float maxDistance = food ? MAX_FOOD_DISTANCE : MAX_WATER_DISTANCE;
+  float warning = food ? FOOD_WARNING_THRESHOLD : WATER_WARNING_THRESHOLD;
+  SensorFilter<FILTER_MEDIAN_SIZE> filter(LEVEL_FILTER_ALPHA, food ? FOOD_OUTLIER_CM : WATER_OUTLIER_CM,
+                                          FILTER_MAX_REJECTS);
+  ChannelResult result = {};
+  result.minValue = 1e9;
+  result.maxValue = -1e9;
+  bool rawLow = false, filteredLow = false, first = true;
+
+  for (const TraceLine& line : lines) {
+    float distance = food ? line.foodCm : line.waterCm;
+    if (distance <= 0) {
+      result.skipped++;
+      continue;
+    }
+    if (distance > maxDistance) distance = maxDistance;
+    result.samples++;
+    filter.add(distance);
+    float value = filter.value();
+    result.values.push_back(value);
+
+    bool nowRawLow = toPercent(distance, maxDistance) <= warning;
+    bool nowFilteredLow = toPercent(value, maxDistance) <= warning;
+    if (!first && nowRawLow != rawLow) result.rawCrossings++;
+    if (!first && nowFilteredLow != filteredLow) result.filteredCrossings++;
+    rawLow = nowRawLow;
+    filteredLow = nowFilteredLow;
+    first = false;
+  }
+  result.rejected = filter.getRejectedCount();
+  return result;
+}
+
+  // rentang nilai terfilter dari sampel ke-from (setelah filter terisi)
+static void measureRange(ChannelResult& result, size_t from, size_t to) {
+  for (size_t i = from; i < to && i < result.values.size(); i++) {
+    result.minValue = min(result.minValue, result.values[i]);
+    result.maxValue = max(result.maxValue, result.values[i]);
+  }
+}
+
+static void printResult(const char* name, const ChannelResult& result) {
+  printf("%-6s samples %d, timeouts %d, rejected %lu, range %.2f-%.2f cm, "
+         "warning crossings raw %d / filtered %d\n", name, result.samples, result.skipped,
+         result.rejected, result.minValue, result.maxValue, result.rawCrossings,
+         result.filteredCrossings);
+}
+
+  // wadah diam: noise, spike pantulan dan echo hilang tidak menggerakkan nilai
+static void testSteady() {
+  std::vector<TraceLine> lines;
+  CHECK(loadTrace(TRACE_DIR "steady.txt", lines));
+  ChannelResult food = runChannel(lines, true);
+  ChannelResult water = runChannel(lines, false);
+  measureRange(food, FILTER_MEDIAN_SIZE, food.values.size());
+  measureRange(water, FILTER_MEDIAN_SIZE, water.values.size());
+  printResult("food", food);
+  printResult("water", water);
+
+  CHECK(food.skipped == 7 && water.skipped == 6);
+  CHECK(food.rejected >= 12);     // 13 spike, yang dekat median boleh lolos
+  CHECK(water.rejected >= 9);
+  CHECK_NEAR(food.minValue, 8.0, 0.4);   // 0.4 cm = 3% level
+  CHECK_NEAR(food.maxValue, 8.0, 0.4);
+  CHECK_NEAR(water.minValue, 3.5, 0.2);
+  CHECK_NEAR(water.maxValue, 3.5, 0.2);
+  CHECK(food.filteredCrossings == 0 && water.filteredCrossings == 0);
+}
+
+  // wadah diisi: lompatan besar dianggap nyata setelah FILTER_MAX_REJECTS
+  // sampel, spike tunggal sesudahnya tetap ditolak
+static void testRefill() {
+  std::vector<TraceLine> lines;
+  CHECK(loadTrace(TRACE_DIR "refill.txt", lines));
+  ChannelResult food = runChannel(lines, true);
+  ChannelResult water = runChannel(lines, false);
+  const size_t step = 200;
+  size_t settled = step + FILTER_MAX_REJECTS + FILTER_MEDIAN_SIZE;
+  measureRange(food, settled, food.values.size());
+  measureRange(water, settled, water.values.size());
+  printResult("food", food);
+  printResult("water", water);
+
+  CHECK(food.values[step - 1] > 12.0);
+  CHECK(food.values[step + FILTER_MAX_REJECTS - 2] > 12.0);   // belum percaya
+  CHECK_NEAR(food.minValue, 3.2, 0.4);
+  CHECK_NEAR(food.maxValue, 3.2, 0.4);
+  CHECK(water.values[step - 1] > 5.5);
+  CHECK_NEAR(water.minValue, 2.1, 0.3);
+  CHECK_NEAR(water.maxValue, 2.1, 0.3);
+  CHECK(food.filteredCrossings == 1);   // kosong -> penuh, sekali
+}
+
+  // level turun pelan melewati ambang warning: level mentah bolak-balik
+  // ratusan kali (tiap kali = evaluasi alert), level terfilter jauh lebih jarang
+static void testThreshold() {
+  std::vector<TraceLine> lines;
+  CHECK(loadTrace(TRACE_DIR "threshold.txt", lines));
+  ChannelResult food = runChannel(lines, true);
+  measureRange(food, FILTER_MEDIAN_SIZE, food.values.size());
+  printResult("food", food);
+
+  // sisa bolak-balik di sekitar ambang ditahan hysteresis AlertManager
+  CHECK(food.rawCrossings >= 100);
+  CHECK(food.filteredCrossings <= food.rawCrossings / 5);
+  CHECK(food.filteredCrossings >= 1);
+  CHECK(food.values.back() > 10.5);
+}
+
+int main(int argc, char** argv) {
+  testBegin();
+  if (argc > 1) {
+    std::vector<TraceLine> lines;
+    if (!loadTrace(argv[1], lines)) {
+      fprintf(stderr, "cannot read %s\n", argv[1]);
+      return 1;
+    }
+    ChannelResult food = runChannel(lines, true);
+    ChannelResult water = runChannel(lines, false);
+    measureRange(food, FILTER_MEDIAN_SIZE, food.values.size());
+    measureRange(water, FILTER_MEDIAN_SIZE, water.values.size());
+    printResult("food", food);
+    printResult("water", water);
+    return 0;
+  }
+
+  testSteady();
+  testRefill();
+  testThreshold();
+  return testEnd("filterTest");
+}
@@ -0,0 +1,62 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <simulator.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <time.h>
+
+#define TEST_START_EPOCH 1760054400ULL  // 2025-10-10 00:00 UTC, sama dengan simulator
+#define TEST_FS_ROOT "testfs"
+
+// Tes & benchmark host untuk satu modul firmware (lihat run.sh). Berjalan di
+// atas shim simulator dalam satu proses tanpa fork: jam virtual dimulai dari
+// 0 dan tidak pernah habis, Serial diam kecuali NIBBLO_TEST_VERBOSE diset.
+// Reset/deep sleep dari firmware menghentikan proses, jadi modul yang diuji
+// tidak boleh sampai memanggilnya.
+static int testFailures = 0;
+static int testChecks = 0;
+
+#define CHECK(condition) testCheck((condition), #condition, __FILE__, __LINE__)
+#define CHECK_NEAR(value, expected, tolerance) \
+  testCheck(fabs((double)(value) - (double)(expected)) <= (tolerance), \
+            #value " ~ " #expected, __FILE__, __LINE__, (double)(value))
+
+static inline void testCheck(bool passed, const char* text, const char* file, int line,
+                             double value = NAN) {
+  testChecks++;
+  if (passed) return;
+  testFailures++;
+  if (isnan(value)) fprintf(stderr, "FAIL %s:%d: %s\n", file, line, text);
+  else fprintf(stderr, "FAIL %s:%d: %s (got %g)\n", file, line, text, value);
+}
+
+static inline void testBegin() {
+  static SimShared shared;
+  memset(&shared, 0, sizeof(shared));
+  shared.endUs = UINT64_MAX;
+  shared.startEpoch = TEST_START_EPOCH;
+  shared.servoAngle = -1;
+  Sim::shared = &shared;
+  Sim::options.fsRoot = TEST_FS_ROOT;
+  Sim::options.quiet = getenv("NIBBLO_TEST_VERBOSE") == NULL;
+  Sim::beginBoot();
+  LittleFS.begin();
+  LittleFS.format();
+}
+
+static inline int testEnd(const char* name) {
+  fflush(stdout);
+  fprintf(stderr, "%s: %s (%d checks, %d failed)\n", name,
+          testFailures ? "FAIL" : "ok", testChecks, testFailures);
+  return testFailures ? 1 : 0;
+}
+
+  // waktu CPU host untuk benchmark (jam virtual tidak mengukur apa-apa)
+static inline double hostSeconds() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+// Long polling TelegramHandler terhadap server palsu simNetwork.cpp: satu
+// getUpdates ditahan server, perintah dijalankan sepersekian detik setelah
+// dikirim (short polling: sampai BOT_CHECK_INTERVAL), request jauh lebih
+// jarang, dan task lain tetap jalan selama menunggu respons.
+#include "hostTest.h"
+#include "telegramHandler.h"
+#include "credential.h"
+
+#define TICK_INTERVAL 50           // task lain, mis. sensorTask/displayTask
+#define LOOP_STEP 5
+#define COMMAND_LATENCY_MAX 500    // ms dari pesan dikirim sampai perintah dijalankan
+
+// Server palsu menghitung respons saat request diterima, jadi perintah
+// didaftarkan di awal dengan waktu kirimnya (ms sejak boot)
+#define IDLE_START 10000
+#define IDLE_END 130000
+#define COMMAND_AT 137300          // di tengah poll yang sedang ditahan
+#define BURST_AT 190000
+
+struct ServiceStats {
+  unsigned long ticks;
+  unsigned long worstTickLate;     // ms
+  unsigned long dispatchedAt;      // millis() saat balasan pertama masuk outbox, 0 = belum
+};
+
+static void connectWifi() {
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  while (WiFi.status() != WL_CONNECTED) delay(100);
+}
+
+static unsigned long requestCount() {
+  return TelegramClient::getHandshakeCount() + TelegramClient::getReuseCount();
+}
+
+  // loop kooperatif kecil: checkMessages() sesuai getServiceDelay(), task
+  // lain tiap TICK_INTERVAL
+static ServiceStats serviceUntil(unsigned long end) {
+  ServiceStats stats = {};
+  unsigned long nextTelegram = millis();
+  unsigned long nextTick = millis();
+  while (millis() < end) {
+    unsigned long now = millis();
+    if ((long)(now - nextTick) >= 0) {
+      stats.ticks++;
+      stats.worstTickLate = max(stats.worstTickLate, now - nextTick);
+      nextTick += TICK_INTERVAL;
+    }
+    if ((long)(now - nextTelegram) >= 0) {
+      TelegramHandler::checkMessages();
+      nextTelegram = millis() + TelegramHandler::getServiceDelay();
+    }
+    if (stats.dispatchedAt == 0 && !MessageQueue::isEmpty()) stats.dispatchedAt = millis();
+    delay(LOOP_STEP);
+  }
+  return stats;
+}
+
+  // poll pertama setelah bangun tidak ditahan (duty cycle), sesudahnya menunggu di server
+static void testFirstPoll() {
+  serviceUntil(IDLE_START);
+  CHECK(TelegramHandler::isQuiet());
+  CHECK(TelegramClient::isWaiting());
+  CHECK(TelegramHandler::getServiceDelay() == TELEGRAM_LONG_POLL_STEP);
+}
+
+  // tanpa pesan: satu request per TELEGRAM_LONG_POLL_TIMEOUT, task lain tidak tertahan
+static void testIdle() {
+  unsigned long requests = requestCount();
+  unsigned long handshakes = TelegramClient::getHandshakeCount();
+  const unsigned long duration = IDLE_END - IDLE_START;
+  ServiceStats stats = serviceUntil(IDLE_END);
+  unsigned long made = requestCount() - requests;
+  printf("idle %lus: %lu getUpdates (short polling: %lu), worst tick delay %lu ms\n",
+         duration / 1000, made, duration / BOT_CHECK_INTERVAL, stats.worstTickLate);
+
+  CHECK(made <= duration / (TELEGRAM_LONG_POLL_TIMEOUT * 1000UL) + 1);
+  CHECK(TelegramClient::getHandshakeCount() == handshakes);  // keep-alive tetap dipakai
+  CHECK(stats.ticks >= duration / TICK_INTERVAL - 1);
+  CHECK(stats.worstTickLate <= TELEGRAM_STEP_BUDGET + LOOP_STEP);
+}
+
+  // perintah masuk di tengah long poll: dijalankan sepersekian detik kemudian,
+  // balasannya memotong poll yang menunggu
+static void testCommand() {
+  unsigned messages = Sim::shared->messageCount;
+  ServiceStats stats = serviceUntil(COMMAND_AT + 10000);
+
+  CHECK(stats.dispatchedAt != 0);
+  unsigned long latency = stats.dispatchedAt - COMMAND_AT;
+  printf("command latency %lu ms (short polling: up to %d ms)\n", latency, BOT_CHECK_INTERVAL);
+  CHECK(stats.dispatchedAt >= COMMAND_AT);
+  CHECK(latency <= COMMAND_LATENCY_MAX);
+  CHECK(Sim::shared->messageCount == messages + 1);
+  CHECK(MessageQueue::isEmpty());
+  CHECK(TelegramHandler::getLastUpdateId() == 1000);
+
+  // update sudah dikonfirmasi lewat offset: tidak dijalankan dua kali
+  serviceUntil(BURST_AT - 5000);
+  CHECK(Sim::shared->messageCount == messages + 1);
+  CHECK(TelegramClient::isWaiting());
+}
+
+  // beberapa perintah beruntun dalam satu respons / poll berikutnya
+static void testBurst() {
+  unsigned messages = Sim::shared->messageCount;
+  serviceUntil(BURST_AT + 10000);
+  CHECK(TelegramHandler::getLastUpdateId() == 1003);
+  CHECK(Sim::shared->messageCount > messages);   // balasan ke chat sama boleh digabung
+  CHECK(MessageQueue::getDropCount() == 0);
+  CHECK(MessageQueue::isEmpty());
+}
+
+int main() {
+  testBegin();
+  connectWifi();
+  TelegramHandler::init();
+  Sim::addTelegramCommand(COMMAND_AT * 1000ULL, "/status");
+  for (int i = 0; i < 3; i++) Sim::addTelegramCommand(BURST_AT * 1000ULL, "/mem");
+
+  testFirstPoll();
+  testIdle();
+  testCommand();
+  testBurst();
+  return testEnd("longPollTest");
+}
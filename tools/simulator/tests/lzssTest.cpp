@@ -0,0 +1,191 @@
+// Round trip LzssEncoder -> tools/exportDecoder (dibangun run.sh di build/):
+// input buatan di tepi format (match tumpang tindih, panjang maksimum,
+// offset sejauh window, data acak), lalu ekspor lengkap LogExporter dari
+// riwayat DataLogger, diambil dari body multipart seperti yang diterima
+// Telegram. Parameter LZSS dibaca dekoder dari header file, bukan disalin.
+#include "hostTest.h"
+#include "lzssEncoder.h"
+#include "logExporter.h"
+#include "dataLogger.h"
+#include "timeManager.h"
+#include "credential.h"
+#include <string>
+#include <vector>
+
+#define DECODER "./exportDecoder"
+#define NBZ_PATH TEST_FS_ROOT "/roundtrip.nbz"
+#define CSV_PATH TEST_FS_ROOT "/roundtrip.csv"
+
+static const std::string* input;
+static size_t inputPosition;
+
+static int nextInputByte() {
+  if (inputPosition >= input->size()) return -1;
+  return (uint8_t)(*input)[inputPosition++];
+}
+
+static void writeFile(const char* path, const std::string& data) {
+  FILE* file = fopen(path, "wb");
+  if (!file) return;
+  fwrite(data.data(), 1, data.size(), file);
+  fclose(file);
+}
+
+static bool readFile(const char* path, std::string& data) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  data.clear();
+  char buffer[512];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) data.append(buffer, count);
+  fclose(file);
+  return true;
+}
+
+  // file .nbz ke dekoder; isi CSV hasilnya, atau false jika dekoder gagal
+static bool decodeFile(const std::string& nbz, std::string& decoded) {
+  writeFile(NBZ_PATH, nbz);
+  if (system(DECODER " " NBZ_PATH " > " CSV_PATH " 2>/dev/null") != 0) return false;
+  return readFile(CSV_PATH, decoded);
+}
+
+static std::string header(const char* magic, uint32_t rawLength, int windowBits, int lengthBits, int minMatch) {
+  std::string data(magic, 4);
+  for (int i = 0; i < 4; i++) data += (char)(rawLength >> (8 * i));
+  if (strcmp(magic, "NBZ2") == 0) {
+    data += (char)windowBits;
+    data += (char)lengthBits;
+    data += (char)minMatch;
+    data += '\0';
+  }
+  return data;
+}
+
+  // kompres lewat LzssEncoder, bungkus dengan header seperti LogExporter
+static std::string compress(const std::string& data) {
+  input = &data;
+  inputPosition = 0;
+  LzssEncoder::begin(nextInputByte);
+  std::string nbz = header("NBZ2", data.size(), LZSS_WINDOW_BITS, LZSS_LENGTH_BITS, LZSS_MIN_MATCH);
+  uint8_t buffer[37];  // ukuran ganjil: batas read() tidak sejajar grup token
+  size_t count;
+  while ((count = LzssEncoder::read(buffer, sizeof(buffer))) > 0) nbz.append((const char*)buffer, count);
+  return nbz;
+}
+
+static void checkRoundTrip(const char* name, const std::string& data, double maxRatio) {
+  std::string nbz = compress(data);
+  std::string decoded;
+  bool ok = decodeFile(nbz, decoded);
+  CHECK(ok);
+  CHECK(decoded == data);
+  double ratio = data.empty() ? 0 : (double)(nbz.size() - 12) / data.size();
+  printf("%-12s %7zu -> %7zu bytes (%.2f)\n", name, data.size(), nbz.size(), ratio);
+  CHECK(ratio <= maxRatio);
+}
+
+static void testEdgeCases() {
+  checkRoundTrip("empty", "", 0);
+  checkRoundTrip("one byte", "x", 2);
+  checkRoundTrip("run", std::string(5000, 'a'), 0.05);   // match tumpang tindih, panjang maksimum
+
+  // pola berulang tepat sejauh window: offset maksimum
+  std::string far;
+  srand(7);
+  for (int i = 0; i < LZSS_WINDOW; i++) far += (char)('a' + rand() % 26);
+  far += far.substr(0, 200);
+  far += far;
+  checkRoundTrip("far match", far, 0.9);
+
+  std::string noise;
+  for (int i = 0; i < 6000; i++) noise += (char)(rand() & 0xFF);
+  checkRoundTrip("random", noise, 1.13);   // 1 flag per 8 literal
+
+  std::string csv;
+  char line[64];
+  for (int i = 0; i < 2000; i++) {
+    snprintf(line, sizeof(line), "%lu,%d,%d,%d,%s\n", 1760054400UL + i * 300, 80 - i / 40, 60 - i / 50,
+             4100 - i / 10, i % 144 == 0 ? "feed_auto" : "");
+    csv += line;
+  }
+  checkRoundTrip("history csv", csv, 0.5);
+}
+
+  // dekoder memakai parameter dari header: token match yang sama berarti
+  // hal berbeda dengan window 12/4 dan 10/6
+static void testHeaderParameters() {
+  std::string decoded;
+  std::string stream;
+  stream += (char)0x07;               // 3 literal lalu 1 match
+  stream += "abc";
+  uint16_t wide = 2 | (3 << 12);      // offset 3, panjang 3 + 3
+  stream += (char)(wide & 0xFF);
+  stream += (char)(wide >> 8);
+  CHECK(decodeFile(header("NBZ2", 9, 12, 4, 3) + stream, decoded));
+  CHECK(decoded == "abcabcabc");
+
+  stream.resize(4);
+  uint16_t legacy = 2 | (3 << 10);
+  stream += (char)(legacy & 0xFF);
+  stream += (char)(legacy >> 8);
+  CHECK(decodeFile(header("NBZ1", 9, 0, 0, 0) + stream, decoded));   // NBZ1: selalu 10/6/3
+  CHECK(decoded == "abcabcabc");
+
+  CHECK(!decodeFile(header("NBZ2", 9, 10, 4, 3) + stream, decoded));  // token bukan 16 bit
+  CHECK(!decodeFile("NBZ9abcdefgh", decoded));
+}
+
+  // /export utuh: riwayat DataLogger -> multipart sendDocument -> CSV
+static void testExport() {
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  while (WiFi.status() != WL_CONNECTED) delay(100);
+  TimeManager::syncTime();
+  CHECK(TimeManager::isClockValid(TimeManager::getEpoch()));
+
+  const int samples = 400;
+  for (int i = 0; i < samples; i++) {
+    DataLogger::logPeriodicData();
+    if (i % 100 == 50) DataLogger::logFeeding("AUTO", "08:00");
+    delay(DATA_LOG_INTERVAL);
+  }
+  int count = DataLogger::getHistoryCount();
+  CHECK(count == samples + samples / 100);
+
+  CHECK(LogExporter::begin(CHAT_ID));
+  while (LogExporter::isMeasuring()) LogExporter::measureStep();
+  CHECK(LogExporter::isReady());
+  LogExporter::startUpload();
+  std::string body;
+  uint8_t buffer[TELEGRAM_UPLOAD_CHUNK];
+  size_t read;
+  while ((read = LogExporter::readBody(buffer, sizeof(buffer))) > 0) body.append((const char*)buffer, read);
+  LogExporter::finish();
+  CHECK(body.size() == LogExporter::getContentLength());
+
+  // bagian "document": setelah header part sampai boundary penutup
+  size_t start = body.find("application/octet-stream\r\n\r\n");
+  size_t end = body.rfind("\r\n--" EXPORT_BOUNDARY "--");
+  CHECK(start != std::string::npos && end != std::string::npos);
+  if (start == std::string::npos || end == std::string::npos) return;
+  start += strlen("application/octet-stream\r\n\r\n");
+  std::string nbz = body.substr(start, end - start);
+
+  std::string csv;
+  CHECK(decodeFile(nbz, csv));
+  int lines = 0, feeds = 0;
+  for (char c : csv) lines += c == '\n';
+  for (size_t found = csv.find("feed_auto"); found != std::string::npos; found = csv.find("feed_auto", found + 1)) feeds++;
+  printf("export: %d samples, csv %zu -> nbz %zu bytes\n", count, csv.size(), nbz.size());
+  CHECK(csv.compare(0, 9, "# nibblo ") == 0);
+  CHECK(lines == count + 2);
+  CHECK(feeds == samples / 100);
+}
+
+int main() {
+  testBegin();
+  testEdgeCases();
+  testHeaderParameters();
+  testExport();
+  return testEnd("lzssTest");
+}
@@ -0,0 +1,87 @@
+// TextBuffer & batas panjang MessageQueue: teks yang dipotong tidak boleh
+// berakhir di tengah karakter UTF-8 (Telegram menolak pesannya dengan 400).
+#include "hostTest.h"
+#include "messageBuffer.h"
+#include "messageQueue.h"
+
+#define EMOJI "\xF0\x9F\x90\xB9"       // 🐹, 4 byte
+#define WARNING_SIGN "\xE2\x9A\xA0"    // ⚠, 3 byte
+#define E_ACUTE "\xC3\xA9"             // é, 2 byte
+
+  // valid = tiap byte awal diikuti tepat jumlah byte lanjutannya
+static bool isValidUtf8(const char* text) {
+  const uint8_t* p = (const uint8_t*)text;
+  while (*p) {
+    int extra = *p < 0x80 ? 0 : *p >= 0xF0 ? 3 : *p >= 0xE0 ? 2 : *p >= 0xC0 ? 1 : -1;
+    if (extra < 0) return false;
+    p++;
+    for (int i = 0; i < extra; i++, p++) {
+      if ((*p & 0xC0) != 0x80) return false;
+    }
+  }
+  return true;
+}
+
+static void testPrefix() {
+  const char* text = "ab" EMOJI;
+  CHECK(utf8Prefix(text, 6) == 6);
+  for (size_t cut = 3; cut < 6; cut++) CHECK(utf8Prefix(text, cut) == 2);
+  CHECK(utf8Prefix(text, 2) == 2);
+  CHECK(utf8Prefix(E_ACUTE, 1) == 0);
+  CHECK(utf8Prefix(E_ACUTE, 2) == 2);
+  CHECK(utf8Prefix("", 0) == 0);
+}
+
+  // geser posisi emoji terhadap batas kapasitas di semua offset
+template <size_t N>
+static void testBuffer() {
+  for (size_t pad = 0; pad < N; pad++) {
+    char filler[N + 1];
+    memset(filler, 'x', pad);
+    filler[pad] = '\0';
+
+    TextBuffer<N> appended;
+    appended.append(filler).append(EMOJI WARNING_SIGN E_ACUTE EMOJI);
+    CHECK(isValidUtf8(appended.c_str()));
+    CHECK(appended.length() == strlen(appended.c_str()));
+    CHECK(appended.isTruncated() == (pad + 13 > N - 1));
+
+    TextBuffer<N> formatted;
+    formatted.appendf("%s%s %d%%", filler, EMOJI WARNING_SIGN, 42);
+    CHECK(isValidUtf8(formatted.c_str()));
+    CHECK(formatted.length() == strlen(formatted.c_str()));
+    CHECK(formatted.length() <= N - 1);
+  }
+}
+
+static void testQueue() {
+  // teks lebih panjang dari slot: dipotong di batas karakter, bukan di tengah emoji
+  static char text[OUTBOX_TEXT_SIZE + 64];
+  for (size_t offset = 0; offset < 4; offset++) {
+    size_t length = 0;
+    memset(text, 'x', offset);
+    length = offset;
+    while (length + 4 < sizeof(text)) {
+      memcpy(text + length, EMOJI, 4);
+      length += 4;
+    }
+    text[length] = '\0';
+
+    CHECK(MessageQueue::enqueue("42", text, ""));
+    size_t payloadLength = 0;
+    const char* payload = MessageQueue::buildPayload(payloadLength);
+    CHECK(payload != NULL);
+    if (payload) CHECK(isValidUtf8(payload));
+    MessageQueue::markSent();
+  }
+  CHECK(MessageQueue::getDepth() == 0);
+}
+
+int main() {
+  testBegin();
+  testPrefix();
+  testBuffer<16>();
+  testBuffer<MESSAGE_BUFFER_SIZE>();
+  testQueue();
+  return testEnd("messageBufferTest");
+}
@@ -0,0 +1,150 @@
+// UpdateParser pada respons getUpdates berisi 1, 10 dan 100 update (backlog
+// setelah WiFi putus). Payload meniru respons Bot API asli: from/chat lengkap,
+// entities, emoji sebagai \u surrogate. Diumpankan byte per byte seperti
+// TelegramClient::storeBody, termasuk jeda sampai release(). Yang diukur:
+// alokasi heap (harus 0 untuk semua ukuran), buffer tetap parser, dan waktu
+// CPU host per update. Kode lama menyimpan seluruh body ke String lalu
+// ArduinoJson, jadi memorinya minimal sebesar body.
+//
+//   ./parserBench                # payload bawaan
+//   ./parserBench updates.json   # respons getUpdates hasil rekaman sendiri
+#include "hostTest.h"
+#include "updateParser.h"
+#include "credential.h"
+#include <malloc.h>
+#include <new>
+#include <string>
+
+#define BENCH_ROUNDS 200
+
+static bool counting = false;
+static unsigned long allocations = 0;
+
+void* operator new(size_t size) {
+  void* block = malloc(size ? size : 1);
+  if (!block) throw std::bad_alloc();
+  if (counting) allocations++;
+  return block;
+}
+
+void operator delete(void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+
+static const char* const texts[] = {
+  "/status",
+  "\\ud83c\\udf7d Feed now",
+  "/info makan",
+  "\\ud83d\\udcca Status",
+  "08:30",
+  "/perf",
+};
+
+static const char* const expectedTexts[] = {
+  "/status",
+  "\xF0\x9F\x8D\xBD feed now",
+  "/info makan",
+  "\xF0\x9F\x93\x8A status",
+  "08:30",
+  "/perf",
+};
+
+static std::string buildPayload(int count) {
+  std::string body = "{\"ok\":true,\"result\":[";
+  char update[640];
+  for (int i = 0; i < count; i++) {
+    const char* text = texts[i % 6];
+    snprintf(update, sizeof(update),
+             "%s{\"update_id\":%d,\n\"message\":{\"message_id\":%d,\"from\":{\"id\":%s,\"is_bot\":false,"
+             "\"first_name\":\"Nibblo \\ud83d\\udc39\",\"username\":\"nibblo_owner\",\"language_code\":\"id\"},"
+             "\"chat\":{\"id\":%s,\"first_name\":\"Nibblo \\ud83d\\udc39\",\"username\":\"nibblo_owner\","
+             "\"type\":\"private\"},\"date\":%d,\"text\":\"%s\"%s}}",
+             i ? "," : "", 734520000 + i, 4100 + i, CHAT_ID, CHAT_ID, 1760054400 + i * 7, text,
+             text[0] == '/' ? ",\"entities\":[{\"offset\":0,\"length\":7,\"type\":\"bot_command\"}]" : "");
+    body += update;
+  }
+  body += "]}";
+  return body;
+}
+
+struct ParseResult {
+  int updates;
+  int textMatches;
+  long lastUpdateId;
+};
+
+  // seperti TelegramHandler::dispatchUpdate: ambil field, lalu release()
+static ParseResult parse(const std::string& body) {
+  ParseResult result = {};
+  UpdateParser::reset();
+  for (char c : body) {
+    if (UpdateParser::feed(c)) continue;
+    result.updates++;
+    result.lastUpdateId = UpdateParser::getUpdateId();
+    if (UpdateParser::hasMessageText() && strcmp(UpdateParser::getChatId(), CHAT_ID) == 0) {
+      char* text = UpdateParser::getText();
+      for (char* p = text; *p; p++) *p = tolower((unsigned char)*p);
+      const char* expected = expectedTexts[(result.updates - 1) % 6];
+      if (strcmp(text, expected) == 0) result.textMatches++;
+    }
+    UpdateParser::release();
+  }
+  return result;
+}
+
+static bool loadFile(const char* path, std::string& body) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  char buffer[512];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) body.append(buffer, count);
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  testBegin();
+  // buffer tetap parser: frame per level + field yang disimpan
+  size_t parserBytes = sizeof(ParserFrame) * UPDATE_PARSER_DEPTH + UPDATE_TEXT_SIZE +
+                       TELEGRAM_CHAT_ID_SIZE + UPDATE_LITERAL_SIZE;
+
+  if (argc > 1) {
+    std::string body;
+    if (!loadFile(argv[1], body)) {
+      fprintf(stderr, "cannot read %s\n", argv[1]);
+      return 1;
+    }
+    ParseResult result = parse(body);
+    printf("%s: %zu bytes, %d updates, last update_id %ld\n",
+           argv[1], body.size(), result.updates, result.lastUpdateId);
+    return 0;
+  }
+
+  printf("parser fixed buffers: %zu bytes\n", parserBytes);
+  printf("%8s %10s %8s %10s %9s\n", "updates", "body B", "allocs", "us/update", "MB/s");
+  static const int sizes[] = { 1, 10, 100 };
+  for (int count : sizes) {
+    std::string body = buildPayload(count);
+
+    allocations = 0;
+    counting = true;
+    ParseResult result = parse(body);
+    counting = false;
+    CHECK(result.updates == count);
+    CHECK(result.textMatches == count);
+    CHECK(result.lastUpdateId == 734520000 + count - 1);
+    CHECK(UpdateParser::getUpdateCount() == count);
+    CHECK(allocations == 0);
+
+    double start = hostSeconds();
+    for (int i = 0; i < BENCH_ROUNDS; i++) parse(body);
+    double elapsed = (hostSeconds() - start) / BENCH_ROUNDS;
+    printf("%8d %10zu %8lu %10.2f %9.1f\n", count, body.size(), allocations,
+           elapsed * 1e6 / count, body.size() / elapsed / 1e6);
+  }
+
+  // body terpotong (koneksi putus) tidak menghasilkan update setengah jadi
+  std::string body = buildPayload(3);
+  body.resize(body.size() - 40);
+  CHECK(parse(body).updates == 2);
+  return testEnd("parserBench");
+}
@@ -0,0 +1,110 @@
+// RecordStore di LittleFS simulator (file host di build/testfs): write
+// amplification untuk pola tulis firmware (totals tiap feed, jadwal sesekali
+// berubah, save ulang tanpa perubahan), dibandingkan menulis ulang seluruh
+// state ke satu file tiap perubahan. Juga replay saat boot: nilai terakhir
+// kembali, record terakhir yang terpotong (daya putus) dibuang.
+#include "hostTest.h"
+#include "recordStore.h"
+#include "dataLogger.h"
+#include "timeManager.h"
+#include <unistd.h>
+
+#define BENCH_DAYS 365
+#define FEEDS_PER_DAY 2
+#define STORE_PATH TEST_FS_ROOT STORE_FILE
+
+static TotalsRecord totals;
+static ScheduleRecord schedules;
+
+static void writeTotals(int feed) {
+  memset(&totals, 0, sizeof(totals));
+  totals.totalFeeds = feed;
+  snprintf(totals.lastFeedTime, sizeof(totals.lastFeedTime), "%02d:%02d", 8 + feed % 2 * 10, feed % 60);
+  CHECK(RecordStore::write(RECORD_TOTALS, &totals, sizeof(totals)));
+}
+
+static void writeSchedules(int day) {
+  memset(&schedules, 0, sizeof(schedules));
+  schedules.count = 2;
+  schedules.schedules[0].minute = 8 * 60;
+  schedules.schedules[1].minute = 18 * 60 + day / 7 % 30;
+  for (uint32_t i = 0; i < schedules.count; i++) {
+    schedules.schedules[i].enabled = true;
+    schedules.schedules[i].lastExecuted = TEST_START_EPOCH + day * 86400UL;
+  }
+  CHECK(RecordStore::write(RECORD_SCHEDULES, &schedules, sizeof(schedules)));
+}
+
+  // reboot: cache dikosongkan lalu dibangun ulang dari log
+static void checkReplay(int expectedFeeds) {
+  double start = hostSeconds();
+  CHECK(RecordStore::init());
+  double elapsed = hostSeconds() - start;
+  TotalsRecord loaded;
+  CHECK(RecordStore::read(RECORD_TOTALS, &loaded, sizeof(loaded)));
+  CHECK(loaded.totalFeeds == expectedFeeds);
+  ScheduleRecord loadedSchedules;
+  CHECK(RecordStore::read(RECORD_SCHEDULES, &loadedSchedules, sizeof(loadedSchedules)));
+  CHECK(memcmp(&loadedSchedules, &schedules, sizeof(schedules)) == 0);
+  printf("replay %u byte log: %.1f us (host)\n", (unsigned)RecordStore::getLogSize(), elapsed * 1e6);
+}
+
+int main() {
+  testBegin();
+  CHECK(RecordStore::init());
+
+  // setahun: 2 feed per hari, jadwal disimpan tiap hari (berubah seminggu
+  // sekali, sisanya sama dan dilewati store)
+  unsigned long payloadBytes = 0, changes = 0;
+  int feed = 0;
+  for (int day = 0; day < BENCH_DAYS; day++) {
+    for (int i = 0; i < FEEDS_PER_DAY; i++) {
+      writeTotals(++feed);
+      payloadBytes += sizeof(TotalsRecord);
+      changes++;
+    }
+    bool changed = day % 7 == 0;
+    writeSchedules(day - day % 7);
+    if (changed) {
+      payloadBytes += sizeof(ScheduleRecord);
+      changes++;
+    }
+  }
+
+  // seluruh state ke satu file setiap ada perubahan (pola saveToFile lama)
+  float rewriteAll = (float)changes * (sizeof(TotalsRecord) + sizeof(ScheduleRecord)) / payloadBytes;
+  float amplification = RecordStore::getWriteAmplification();
+  printf("%d days: %lu records written, %lu unchanged skipped, %lu compactions\n", BENCH_DAYS,
+         RecordStore::getRecordsWritten(), RecordStore::getRecordsSkipped(),
+         RecordStore::getCompactionCount());
+  printf("write amplification: record store %.2f, rewrite whole state %.2f\n", amplification, rewriteAll);
+
+  CHECK(RecordStore::getRecordsSkipped() == BENCH_DAYS - (BENCH_DAYS + 6) / 7);
+  CHECK(RecordStore::getCompactionCount() > 0);
+  CHECK(RecordStore::getLogSize() <= STORE_MAX_SIZE);
+  // header 8 byte per record + salinan saat compaction
+  CHECK(amplification > 1.0 && amplification < 1.5);
+  CHECK(amplification < rewriteAll);
+
+  checkReplay(feed);
+
+  // daya putus di tengah append: record terakhir setengah tertulis
+  size_t goodSize = RecordStore::getLogSize();
+  writeTotals(feed + 1);
+  CHECK(truncate(STORE_PATH, goodSize + sizeof(RecordHeader) + 5) == 0);
+  checkReplay(feed);
+  // sisa rusak dibuang dengan menulis ulang log bersih (compaction)
+  CHECK(RecordStore::getLogSize() == 2 * sizeof(RecordHeader) + sizeof(TotalsRecord) + sizeof(ScheduleRecord));
+
+  // CRC: satu byte payload rusak = record diabaikan, record sebelumnya berlaku
+  writeTotals(feed + 2);
+  FILE* file = fopen(STORE_PATH, "r+b");
+  CHECK(file != NULL);
+  if (file) {
+    fseek(file, -4, SEEK_END);
+    fputc(0x5A, file);
+    fclose(file);
+  }
+  checkReplay(feed);
+  return testEnd("recordStoreBench");
+}
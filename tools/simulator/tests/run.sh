@@ -0,0 +1,44 @@
+#!/bin/sh
+# Tes & benchmark host modul firmware, dibangun di atas shim simulator
+# (../include, ../sim*.cpp) dengan -DNIBBLO_SIM seperti nibbloSim.
+#
+#   cd tools/simulator/tests
+#   ./run.sh                    # bangun & jalankan semua *Test.cpp dan *Bench.cpp
+#   ./run.sh schedulerTest      # satu program saja
+#
+# Exit != 0 jika ada program yang gagal. Hasil build di build/.
+set -e
+cd "$(dirname "$0")"
+
+CXX=${CXX:-g++}
+FLAGS="-std=gnu++17 -O2 -Wall -Wextra -DNIBBLO_SIM -I. -I../include -I../../../mainNibblo"
+mkdir -p build/obj
+
+# firmware + shim dikompilasi sekali untuk semua program (tanpa main.cpp & sketch.cpp)
+for source in ../simulator.cpp ../simArduino.cpp ../simFs.cpp ../simNetwork.cpp ../soak.cpp \
+              ../../../mainNibblo/*.cpp; do
+  $CXX $FLAGS -c "$source" -o "build/obj/$(basename "$source" .cpp).o"
+done
+
+# dekoder ekspor untuk round trip lzssTest
+$CXX -std=gnu++17 -O2 -Wall -Wextra ../../exportDecoder/exportDecoder.cpp -o build/exportDecoder
+
+if [ $# -gt 0 ]; then
+  programs="$*"
+else
+  programs=$(ls *Test.cpp *Bench.cpp 2>/dev/null | sed 's/\.cpp$//')
+fi
+
+failed=""
+for program in $programs; do
+  $CXX $FLAGS "$program.cpp" build/obj/*.o -o "build/$program"
+  if ! (cd build && "./$program"); then
+    failed="$failed $program"
+  fi
+done
+
+if [ -n "$failed" ]; then
+  echo "failed:$failed" >&2
+  exit 1
+fi
+echo "all passed" >&2
\ No newline at end of file
@@ -0,0 +1,102 @@
+// Scheduler: urutan prioritas, period tanpa drift, deadline/overrun,
+// rescheduleCurrent(), eksekusi yang tertinggal dilewati, dan loop hanya
+// bangun saat ada task jatuh tempo.
+#include "hostTest.h"
+#include "scheduler.h"
+
+#define FAST_PERIOD 100
+#define MEDIUM_PERIOD 250
+#define SLOW_PERIOD 1000
+#define SLOW_BUSY_MS 20
+#define RETRY_DELAY 30
+#define RUN_MS 10000
+
+static char order[8];
+static int orderCount = 0;
+static unsigned long retryRuns[5];
+static int retryCount = 0;
+
+static void note(char name) {
+  if (orderCount < (int)sizeof(order)) order[orderCount++] = name;
+}
+
+static void fastTask() { note('F'); }
+static void mediumTask() { note('M'); }
+
+static void slowTask() {
+  note('S');
+  delayMicroseconds(SLOW_BUSY_MS * 1000);  // CPU sibuk, bukan delay()
+}
+
+  // tiga jalan pertama minta diulang RETRY_DELAY ms kemudian (seperti telegramTask)
+static void retryTask() {
+  if (retryCount < 5) retryRuns[retryCount] = millis();
+  if (++retryCount <= 3) Scheduler::rescheduleCurrent(RETRY_DELAY);
+}
+
+int main() {
+  testBegin();
+
+  // urutan daftar sengaja terbalik dari prioritas
+  int slow = Scheduler::addTask("slow", slowTask, SLOW_PERIOD, 10, 2);
+  int medium = Scheduler::addTask("medium", mediumTask, MEDIUM_PERIOD, 50, 1);
+  int fast = Scheduler::addTask("fast", fastTask, FAST_PERIOD, 50, 0);
+  Scheduler::addTask("retry", retryTask, 5000, 1000, 3);
+  CHECK(Scheduler::getTaskCount() == 4);
+  unsigned long start = Scheduler::getTask(fast).nextRun;
+
+  // semua jatuh tempo sekaligus: satu run() menjalankan semuanya, urut prioritas
+  Scheduler::run();
+  CHECK(orderCount == 3);
+  CHECK(order[0] == 'F' && order[1] == 'M' && order[2] == 'S');
+  CHECK(retryCount == 1);
+
+  while (millis() - start < RUN_MS) {
+    Scheduler::sleepUntilNextTask();
+    Scheduler::run();
+  }
+
+  const SchedulerTask& fastStats = Scheduler::getTask(fast);
+  const SchedulerTask& mediumStats = Scheduler::getTask(medium);
+  const SchedulerTask& slowStats = Scheduler::getTask(slow);
+  CHECK_NEAR(fastStats.runCount, RUN_MS / FAST_PERIOD + 1, 1);
+  CHECK_NEAR(mediumStats.runCount, RUN_MS / MEDIUM_PERIOD + 1, 1);
+  CHECK_NEAR(slowStats.runCount, RUN_MS / SLOW_PERIOD + 1, 1);
+
+  // jadwal relatif ke jatuh tempo: tetap di grid walau task lain makan 20 ms
+  CHECK((fastStats.nextRun - start) % FAST_PERIOD == 0);
+  CHECK((mediumStats.nextRun - start) % MEDIUM_PERIOD == 0);
+  CHECK((slowStats.nextRun - start) % SLOW_PERIOD == 0);
+
+  // runtime & deadline: task lambat selalu lewat deadline 10 ms, task cepat
+  // jalan lebih dulu sehingga tidak pernah tertunda
+  CHECK(slowStats.worstRuntime >= SLOW_BUSY_MS);
+  CHECK(slowStats.overrunCount == slowStats.runCount);
+  CHECK(fastStats.overrunCount == 0);
+  CHECK(mediumStats.overrunCount == 0);
+
+  // rescheduleCurrent() hanya mengganti jadwal berikutnya, lalu kembali ke period
+  CHECK(retryCount == 3 + RUN_MS / 5000);
+  for (int i = 1; i <= 3; i++) CHECK_NEAR(retryRuns[i] - retryRuns[i - 1], RETRY_DELAY, 1);
+  CHECK_NEAR(retryRuns[4] - retryRuns[3], 5000, 1);
+
+  // satu bangun per waktu jatuh tempo yang berbeda (grid 100 ms + 250 ms
+  // yang tidak jatuh di kelipatan 100), bukan tiap 50 ms seperti loop lama
+  unsigned long distinctDue = RUN_MS / FAST_PERIOD + RUN_MS / (2 * MEDIUM_PERIOD);
+  CHECK(Scheduler::getWakeCount() <= distinctDue + 6);
+  CHECK(Scheduler::getWakeCount() < RUN_MS / 50 / 1.5);
+
+  // tertinggal 1 s (mis. handshake TLS): task cepat jalan sekali, bukan
+  // mengejar 10 eksekusi yang hilang, lalu lanjut dari waktu selesai
+  unsigned long runsBefore = fastStats.runCount;
+  delayMicroseconds(1000000);
+  orderCount = 0;
+  Scheduler::run();
+  CHECK(fastStats.runCount == runsBefore + 1);
+  CHECK((long)(fastStats.nextRun - millis()) > FAST_PERIOD / 2);
+  CHECK(Scheduler::timeUntilNextTask() > 0);
+  CHECK(Scheduler::timeUntilNextTask() <= MAX_IDLE_SLEEP);
+
+  if (getenv("NIBBLO_TEST_VERBOSE")) Scheduler::printStats();
+  return testEnd("schedulerTest");
+}
@@ -0,0 +1,182 @@
+// TelegramClient terhadap server Bot API palsu di simNetwork.cpp: GET/POST
+// lewat state machine, keep-alive dipakai ulang, body sink yang menjeda,
+// timeout, koneksi putus, dan tiap step() tetap dalam TELEGRAM_STEP_BUDGET
+// (kecuali step connect: handshake BearSSL memang satu blok).
+#include "hostTest.h"
+#include "telegramClient.h"
+#include "credential.h"
+#include <string>
+
+#define BOT_PATH "/bot" BOT_TOKEN
+#define RUN_LIMIT_MS 60000
+#define REUSED_REQUEST_MAX_MS 250    // latensi HTTP palsu 120 ms + jeda step, tanpa handshake
+
+struct RunResult {
+  bool done;
+  unsigned long elapsedMs;
+  unsigned long worstStepMs;      // step selain connect
+  unsigned long steps;
+};
+
+static std::string body;
+static size_t pauseEvery = 0;
+
+static bool collectBody(char c) {
+  body += c;
+  return pauseEvery == 0 || body.size() % pauseEvery != 0;
+}
+
+static void connectWifi() {
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  while (WiFi.status() != WL_CONNECTED) delay(100);
+}
+
+  // seperti TelegramHandler: step tiap TELEGRAM_STEP_INTERVAL sampai selesai
+static RunResult run() {
+  RunResult result = {};
+  unsigned long start = millis();
+  while (millis() - start < RUN_LIMIT_MS) {
+    bool connecting = TelegramClient::getState() == TELEGRAM_CONNECTING;
+    unsigned long stepStart = millis();
+    TelegramClient::step();
+    unsigned long stepMs = millis() - stepStart;
+    result.steps++;
+    if (!connecting && stepMs > result.worstStepMs) result.worstStepMs = stepMs;
+    if (TelegramClient::isDone() || TelegramClient::hasError()) break;
+    if (pauseEvery) TelegramClient::resumeBody();
+    delay(TELEGRAM_STEP_INTERVAL);
+  }
+  result.done = TelegramClient::isDone();
+  result.elapsedMs = millis() - start;
+  TelegramClient::finish();
+  return result;
+}
+
+static void testGet() {
+  Sim::addTelegramCommand(Sim::now(), "/status");
+  body.clear();
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getUpdates?offset=0&limit=2&timeout=0", collectBody));
+  CHECK(!TelegramClient::beginGet(BOT_PATH "/getUpdates", collectBody));  // satu request sekaligus
+  RunResult result = run();
+
+  CHECK(result.done);
+  CHECK(TelegramClient::getStatusCode() == 200);
+  CHECK(body.find("\"update_id\":1000") != std::string::npos);
+  CHECK(body.find("\"text\":\"/status\"") != std::string::npos);
+  CHECK(TelegramClient::getHandshakeCount() == 1);
+  CHECK(result.worstStepMs <= TELEGRAM_STEP_BUDGET);
+  CHECK(TelegramClient::isIdle());
+}
+
+  // request kedua lewat koneksi yang sama: tanpa handshake
+static void testPostReuse() {
+  static const char payload[] = "{\"chat_id\":\"" CHAT_ID "\",\"text\":\"hello\"}";
+  unsigned long handshakes = TelegramClient::getHandshakeCount();
+  unsigned messages = Sim::shared->messageCount;
+  CHECK(TelegramClient::beginPost(BOT_PATH "/sendMessage", payload, strlen(payload)));
+  RunResult result = run();
+
+  CHECK(result.done);
+  CHECK(TelegramClient::getStatusCode() == 200);
+  CHECK(Sim::shared->messageCount == messages + 1);
+  CHECK(TelegramClient::getHandshakeCount() == handshakes);
+  CHECK(TelegramClient::getReuseCount() == 1);
+  CHECK(result.worstStepMs <= TELEGRAM_STEP_BUDGET);
+  CHECK(result.elapsedMs < REUSED_REQUEST_MAX_MS);
+}
+
+  // status selain 200 tetap DONE, pemanggil yang memeriksa status code
+static void testNotFound() {
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getMe", NULL));
+  RunResult result = run();
+  CHECK(result.done);
+  CHECK(TelegramClient::getStatusCode() == 404);
+}
+
+  // sink yang menolak byte menjeda pembacaan sampai resumeBody()
+static void testPausedSink() {
+  Sim::addTelegramCommand(Sim::now(), "/food");
+  body.clear();
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getUpdates?offset=1001&limit=2&timeout=0", collectBody));
+  pauseEvery = 16;
+  RunResult result = run();
+  pauseEvery = 0;
+
+  CHECK(result.done);
+  CHECK(body.find("\"text\":\"/food\"") != std::string::npos);
+  CHECK(body.size() > 100 && body[body.size() - 1] == '}');
+  CHECK(result.steps >= body.size() / 16);   // satu potongan per step
+}
+
+  // long poll ditahan server lebih lama dari batas klien: error "timeout",
+  // step selama menunggu tidak memblokir
+static void testTimeout() {
+  unsigned long handshakes = TelegramClient::getHandshakeCount();
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getUpdates?offset=1002&limit=2&timeout=25", collectBody, 2000));
+  RunResult result = run();
+
+  CHECK(TelegramClient::getStatusCode() == 0);
+  CHECK(!result.done);
+  CHECK_NEAR(result.elapsedMs, 2000, 2 * TELEGRAM_STEP_INTERVAL);
+  CHECK(result.worstStepMs <= 1);
+
+  // koneksi ditutup setelah error: request berikutnya handshake lagi
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getMe", NULL));
+  CHECK(run().done);
+  CHECK(TelegramClient::getHandshakeCount() == handshakes + 1);
+}
+
+  // koneksi idle melewati TELEGRAM_KEEPALIVE_TIMEOUT tidak dipakai ulang
+static void testKeepAliveExpiry() {
+  unsigned long handshakes = TelegramClient::getHandshakeCount();
+  unsigned long reuses = TelegramClient::getReuseCount();
+  delay(TELEGRAM_KEEPALIVE_TIMEOUT - 5000);
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getMe", NULL));
+  CHECK(run().done);
+  CHECK(TelegramClient::getReuseCount() == reuses + 1);
+
+  delay(TELEGRAM_KEEPALIVE_TIMEOUT + 1000);
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getMe", NULL));
+  CHECK(run().done);
+  CHECK(TelegramClient::getHandshakeCount() == handshakes + 1);
+}
+
+  // WiFi putus saat menunggu respons: error, bukan menunggu sampai timeout
+static void testWifiLost() {
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getUpdates?offset=1002&limit=2&timeout=25", collectBody, 30000));
+  for (int i = 0; i < 5; i++) {
+    TelegramClient::step();
+    delay(TELEGRAM_STEP_INTERVAL);
+  }
+  CHECK(TelegramClient::isWaiting());
+  WiFi.disconnect();
+  RunResult result = run();
+  CHECK(!result.done);
+  CHECK(result.elapsedMs <= TELEGRAM_STEP_INTERVAL);
+
+  // tanpa WiFi connect langsung gagal
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getMe", NULL));
+  CHECK(!run().done);
+
+  connectWifi();
+  CHECK(TelegramClient::beginGet(BOT_PATH "/getMe", NULL));
+  CHECK(run().done);
+}
+
+int main() {
+  testBegin();
+  connectWifi();
+  TelegramClient::init();
+  CHECK(TelegramClient::getMflnState() == MFLN_SUPPORTED);
+
+  testGet();
+  testPostReuse();
+  testNotFound();
+  testPausedSink();
+  testTimeout();
+  testKeepAliveExpiry();
+  testWifiLost();
+  CHECK(TelegramClient::getAverageLatency() > 0);
+  return testEnd("telegramClientTest");
+}
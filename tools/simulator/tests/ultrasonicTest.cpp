@@ -0,0 +1,117 @@
+// UltrasonicSensor: state machine ping/echo dengan timestamp buatan, lalu
+// lewat pin echo simulasi (halSim: tepi echo = timer virtual yang memanggil
+// ISR) seperti di firmware. Trigger tidak boleh menunggu echo.
+#include "hostTest.h"
+#include "ultrasonicSensor.h"
+#include "hal.h"
+
+#define SOUND_CM_PER_US 0.0343
+
+static UltrasonicSensor foodSensor;
+
+static void foodEchoISR() {
+  foodSensor.onEchoEdge(Hal::readPin(ECHO_FOOD_PIN), micros());
+}
+
+static unsigned long echoWidth(float cm) {
+  return (unsigned long)(cm * 2 / SOUND_CM_PER_US + 0.5);
+}
+
+static void testStateMachine() {
+  UltrasonicSensor sensor;
+  CHECK(!sensor.isBusy());
+  CHECK(!sensor.poll(1000));
+
+  // echo normal: jarak dari lebar pulsa, hasil diambil di poll berikutnya
+  sensor.trigger(1000);
+  CHECK(sensor.isBusy());
+  CHECK(!sensor.poll(1200));
+  sensor.onEchoEdge(true, 1450);
+  CHECK(!sensor.poll(1500));
+  sensor.onEchoEdge(false, 1450 + echoWidth(10.0));
+  CHECK(sensor.poll(3000));
+  CHECK(!sensor.isBusy());
+  CHECK_NEAR(sensor.getDistanceCM(), 10.0, 0.02);
+  CHECK(sensor.getLastLatency() == 2000);
+  CHECK(!sensor.poll(3100));  // hasil hanya diambil sekali
+
+  // tepi turun tanpa tepi naik (noise saat trigger) dan tepi saat idle diabaikan
+  sensor.onEchoEdge(false, 3200);
+  CHECK(!sensor.isBusy());
+  sensor.trigger(5000);
+  sensor.onEchoEdge(false, 5100);
+  CHECK(!sensor.poll(5200));
+  sensor.onEchoEdge(true, 5400);
+  sensor.onEchoEdge(false, 5400 + echoWidth(25.0));
+  CHECK(sensor.poll(8000));
+  CHECK_NEAR(sensor.getDistanceCM(), 25.0, 0.02);
+
+  // tidak ada echo: timeout tepat di ULTRASONIC_TIMEOUT_US, jarak 0
+  sensor.trigger(10000);
+  CHECK(!sensor.poll(10000 + ULTRASONIC_TIMEOUT_US - 1));
+  CHECK(sensor.poll(10000 + ULTRASONIC_TIMEOUT_US));
+  CHECK(sensor.getDistanceCM() == 0);
+  CHECK(sensor.getPingCount() == 3);
+  CHECK(sensor.getTimeoutCount() == 1);
+  CHECK_NEAR(sensor.getTimeoutRate(), 100.0 / 3, 0.01);
+  CHECK(sensor.getWorstLatency() == ULTRASONIC_TIMEOUT_US);
+  CHECK(sensor.getAverageLatency() == (2000 + 3000 + ULTRASONIC_TIMEOUT_US) / 3);
+
+  // wrap micros() (~71 menit di ESP8266): selisih unsigned tetap benar
+  unsigned long nearWrap = (unsigned long)-500;
+  sensor.trigger(nearWrap);
+  sensor.onEchoEdge(true, nearWrap + 450);
+  sensor.onEchoEdge(false, nearWrap + 450 + echoWidth(40.0));
+  CHECK(sensor.poll(nearWrap + 5000));
+  CHECK_NEAR(sensor.getDistanceCM(), 40.0, 0.02);
+}
+
+  // poll seperti sensorTask: tiap ULTRASONIC_POLL_INTERVAL sampai ada hasil
+static bool measure(float& distance, unsigned long& blockedUs) {
+  unsigned long start = micros();
+  foodSensor.trigger();
+  blockedUs = micros() - start;
+  for (int i = 0; i < 3; i++) {
+    delay(ULTRASONIC_POLL_INTERVAL);
+    if (foodSensor.poll()) {
+      distance = foodSensor.getDistanceCM();
+      return true;
+    }
+  }
+  return false;
+}
+
+static void testSimulatedPin() {
+  // trace: 12.5 cm sampai detik 10, lalu echo hilang (sensor tertutup/miring)
+  Sim::addTraceSample({ 0, 12.5f, 3.0f, 7.8f });
+  Sim::addTraceSample({ 10, 12.5f, 3.0f, 7.8f });
+  Sim::addTraceSample({ 11, 0.0f, 3.0f, 7.8f });
+  Sim::addTraceSample({ 100, 0.0f, 3.0f, 7.8f });
+  foodSensor.begin(TRIG_FOOD_PIN, ECHO_FOOD_PIN, foodEchoISR);
+
+  float distance = -1;
+  unsigned long blockedUs = 0;
+  for (int i = 0; i < 20; i++) {
+    CHECK(measure(distance, blockedUs));
+    CHECK_NEAR(distance, 12.5, 0.05);
+    CHECK(blockedUs < 100);  // hanya pulsa trigger 10 us, bukan pulseIn()
+  }
+  CHECK(foodSensor.getTimeoutCount() == 0);
+  CHECK(foodSensor.getWorstLatency() <= ULTRASONIC_POLL_INTERVAL * 1000UL + 100);
+
+  delay(15000);
+  for (int i = 0; i < 5; i++) {
+    CHECK(measure(distance, blockedUs));
+    CHECK(distance == 0);
+  }
+  CHECK(foodSensor.getPingCount() == 25);
+  CHECK(foodSensor.getTimeoutCount() == 5);
+  CHECK_NEAR(foodSensor.getTimeoutRate(), 20.0, 0.01);
+}
+
+int main() {
+  testBegin();
+  testStateMachine();
+  testSimulatedPin();
+  return testEnd("ultrasonicTest");
+}